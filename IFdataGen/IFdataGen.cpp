@@ -6,7 +6,9 @@
 #include <chrono>
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <ctime>
+#include <thread>
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -18,6 +20,18 @@
 #define TOTAL_GAL_SAT 36
 #define TOTAL_GLO_SAT 24
 #define TOTAL_SAT_CHANNEL 128
+#define SAMPLE_TYPE_MAX_SNR_LOSS 0.01	// maximum SNR loss in dB of float/int16 sample type against double
+#define QUANT_BENCHMARK_SAMPLES 10000	// samples in one benchmark block (1ms at 10MHz)
+#define QUANT_BENCHMARK_BLOCKS 1000	// number of blocks quantized by each benchmark case
+#define LDPC_VERIFY_VECTORS 1000	// random information vectors encoded by each LDPC benchmark case
+#define LDPC_VERIFY_ROUNDS 10		// number of times all random vectors encoded to measure encode time
+#define LDPC_VERIFY_FRAMES 20		// frames of each svid compared between table and reference LDPC encoder
+#define EPH_VERIFY_EPOCHS 3600		// number of epochs (1s interval centered at start time) to verify batch ephemeris evaluation
+#define EPH_VERIFY_TOLERANCE 1e-6	// maximum position difference in meter between batch and scalar evaluation
+#define ORBIT_VERIFY_TOLERANCE 1e-3	// maximum range difference in meter between orbit interpolation and exact evaluation
+#define PIPELINE_DEPTH 4	// number of ms satellite parameter computed ahead / IF blocks waiting for quantization
+#define IF_TILE_SAMPLES 1024	// samples of one parallel generation tile (multiple of SIMD width)
+#define EPH_SWITCH_NEVER 0x7fffffffffffffffLL	// ephemeris switch time when no ephemeris switch ahead
 
 typedef enum {
     DataBitLNav, DataBitCNav, DataBitCNav2, // for GPS
@@ -34,16 +48,52 @@ struct CommandArguments
 	bool MultiThread;
 	bool ValidateOnly;
 	bool OutputTag;
+	bool PrecisionCheck;
+	int SampleType;	// -1 to use sample type in JSON config
+	long long NoiseSeed;	// -1 to use noise seed in JSON config
+	bool QuantBenchmark;
+	bool DirectIo;
+	int BlockLength;	// -1 to use block length in JSON config
+	bool VerifyPrn;
+	bool VerifyEph;
+	int OrbitInterpWindow;	// -1 to use orbit interpolation window in JSON config
+	bool VerifyInterp;
+	bool VerifyLdpc;
 };
 
-void UpdateSatParamList(GNSS_TIME CurTime, KINEMATIC_INFO CurPos, int ListCount, PSIGNAL_POWER PowerList, PIONO_PARAM IonoParam);
-int StepToNextMs();
-complex_number GenerateNoise(double Sigma);
+typedef struct
+{
+	GNSS_TIME Time;
+	SATELLITE_PARAM GpsSatParam[TOTAL_GPS_SAT], BdsSatParam[TOTAL_BDS_SAT], GalSatParam[TOTAL_GAL_SAT], GloSatParam[TOTAL_GLO_SAT];
+	unsigned long long VisibleMask[4];	// bit (svid-1) set if satellite visible at Time, indexed by GnssSystem
+	unsigned long long ParamMask[4];	// satellites with parameter calculated, visible at Time or at previous update
+} SAT_PARAM_SET, *PSAT_PARAM_SET;
+
+void UpdateSatParamList(GNSS_TIME CurTime, KINEMATIC_INFO CurPos, int ListCount, PSIGNAL_POWER PowerList, PIONO_PARAM IonoParam, PSAT_PARAM_SET ParamSet);
+void UpdateVisibleList(GNSS_TIME CurTime, KINEMATIC_INFO CurPos, PSAT_PARAM_SET ParamSet);
+int GetParamList(GNSS_TIME CurTime, KINEMATIC_INFO CurPos, GnssSystem System, PGPS_EPHEMERIS Eph[], int Number, SAT_VISIBILITY Visibility[], PSAT_PARAM_SET ParamSet, PGPS_EPHEMERIS EphList[]);
+int UpdateChannelList(CChannelPool *ChannelPool, CSatIfSignal *SatIfSignal[], int ChannelNumber, unsigned long long ChannelMask[], NavBit *NavBitArray[]);
+int AddSatelliteChannel(CChannelPool *ChannelPool, CSatIfSignal *SatIfSignal[], int ChannelNumber, GnssSystem System, int Index, NavBit *NavBitArray[]);
+int StepToNextBlock();
+void UpdateEphemeris(GNSS_TIME Time, bool Running);
+int UpdateSystemEphemeris(GnssSystem System, GNSS_TIME Time, GLONASS_TIME GlonassTime, long long SwitchTime, PGPS_EPHEMERIS Eph[], SAT_VISIBILITY Visibility[], int Number);
+void CopySatParam(PSAT_PARAM_SET Dest, const SAT_PARAM_SET *Src);
+void CopyParamArray(unsigned long long Mask, SATELLITE_PARAM Dest[], const SATELLITE_PARAM Src[], int Number);
+void ParameterStage(CPipelineQueue *ParamQueue, SAT_PARAM_SET ParamSlot[]);
+void QuantizeStage(CPipelineQueue *BlockQueue, void *BlockBuffer[], CQuantizer *Quantizer, CIfFileWriter *IfWriter);
+void QuantizeIfBlock(void *Samples, CQuantizer *Quantizer, CIfFileWriter *IfWriter);
+template <typename T> void GenerateIfBlock(T *Samples, int ThreadNumber, CSatIfSignal *SatIfSignal[], int ChannelNumber, int MsSampleNumber, int BlockLength, unsigned long long MsIndex);
+void CheckSampleTypePrecision(IfSampleType SampleType, CSatIfSignal *SatIfSignal[], int ChannelNumber, int SampleNumber);
+void CreateNoiseBuffer(IfSampleType SampleType, int BufferSize, int SampleNumber);
+void QuantizerBenchmark(int SampleNumber);
+template <typename T> void QuantizerBenchmark(const char *TypeName, int SampleNumber, int BlockNumber);
+bool VerifyLDPCEncode();
+bool VerifyLDPCEncode(const char *NavName, BCNavBit *Nav, int FrameLength);
+bool VerifyLDPCEncode(const char *NavName, CNav2Bit *Nav);
+bool VerifyEphemerisBatch(const char *SystemName, GnssSystem System, PGPS_EPHEMERIS Eph[], int Number, double Time);
+bool VerifyOrbitInterp(GNSS_TIME CurTime, KINEMATIC_INFO CurPos, PIONO_PARAM IonoParam, int DurationMs);
+void CompareSatParam(int SatNumber, PGPS_EPHEMERIS EphVisible[], SATELLITE_PARAM ExactParam[], SATELLITE_PARAM InterpParam[], double MaxDiff[3]);
 NavBit* GetNavData(GnssSystem SatSystem, int SatSignalIndex, NavBit* NavBitArray[]);
-int QuantSamplesIQ2(complex_number Samples[], int Length, unsigned char QuantSamples[], double GainScale);	//TODO: Varify 2-bit quantization
-int QuantSamplesIQ4(complex_number Samples[], int Length, unsigned char QuantSamples[], double GainScale);
-int QuantSamplesIQ8(complex_number Samples[], int Length, unsigned char QuantSamples[], double GainScale);
-int QuantSamplesIQ16(complex_number Samples[], int Length, unsigned char QuantSamples[], double GainScale);
 
 void ShowHelp(const char* ProgramName);
 bool ParseCommandLineArgs(int argc, char* argv[], CommandArguments &Arguments);
@@ -54,12 +104,22 @@ CPowerControl PowerControl;
 CNavData NavData;
 OUTPUT_PARAM OutputParam;
 GNSS_TIME CurTime;
+CNoiseGenerator NoiseGenerator;
 PGPS_EPHEMERIS GpsEph[TOTAL_GPS_SAT], GpsEphVisible[TOTAL_GPS_SAT];
 PGPS_EPHEMERIS BdsEph[TOTAL_BDS_SAT], BdsEphVisible[TOTAL_BDS_SAT];
 PGPS_EPHEMERIS GalEph[TOTAL_GAL_SAT], GalEphVisible[TOTAL_GAL_SAT];
+ORBIT_INTERP GpsOrbitInterp[TOTAL_GPS_SAT], BdsOrbitInterp[TOTAL_BDS_SAT], GalOrbitInterp[TOTAL_GAL_SAT];	// only accessed by UpdateSatParamList()
+GLONASS_ORBIT GloOrbit[TOTAL_GLO_SAT];	// only accessed by UpdateSatParamList()
+SAT_VISIBILITY GpsVisibility[TOTAL_GPS_SAT], BdsVisibility[TOTAL_BDS_SAT], GalVisibility[TOTAL_GAL_SAT], GloVisibility[TOTAL_GLO_SAT];	// only accessed by UpdateSatParamList()
 PGLONASS_EPHEMERIS GloEph[TOTAL_GLO_SAT], GloEphVisible[TOTAL_GLO_SAT];
-SATELLITE_PARAM GpsSatParam[TOTAL_GPS_SAT], BdsSatParam[TOTAL_BDS_SAT], GalSatParam[TOTAL_GAL_SAT], GloSatParam[TOTAL_GLO_SAT];	// satellite parameter array at CurTime
-int GpsSatNumber, BdsSatNumber, GalSatNumber, GloSatNumber;	// number of visible satellite
+CNavBitComposer NavBitComposer;	// ephemeris/almanac to navigation bit instances, queued by UpdateEphemeris() and composed by synthesis once signals start
+long long EphSwitchTime;	// receiver time of next ephemeris switch in millisecond since GPS epoch
+int EphSwitchCount;		// number of satellites switched to new ephemeris after start, only accessed by synthesis
+SAT_PARAM_SET SatParam;	// satellite parameter at CurTime used by channels
+SAT_PARAM_SET NextSatParam;	// satellite parameter updated by StepToNextBlock(), ahead of SatParam if pipelined
+int GpsSatNumber, BdsSatNumber, GalSatNumber, GloSatNumber;	// number of satellites in parameter list (visible or just set)
+int ChannelAddCount, ChannelRetireCount;	// number of satellites added to/removed from channel list after start
+const int SignalLastIndex[] = { SIGNAL_INDEX_L5, SIGNAL_INDEX_B2b, SIGNAL_INDEX_E6, SIGNAL_INDEX_G2 };	// last signal index generated of each system
 const int SignalCenterFreq[][8] = {
 	{ FREQ_GPS_L1, FREQ_GPS_L1, FREQ_GPS_L2, FREQ_GPS_L2, FREQ_GPS_L5 },
 	{ FREQ_BDS_B1C, FREQ_BDS_B1I, FREQ_BDS_B2I, FREQ_BDS_B3I, FREQ_BDS_B2a, FREQ_BDS_B2b, FREQ_BDS_B2ab },
@@ -75,7 +135,7 @@ const char *SignalName[][8] = {
 
 int main(int argc, char* argv[])
 {
-	int i, j;
+	int i;
 	JsonStream JsonTree;
 	JsonObject *Object;
 	UTC_TIME UtcTime;
@@ -89,11 +149,20 @@ int main(int argc, char* argv[])
 	PSIGNAL_POWER PowerList;
 	int FreqLow, FreqHigh;
 	CSatIfSignal* SatIfSignal[TOTAL_SAT_CHANNEL];
+	CChannelPool ChannelPool;
+	unsigned long long ChannelMask[4];	// satellites having channels, indexed by GnssSystem
 	int TotalChannelNumber, SignalIndex;
 	int IfFreq, FdmaOffset;
-	complex_number *NoiseArray;
-	unsigned char *QuantArray;
-	FILE* IfFile = NULL;
+	int SampleSize, QuantLength, BlockSampleNumber;
+	int ThreadNumber;
+	CQuantizer Quantizer;
+	CIfFileWriter IfWriter;
+	bool Pipelined;
+	void *BlockBuffer[PIPELINE_DEPTH];	// IF block (noise and signal) before quantization
+	PSAT_PARAM_SET ParamSlot;
+	CPipelineQueue ParamQueue(PIPELINE_DEPTH), BlockQueue(PIPELINE_DEPTH);
+	std::thread ParamThread, QuantThread;
+	int Slot;
 	CommandArguments Arguments;
 
 	// Default arguments
@@ -102,6 +171,17 @@ int main(int argc, char* argv[])
 	Arguments.MultiThread = true; // Default to use multi-threading
 	Arguments.ValidateOnly = false;
 	Arguments.OutputTag = false;
+	Arguments.PrecisionCheck = false;
+	Arguments.SampleType = -1;
+	Arguments.NoiseSeed = -1;
+	Arguments.BlockLength = -1;
+	Arguments.QuantBenchmark = false;
+	Arguments.DirectIo = false;
+	Arguments.VerifyPrn = false;
+	Arguments.VerifyEph = false;
+	Arguments.OrbitInterpWindow = -1;
+	Arguments.VerifyInterp = false;
+	Arguments.VerifyLdpc = false;
 
 	SetOutputFile(stdout);
 //	SetOutputLevel(MSG_LEVEL_INFO);
@@ -115,6 +195,23 @@ int main(int argc, char* argv[])
 
 	if (!ParseCommandLineArgs(argc, argv, Arguments))
 		return 1;
+	if (Arguments.QuantBenchmark)
+	{
+		QuantizerBenchmark(QUANT_BENCHMARK_SAMPLES);
+		return 0;
+	}
+	if (Arguments.VerifyPrn)
+	{
+		int CodeNumber, Mismatch = PrnGenerate::VerifyCodeTable(CodeNumber);
+
+		if (Mismatch < 0)
+			printf("[WARNING]\tCompile time PRN code tables not enabled (build with PRN_CONSTEXPR_TABLE)\n");
+		else
+			printf("[INFO]\t%d PRN codes in compile time tables verified, %d mismatch\n", CodeNumber, Mismatch);
+		return (Mismatch > 0) ? 1 : 0;
+	}
+	if (Arguments.VerifyLdpc)
+		return VerifyLDPCEncode() ? 0 : 1;
 
 	
 	printf("\n================================================================================\n");
@@ -144,6 +241,26 @@ int main(int argc, char* argv[])
 		OutputParam.filename[255] = '\0';
 		printf("[INFO]\tUsing output file from command line: %s\n", OutputParam.filename);
 	}
+	if (Arguments.SampleType >= 0)
+		OutputParam.SampleType = (IfSampleType)Arguments.SampleType;	// override sample type
+	if (Arguments.NoiseSeed >= 0)
+		OutputParam.NoiseSeed = (unsigned int)Arguments.NoiseSeed;	// override noise seed
+	NoiseGenerator.SetSeed(OutputParam.NoiseSeed);
+	if (Arguments.BlockLength > 0)
+		OutputParam.BlockLength = Arguments.BlockLength;	// override block length
+	if (OutputParam.BlockLength < 1 || OutputParam.BlockLength > MAX_BLOCK_LENGTH || (MAX_BLOCK_LENGTH % OutputParam.BlockLength) != 0)
+	{
+		printf("[WARNING]\tBlock length %d ms not supported (must divide %d), use 1 ms\n", OutputParam.BlockLength, MAX_BLOCK_LENGTH);
+		OutputParam.BlockLength = 1;
+	}
+	if (Arguments.OrbitInterpWindow >= 0)
+		OutputParam.OrbitInterpWindow = Arguments.OrbitInterpWindow;	// override orbit interpolation window
+	if (OutputParam.OrbitInterpWindow != 0 && (OutputParam.OrbitInterpWindow < ORBIT_INTERP_MIN_WINDOW || OutputParam.OrbitInterpWindow > ORBIT_INTERP_MAX_WINDOW))
+	{
+		printf("[WARNING]\tOrbit interpolation window %d s not supported (must be 0 or %d to %d), use exact evaluation\n", OutputParam.OrbitInterpWindow, ORBIT_INTERP_MIN_WINDOW, ORBIT_INTERP_MAX_WINDOW);
+		OutputParam.OrbitInterpWindow = 0;
+	}
+	BlockSampleNumber = OutputParam.SampleFreq * OutputParam.BlockLength;
 
 	// Validate configuration and exit if requested
 /*	if (Arguments.ValidateOnly)
@@ -165,15 +282,17 @@ int main(int argc, char* argv[])
 	CurPos = LlaToEcef(StartPos);
 	SpeedLocalToEcef(StartPos, StartVel, CurPos);
 
-	if (!Arguments.ValidateOnly)
+	if (!Arguments.ValidateOnly && !Arguments.VerifyEph && !Arguments.VerifyInterp)
 	{
 		printf("[INFO]\tOpening output file: %s\n", OutputParam.filename);
-		if ((IfFile = fopen(OutputParam.filename, "wb")) == NULL)
+		Quantizer.SetFormat(OutputParam.Format);
+		QuantLength = Quantizer.GetOutputSize(BlockSampleNumber);
+		if (!IfWriter.Open(OutputParam.filename, QuantLength, Arguments.DirectIo ? TRUE : FALSE))
 		{
 			printf("[ERROR]\tFailed to open output file: %s\n", OutputParam.filename);
 			return 0;
 		}
-		printf("[INFO]\tOutput file opened successfully.\n");
+		printf("[INFO]\tOutput file opened successfully%s.\n", IfWriter.IsDirectIo() ? " (direct IO)" : "");
 	}
 
 	if (Arguments.OutputTag)
@@ -201,13 +320,13 @@ int main(int argc, char* argv[])
 #endif
 
 	for (i = 0; i < TOTAL_GPS_SAT; i ++)
-		GpsSatParam[i].CN0 = (int)(PowerControl.InitCN0 * 100 + 0.5);
+		NextSatParam.GpsSatParam[i].CN0 = (int)(PowerControl.InitCN0 * 100 + 0.5);
 	for (i = 0; i < TOTAL_BDS_SAT; i ++)
-		BdsSatParam[i].CN0 = (int)(PowerControl.InitCN0 * 100 + 0.5);
+		NextSatParam.BdsSatParam[i].CN0 = (int)(PowerControl.InitCN0 * 100 + 0.5);
 	for (i = 0; i < TOTAL_GAL_SAT; i ++)
-		GalSatParam[i].CN0 = (int)(PowerControl.InitCN0 * 100 + 0.5);
+		NextSatParam.GalSatParam[i].CN0 = (int)(PowerControl.InitCN0 * 100 + 0.5);
 	for (i = 0; i < TOTAL_GLO_SAT; i++)
-		GloSatParam[i].CN0 = (int)(PowerControl.InitCN0 * 100 + 0.5);
+		NextSatParam.GloSatParam[i].CN0 = (int)(PowerControl.InitCN0 * 100 + 0.5);
 	// create naviagtion bit instances
 	for (i = 0; i < sizeof(NavBitArray) / sizeof(NavBit*); i++)
 	{
@@ -287,55 +406,53 @@ int main(int argc, char* argv[])
 	NavBitArray[DataBitD1D2]->SetIonoUtc(NavData.GetBdsIono(), NavData.GetBdsUtcParam());
 	NavBitArray[DataBitINav]->SetIonoUtc(NavData.GetGalileoIono(), NavData.GetGalileoUtcParam());
 	NavBitArray[DataBitFNav]->SetIonoUtc(NavData.GetGalileoIono(), NavData.GetGalileoUtcParam());
-	// Find ephemeris match current time and fill in data to generate bit stream
-	for (i = 1; i <= TOTAL_GPS_SAT; i ++)
+	// Find ephemeris match current time and queue them to composer to generate bit stream
+	NavBitComposer.AddNavBit(GpsSystem, NavBitArray[DataBitLNav]);
+	NavBitComposer.AddNavBit(GpsSystem, NavBitArray[DataBitCNav]);
+	NavBitComposer.AddNavBit(GpsSystem, NavBitArray[DataBitCNav2]);
+	NavBitComposer.AddNavBit(BdsSystem, NavBitArray[DataBitD1D2]);
+	NavBitComposer.AddNavBit(BdsSystem, NavBitArray[DataBitBCNav1]);
+	NavBitComposer.AddNavBit(BdsSystem, NavBitArray[DataBitBCNav2]);
+	NavBitComposer.AddNavBit(BdsSystem, NavBitArray[DataBitBCNav3]);
+	NavBitComposer.AddNavBit(GalileoSystem, NavBitArray[DataBitINav]);
+	NavBitComposer.AddNavBit(GalileoSystem, NavBitArray[DataBitFNav]);
+	NavBitComposer.AddNavBit(GlonassSystem, NavBitArray[DataBitGNav]);
+	UpdateEphemeris(CurTime, false);
+	if (Arguments.VerifyEph)
 	{
-		GpsEph[i-1] = NavData.FindEphemeris(GpsSystem, CurTime, i);
-		NavBitArray[DataBitLNav]->SetEphemeris(i, GpsEph[i - 1]);
-		NavBitArray[DataBitCNav]->SetEphemeris(i, GpsEph[i - 1]);
-		NavBitArray[DataBitCNav2]->SetEphemeris(i, GpsEph[i - 1]);
-	}
-	for (i = 1; i <= TOTAL_BDS_SAT; i ++)
-	{
-		BdsEph[i-1] = NavData.FindEphemeris(BdsSystem, BdsTime, i);
-		NavBitArray[DataBitD1D2]->SetEphemeris(i, BdsEph[i - 1]);
-		NavBitArray[DataBitBCNav1]->SetEphemeris(i, BdsEph[i - 1]);
-		NavBitArray[DataBitBCNav2]->SetEphemeris(i, BdsEph[i - 1]);
-		NavBitArray[DataBitBCNav3]->SetEphemeris(i, BdsEph[i - 1]);
-	}
-	for (i = 1; i <= TOTAL_GAL_SAT; i++)
-	{
-		GalEph[i - 1] = NavData.FindEphemeris(GalileoSystem, CurTime, i);
-		NavBitArray[DataBitINav]->SetEphemeris(i, GalEph[i - 1]);
-		NavBitArray[DataBitFNav]->SetEphemeris(i, GalEph[i - 1]);
-	}
-	for (i = 1; i <= TOTAL_GLO_SAT; i++)
-	{
-		GloEph[i - 1] = NavData.FindGloEphemeris(GlonassTime, i);
-		NavBitArray[DataBitGNav]->SetEphemeris(i, (PGPS_EPHEMERIS)GloEph[i - 1]);
+		bool Pass = VerifyEphemerisBatch("GPS", GpsSystem, GpsEph, TOTAL_GPS_SAT, CurTime.MilliSeconds / 1000.);
+		Pass = VerifyEphemerisBatch("BDS", BdsSystem, BdsEph, TOTAL_BDS_SAT, BdsTime.MilliSeconds / 1000.) && Pass;
+		Pass = VerifyEphemerisBatch("Galileo", GalileoSystem, GalEph, TOTAL_GAL_SAT, CurTime.MilliSeconds / 1000.) && Pass;
+		return Pass ? 0 : 1;
 	}
 	NavData.CompleteAlmanac(BdsSystem, UtcTime);
-	NavBitArray[DataBitLNav]->SetAlmanac(NavData.GetGpsAlmanac());
-	NavBitArray[DataBitCNav]->SetAlmanac(NavData.GetGpsAlmanac());
-	NavBitArray[DataBitCNav2]->SetAlmanac(NavData.GetGpsAlmanac());
-	NavBitArray[DataBitD1D2]->SetAlmanac(NavData.GetBdsAlmanac());
-	NavBitArray[DataBitBCNav1]->SetAlmanac(NavData.GetBdsAlmanac());
-	NavBitArray[DataBitBCNav2]->SetAlmanac(NavData.GetBdsAlmanac());
-	NavBitArray[DataBitBCNav3]->SetAlmanac(NavData.GetBdsAlmanac());
-	NavBitArray[DataBitINav]->SetAlmanac(NavData.GetGalileoAlmanac());
-	NavBitArray[DataBitFNav]->SetAlmanac(NavData.GetGalileoAlmanac());
-	NavBitArray[DataBitGNav]->SetAlmanac((PGPS_ALMANAC)NavData.GetGlonassAlmanac());
+	NavBitComposer.SetAlmanac(GpsSystem, NavData.GetGpsAlmanac());
+	NavBitComposer.SetAlmanac(BdsSystem, NavData.GetBdsAlmanac());
+	NavBitComposer.SetAlmanac(GalileoSystem, NavData.GetGalileoAlmanac());
+	NavBitComposer.SetAlmanac(GlonassSystem, (PGPS_ALMANAC)NavData.GetGlonassAlmanac());
+	NavBitComposer.Compose();
 
 	// calculate visible satellite at start time and calculate satellite parameters
-	GpsSatNumber = (OutputParam.FreqSelect[GpsSystem]) ? GetVisibleSatellite(CurPos, CurTime, OutputParam, GpsSystem, GpsEph, TOTAL_GPS_SAT, GpsEphVisible) : 0;
-	BdsSatNumber = (OutputParam.FreqSelect[BdsSystem]) ? GetVisibleSatellite(CurPos, CurTime, OutputParam, BdsSystem, BdsEph, TOTAL_BDS_SAT, BdsEphVisible) : 0;
-	GalSatNumber = (OutputParam.FreqSelect[GalileoSystem]) ? GetVisibleSatellite(CurPos, CurTime, OutputParam, GalileoSystem, GalEph, TOTAL_GAL_SAT, GalEphVisible) : 0;
-	GloSatNumber = (OutputParam.FreqSelect[GlonassSystem]) ? GetGlonassVisibleSatellite(CurPos, GlonassTime, OutputParam, GloEph, TOTAL_GLO_SAT, GloEphVisible) : 0;
+	InitSatVisibility(GpsVisibility, TOTAL_GPS_SAT);
+	InitSatVisibility(BdsVisibility, TOTAL_BDS_SAT);
+	InitSatVisibility(GalVisibility, TOTAL_GAL_SAT);
+	InitSatVisibility(GloVisibility, TOTAL_GLO_SAT);
 	ListCount = PowerControl.GetPowerControlList(0, PowerList);
-	UpdateSatParamList(CurTime, CurPos, ListCount, PowerList, NavData.GetGpsIono());
+	NextSatParam.Time = CurTime;
+	memset(NextSatParam.VisibleMask, 0, sizeof(NextSatParam.VisibleMask));
+	InitOrbitInterp(GpsOrbitInterp, TOTAL_GPS_SAT);
+	InitOrbitInterp(BdsOrbitInterp, TOTAL_BDS_SAT);
+	InitOrbitInterp(GalOrbitInterp, TOTAL_GAL_SAT);
+	InitGlonassOrbit(GloOrbit, TOTAL_GLO_SAT);
+	UpdateSatParamList(CurTime, CurPos, ListCount, PowerList, NavData.GetGpsIono(), &NextSatParam);
+	SatParam = NextSatParam;
+	memcpy(ChannelMask, SatParam.VisibleMask, sizeof(ChannelMask));
+	if (Arguments.VerifyInterp)
+		return VerifyOrbitInterp(CurTime, CurPos, NavData.GetGpsIono(), (int)(Trajectory.GetTimeLength() * 1000)) ? 0 : 1;
 
 	// create CSatIfSignal class for visible satellite, all other satellites clear pointer to NULL
 	memset(SatIfSignal, 0, sizeof(SatIfSignal));
+	ChannelPool.SetSampleFormat(OutputParam.SampleFreq, OutputParam.BlockLength, OutputParam.Interpolation);
 	TotalChannelNumber = 0;
 	printf("[INFO]\tGenerating IF data with following satellite signals:\n\n");
 	
@@ -428,13 +545,13 @@ int main(int argc, char* argv[])
 				break;
 			if (!Arguments.ValidateOnly)
 			{
-				SatIfSignal[TotalChannelNumber] = new CSatIfSignal(OutputParam.SampleFreq, IfFreq, GpsSystem, SignalIndex, GpsEphVisible[i]->svid);
-				SatIfSignal[TotalChannelNumber]->InitState(CurTime, &GpsSatParam[GpsEphVisible[i]->svid-1], GetNavData(GpsSystem, SignalIndex, NavBitArray));
+				SatIfSignal[TotalChannelNumber] = ChannelPool.GetChannel(IfFreq, GpsSystem, SignalIndex, GpsEphVisible[i]->svid);
+				SatIfSignal[TotalChannelNumber]->InitState(CurTime, &SatParam.GpsSatParam[GpsEphVisible[i]->svid-1], GetNavData(GpsSystem, SignalIndex, NavBitArray));
 			}
 			TotalChannelNumber++;
 			
 			if (svCount % 4 == 0) printf("|");
-			printf(" %02d | %+12d |", GpsEphVisible[i]->svid, (int)GetDoppler(&GpsSatParam[GpsEphVisible[i]->svid-1], SignalIndex));
+			printf(" %02d | %+12d |", GpsEphVisible[i]->svid, (int)GetDoppler(&SatParam.GpsSatParam[GpsEphVisible[i]->svid-1], SignalIndex));
 			svCount++;
 			if (svCount % 4 == 0) printf("\n");
 		}
@@ -464,13 +581,13 @@ int main(int argc, char* argv[])
 				break;
 			if (!Arguments.ValidateOnly)
 			{
-				SatIfSignal[TotalChannelNumber] = new CSatIfSignal(OutputParam.SampleFreq, IfFreq, BdsSystem, SignalIndex, BdsEphVisible[i]->svid);
-				SatIfSignal[TotalChannelNumber]->InitState(CurTime, &BdsSatParam[BdsEphVisible[i]->svid - 1], GetNavData(BdsSystem, SignalIndex, NavBitArray));
+				SatIfSignal[TotalChannelNumber] = ChannelPool.GetChannel(IfFreq, BdsSystem, SignalIndex, BdsEphVisible[i]->svid);
+				SatIfSignal[TotalChannelNumber]->InitState(CurTime, &SatParam.BdsSatParam[BdsEphVisible[i]->svid - 1], GetNavData(BdsSystem, SignalIndex, NavBitArray));
 			}
 			TotalChannelNumber++;
 			
 			if (svCount % 4 == 0) printf("|");
-			printf(" %02d | %+12d |", BdsEphVisible[i]->svid, (int)GetDoppler(&BdsSatParam[BdsEphVisible[i]->svid-1], SignalIndex));
+			printf(" %02d | %+12d |", BdsEphVisible[i]->svid, (int)GetDoppler(&SatParam.BdsSatParam[BdsEphVisible[i]->svid-1], SignalIndex));
 			svCount++;
 			if (svCount % 4 == 0) printf("\n");
 		}
@@ -499,13 +616,13 @@ int main(int argc, char* argv[])
 				break;
 			if (!Arguments.ValidateOnly)
 			{
-				SatIfSignal[TotalChannelNumber] = new CSatIfSignal(OutputParam.SampleFreq, IfFreq, GalileoSystem, SignalIndex, GalEphVisible[i]->svid);
-				SatIfSignal[TotalChannelNumber]->InitState(CurTime, &GalSatParam[GalEphVisible[i]->svid - 1], GetNavData(GalileoSystem, SignalIndex, NavBitArray));
+				SatIfSignal[TotalChannelNumber] = ChannelPool.GetChannel(IfFreq, GalileoSystem, SignalIndex, GalEphVisible[i]->svid);
+				SatIfSignal[TotalChannelNumber]->InitState(CurTime, &SatParam.GalSatParam[GalEphVisible[i]->svid - 1], GetNavData(GalileoSystem, SignalIndex, NavBitArray));
 			}
 			TotalChannelNumber++;
 			
 			if (svCount % 4 == 0) printf("|");
-			printf(" %02d | %+12d |", GalEphVisible[i]->svid, (int)GetDoppler(&GalSatParam[GalEphVisible[i]->svid-1], SignalIndex));
+			printf(" %02d | %+12d |", GalEphVisible[i]->svid, (int)GetDoppler(&SatParam.GalSatParam[GalEphVisible[i]->svid-1], SignalIndex));
 			svCount++;
 			if (svCount % 4 == 0) printf("\n");
 		}
@@ -535,13 +652,13 @@ int main(int argc, char* argv[])
 			FdmaOffset = (SignalIndex == SIGNAL_INDEX_G1) ? GloEphVisible[i]->freq * 562500 : (SignalIndex == SIGNAL_INDEX_G2) ? GloEphVisible[i]->freq * 437500 : 0;
 			if (!Arguments.ValidateOnly)
 			{
-				SatIfSignal[TotalChannelNumber] = new CSatIfSignal(OutputParam.SampleFreq, IfFreq + FdmaOffset, GlonassSystem, SignalIndex, GloEphVisible[i]->n);
-				SatIfSignal[TotalChannelNumber]->InitState(CurTime, &GloSatParam[GloEphVisible[i]->n - 1], GetNavData(GlonassSystem, SignalIndex, NavBitArray));
+				SatIfSignal[TotalChannelNumber] = ChannelPool.GetChannel(IfFreq + FdmaOffset, GlonassSystem, SignalIndex, GloEphVisible[i]->n);
+				SatIfSignal[TotalChannelNumber]->InitState(CurTime, &SatParam.GloSatParam[GloEphVisible[i]->n - 1], GetNavData(GlonassSystem, SignalIndex, NavBitArray));
 			}
 			TotalChannelNumber++;
 			
 			if (svCount % 4 == 0) printf("|");
-			printf(" %02d | %+12d |", GloEphVisible[i]->n, (int)GetDoppler(&GloSatParam[GloEphVisible[i]->n-1], SignalIndex));
+			printf(" %02d | %+12d |", GloEphVisible[i]->n, (int)GetDoppler(&SatParam.GloSatParam[GloEphVisible[i]->n-1], SignalIndex));
 			svCount++;
 			if (svCount % 4 == 0) printf("\n");
 		}
@@ -571,106 +688,91 @@ int main(int argc, char* argv[])
 		return 0;
 	}
 
-	NoiseArray = new complex_number[OutputParam.SampleFreq];
-	QuantArray = new unsigned char[OutputParam.SampleFreq * 4];
+	SampleSize = (OutputParam.SampleType == SampleTypeFloat) ? sizeof(float) : (OutputParam.SampleType == SampleTypeInt16) ? sizeof(short) : sizeof(double);
+	printf("[INFO]\tNoise seed: %u\n", OutputParam.NoiseSeed);
+	printf("[INFO]\tGeneration block: %d ms, %s interpolation\n", OutputParam.BlockLength, (OutputParam.Interpolation == InterpolationQuadratic) ? "quadratic" : "linear");
+	if (OutputParam.OrbitInterpWindow > 0)
+		printf("[INFO]\tSatellite orbit: interpolation over %d s window\n", OutputParam.OrbitInterpWindow);
+	else
+		printf("[INFO]\tSatellite orbit: exact evaluation\n");
+	if ((totalDurationMs % OutputParam.BlockLength) != 0)
+		printf("[WARNING]\tSignal duration not multiple of block length, last %d ms not generated\n", totalDurationMs % OutputParam.BlockLength);
+	printf("[INFO]\tIF sample type: %s\n", (OutputParam.SampleType == SampleTypeFloat) ? "float" : (OutputParam.SampleType == SampleTypeInt16) ? "int16" : "double");
+	if (Arguments.PrecisionCheck)
+		CheckSampleTypePrecision(OutputParam.SampleType, SatIfSignal, TotalChannelNumber, BlockSampleNumber);
+	if (OutputParam.NoiseBufferSize > 0)
+		CreateNoiseBuffer(OutputParam.SampleType, OutputParam.NoiseBufferSize, OutputParam.SampleFreq);
+#ifdef _OPENMP
+	ThreadNumber = Arguments.MultiThread ? omp_get_max_threads() : 1;
+#else
+	ThreadNumber = 1;
+#endif
+	if (ThreadNumber > 1)
+		printf("[INFO]\tParallel generation: %d threads on %d tiles of %d samples\n", ThreadNumber, (BlockSampleNumber + IF_TILE_SAMPLES - 1) / IF_TILE_SAMPLES, IF_TILE_SAMPLES);
+	// pipelined generation uses PIPELINE_DEPTH block buffers
+	Pipelined = Arguments.MultiThread;
+	for (i = 0; i < PIPELINE_DEPTH; i++)
+		BlockBuffer[i] = (i == 0 || Pipelined) ? new unsigned char[BlockSampleNumber * 2 * SampleSize] : NULL;
+	ParamSlot = Pipelined ? new SAT_PARAM_SET[PIPELINE_DEPTH] : NULL;
+	printf("[INFO]\tPipelined generation: %s\n", Pipelined ? "enabled" : "disabled");
 
 	// Calculate total data size and setup progress tracking
 	int exec_cycle = 0;
-	long long TotalClippedSamples = 0;
-	long long TotalSamples = 0;
-	double AGCGain = 1.0;
 	printf("[INFO]\tStarting signal generation loop...\n");
 	fflush(stdout);
 	
 	auto start_time = std::chrono::high_resolution_clock::now();
 	
-	while (!StepToNextMs())
+	if (Pipelined)
 	{
-		exec_cycle ++;
-		// generate white noise
-		for (i = 0; i < OutputParam.SampleFreq; i ++)
-			NoiseArray[i] = GenerateNoise(1.0);
-		
-		// Use parallel or serial processing based on command line flag
-		if (Arguments.MultiThread)
-		{
-			#ifdef _OPENMP
-			// Parallel satellite signal generation using OpenMP (auto-detects thread count)
-			#pragma omp parallel for schedule(dynamic)
-			for (i = 0; i < TotalChannelNumber; i++)	// TOTAL_SAT_CHANNEL
-				SatIfSignal[i]->GetIfSample(CurTime);
-
-			#else
-			// OpenMP not available, fall back to sequential processing
-			for (i = 0; i < TotalChannelNumber; i++)
-				SatIfSignal[i]->GetIfSample(CurTime);
-			
-			#endif
-		}
-		else
-		{
-			// True serial execution - no OpenMP overhead
-			for (i = 0; i < TotalChannelNumber; i++)
-				SatIfSignal[i]->GetIfSample(CurTime);
-
-		}
-
-		// Sequential accumulation to avoid race conditions (Dont nest this loop, causes issues with OpenMP)
-		for (i = 0; i < TotalChannelNumber; i++)
-		{
-			for (j = 0; j < OutputParam.SampleFreq; j++)
-				NoiseArray[j] += SatIfSignal[i]->SampleArray[j];
-		}
+		ParamThread = std::thread(ParameterStage, &ParamQueue, ParamSlot);
+		QuantThread = std::thread(QuantizeStage, &BlockQueue, BlockBuffer, &Quantizer, &IfWriter);
+	}
 
-		
-		if (OutputParam.Format == OutputFormatIQ2) 
-		{
-			TotalClippedSamples += QuantSamplesIQ2(NoiseArray, OutputParam.SampleFreq, QuantArray, AGCGain);
-			// Pack 2 samples per byte
-			fwrite(QuantArray, sizeof(unsigned char), OutputParam.SampleFreq / 2, IfFile);	// 1/2 byte/sample
-		}
-		else if (OutputParam.Format == OutputFormatIQ4) 
-		{
-			TotalClippedSamples += QuantSamplesIQ4(NoiseArray, OutputParam.SampleFreq, QuantArray, AGCGain);
-			fwrite(QuantArray, sizeof(unsigned char), OutputParam.SampleFreq, IfFile); // 1 byte/sample
-		}
-		else if (OutputParam.Format == OutputFormatIQ16) 
+	while (true)
+	{
+		// get satellite parameter of this ms
+		if (Pipelined)
 		{
-			TotalClippedSamples += QuantSamplesIQ16(NoiseArray, OutputParam.SampleFreq, QuantArray, AGCGain);
-			fwrite(QuantArray, sizeof(unsigned char) * 4, OutputParam.SampleFreq, IfFile); // 4 bytes/sample
+			if ((Slot = ParamQueue.GetReadSlot()) < 0)
+				break;
+			CopySatParam(&SatParam, &ParamSlot[Slot]);
+			ParamQueue.Pop();
 		}
 		else
 		{
-			TotalClippedSamples += QuantSamplesIQ8(NoiseArray, OutputParam.SampleFreq, QuantArray, AGCGain);
-			fwrite(QuantArray, sizeof(unsigned char) * 2, OutputParam.SampleFreq, IfFile); // 2 bytes/sample
+			if (StepToNextBlock())
+				break;
+			CopySatParam(&SatParam, &NextSatParam);
 		}
-		TotalSamples += OutputParam.SampleFreq * 2; // I and Q
-
-#if 1
-		// Adjust gain every 100ms
-		if ((exec_cycle % 100) == 0)
+		CurTime = SatParam.Time;
+		exec_cycle += OutputParam.BlockLength;	// number of ms generated
+		// ephemeris found ahead by parameter stage goes to navigation data when synthesis reaches its switch time
+		EphSwitchCount += NavBitComposer.Update(CurTime.Week * 604800000LL + CurTime.MilliSeconds);
+
+		// generate noise and signal of all channels, then quantize
+		Slot = Pipelined ? BlockQueue.GetWriteSlot() : 0;
+		switch (OutputParam.SampleType)
 		{
-			double ClippingRate = (double)TotalClippedSamples / TotalSamples;
-			if (ClippingRate > 0.01) // clipped rate over 1%
-			{
-				AGCGain *= 0.95; // reduce gain by 5%
-				printf("[WARNING]\tAGC: Clipping %.2f%%, reducing gain to %.3f\n", ClippingRate * 100, AGCGain);
-				TotalClippedSamples = TotalSamples = 0;	// reset statistic
-			}
-			else if (ClippingRate < 0.001 && AGCGain < 1.0) // clipped rate under 0.1%
-			{
-				AGCGain *= 1.02; // increase gain by 2%
-				if (AGCGain > 1.0) AGCGain = 1.0;
-				printf("[WARNING]\tAGC: Clipping %.2f%%, increasing gain to %.3f\n", ClippingRate * 100, AGCGain);
-				TotalClippedSamples = TotalSamples = 0;	// reset statistic
-			}
+		case SampleTypeFloat:
+			GenerateIfBlock((float *)BlockBuffer[Slot], ThreadNumber, SatIfSignal, TotalChannelNumber, OutputParam.SampleFreq, OutputParam.BlockLength, exec_cycle - OutputParam.BlockLength + 1);
+			break;
+		case SampleTypeInt16:
+			GenerateIfBlock((short *)BlockBuffer[Slot], ThreadNumber, SatIfSignal, TotalChannelNumber, OutputParam.SampleFreq, OutputParam.BlockLength, exec_cycle - OutputParam.BlockLength + 1);
+			break;
+		default:
+			GenerateIfBlock((double *)BlockBuffer[Slot], ThreadNumber, SatIfSignal, TotalChannelNumber, OutputParam.SampleFreq, OutputParam.BlockLength, exec_cycle - OutputParam.BlockLength + 1);
+			break;
 		}
-#endif
+		if (Pipelined)
+			BlockQueue.Push();
+		else
+			QuantizeIfBlock(BlockBuffer[Slot], &Quantizer, &IfWriter);
+		// retire channels of satellites set and add channels of satellites risen at end of this block
+		TotalChannelNumber = UpdateChannelList(&ChannelPool, SatIfSignal, TotalChannelNumber, ChannelMask, NavBitArray);
 
-//		for (j = 0; j < OutputParam.SampleFreq; j ++)
-//			printf("%f %f\n", NoiseArray[j].real, NoiseArray[j].imag);
 		// Enhanced progress reporting with percentage, MB/s, and ETA
-		if ((exec_cycle % 25) == 0)
+		if ((exec_cycle % 20) == 0)	// multiple of any block length
 		{
 			auto current_time = std::chrono::high_resolution_clock::now();
 			auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(current_time - start_time).count();
@@ -729,6 +831,12 @@ int main(int argc, char* argv[])
 		}
 //		if (length == 2) break;
 	}
+	if (Pipelined)
+	{
+		BlockQueue.Finish();
+		ParamThread.join();
+		QuantThread.join();
+	}
 	
 	// Final progress bar update to ensure 100% is shown
 	printf("\r[");
@@ -742,6 +850,7 @@ int main(int argc, char* argv[])
 	printf("] %d/%d ms | %.2f/%.2f MB | \tCOMPLETED\n",
 		   totalDurationMs, totalDurationMs, totalMB, totalMB); 
 	
+	IfWriter.Close();	// wait until all data written
 	auto end_time = std::chrono::high_resolution_clock::now();
 	auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 	double finalMB = (exec_cycle * bytesPerMs) / (1024.0 * 1024.0);
@@ -749,106 +858,723 @@ int main(int argc, char* argv[])
 
 	printf("\n[INFO]\tIF Signal generation completed!\n");
 	printf("------------------------------------------------------------------\n");
-	printf("[INFO]\tTotal samples: %lld\n", TotalSamples);
-	printf("[INFO]\tClipped samples: %lld (%.4f%%)\n", TotalClippedSamples, (double)TotalClippedSamples / TotalSamples * 100);
-	printf("[INFO]\tFinal AGC gain: %.3f\n", AGCGain);
-	if ((double)TotalClippedSamples / TotalSamples > 0.05)
+	printf("[INFO]\tTotal samples: %lld\n", Quantizer.GetTotalSamples());
+	printf("[INFO]\tClipped samples: %lld (%.4f%%)\n", Quantizer.GetTotalClipped(), (double)Quantizer.GetTotalClipped() / Quantizer.GetTotalSamples() * 100);
+	printf("[INFO]\tFinal AGC gain: %.3f\n", Quantizer.GetGain());
+	if ((double)Quantizer.GetTotalClipped() / Quantizer.GetTotalSamples() > 0.05)
 	{
 		printf("[WARNING]\tHigh clipping rate! Consider reducing initPower in JSON config.\n");
 	}
 	printf("[INFO]\tTotal time taken: %0.2f s\n", duration.count()/1000.0);
 	printf("[INFO]\tData generated: %.2f MB\n", finalMB);
 	printf("[INFO]\tAverage rate: %.2f MB/s\n", avgMbPerSec);
+	printf("[INFO]\tWriter: %d writes, write time %.2f s, generation stalled %d times for %.3f s\n",
+		IfWriter.GetWriteCount(), IfWriter.GetWriteTime(), IfWriter.GetStallCount(), IfWriter.GetStallTime());
+	if (IfWriter.HasError())
+		printf("[WARNING]\tFailed to write IF data, only %lld bytes written\n", IfWriter.GetBytesWritten());
+	printf("[INFO]\tChannels: %d satellites risen, %d satellites set, %d channels created, %d reused\n",
+		ChannelAddCount, ChannelRetireCount, ChannelPool.GetCreateCount(), ChannelPool.GetReuseCount());
+	printf("[INFO]\tEphemeris: %d satellites switched to new ephemeris\n", EphSwitchCount);
+	if (Pipelined)
+		printf("[INFO]\tPipeline: synthesis waited %.3f s for parameter and %.3f s for quantizer, quantizer idle %.3f s\n",
+			ParamQueue.GetConsumerStall(), BlockQueue.GetProducerStall(), BlockQueue.GetConsumerStall());
 	printf("------------------------------------------------------------------\n\n");
 
-	for (i = 0; i < TOTAL_SAT_CHANNEL; i ++)
-		if (SatIfSignal[i]) delete SatIfSignal[i];
+	for (i = 0; i < TotalChannelNumber; i ++)
+		ChannelPool.ReleaseChannel(SatIfSignal[i]);
 	for (i = 0; i < static_cast<int>(sizeof(NavBitArray) / sizeof(NavBitArray[0])); ++i)
 		delete NavBitArray[i];
-	delete[] NoiseArray;
-	delete[] QuantArray;
-	fclose(IfFile);
+	for (i = 0; i < PIPELINE_DEPTH; i++)
+		delete[] (unsigned char *)BlockBuffer[i];
+	delete[] ParamSlot;
 
 	return 0;
 }
 
-void UpdateSatParamList(GNSS_TIME CurTime, KINEMATIC_INFO CurPos, int ListCount, PSIGNAL_POWER PowerList, PIONO_PARAM IonoParam)
+void UpdateSatParamList(GNSS_TIME CurTime, KINEMATIC_INFO CurPos, int ListCount, PSIGNAL_POWER PowerList, PIONO_PARAM IonoParam, PSAT_PARAM_SET ParamSet)
 {
 	int i, index;
 	LLA_POSITION PosLLA = EcefToLla(CurPos);
-	int TotalSatNumber = 0;
 
-	for (i = 0; i < GpsSatNumber; i ++)
+	UpdateVisibleList(CurTime, CurPos, ParamSet);
+	// satellite positions of GPS/BDS/Galileo interpolated or calculated in batch for each system
+	if (OutputParam.OrbitInterpWindow > 0)
 	{
-		index = GpsEphVisible[i]->svid - 1;
-		GetSatelliteParam(CurPos, PosLLA, CurTime, GpsSystem, GpsEphVisible[i], IonoParam, &GpsSatParam[index]);
-		GetSatelliteCN0(ListCount, PowerList, PowerControl.InitCN0, PowerControl.Adjust, &GpsSatParam[index]);
+		GetSatelliteParamInterp(CurPos, PosLLA, CurTime, GpsSystem, GpsEphVisible, GpsSatNumber, IonoParam, OutputParam.OrbitInterpWindow, GpsOrbitInterp, ParamSet->GpsSatParam);
+		GetSatelliteParamInterp(CurPos, PosLLA, CurTime, BdsSystem, BdsEphVisible, BdsSatNumber, IonoParam, OutputParam.OrbitInterpWindow, BdsOrbitInterp, ParamSet->BdsSatParam);
+		GetSatelliteParamInterp(CurPos, PosLLA, CurTime, GalileoSystem, GalEphVisible, GalSatNumber, IonoParam, OutputParam.OrbitInterpWindow, GalOrbitInterp, ParamSet->GalSatParam);
 	}
-	for (i = 0; i < BdsSatNumber; i ++)
+	else
 	{
-		index = BdsEphVisible[i]->svid - 1;
-		GetSatelliteParam(CurPos, PosLLA, CurTime, BdsSystem, BdsEphVisible[i], IonoParam, &BdsSatParam[index]);
-		GetSatelliteCN0(ListCount, PowerList, PowerControl.InitCN0, PowerControl.Adjust, &BdsSatParam[index]);
+		GetSatelliteParamBatch(CurPos, PosLLA, CurTime, GpsSystem, GpsEphVisible, GpsSatNumber, IonoParam, ParamSet->GpsSatParam);
+		GetSatelliteParamBatch(CurPos, PosLLA, CurTime, BdsSystem, BdsEphVisible, BdsSatNumber, IonoParam, ParamSet->BdsSatParam);
+		GetSatelliteParamBatch(CurPos, PosLLA, CurTime, GalileoSystem, GalEphVisible, GalSatNumber, IonoParam, ParamSet->GalSatParam);
 	}
+	for (i = 0; i < GpsSatNumber; i ++)
+		GetSatelliteCN0(ListCount, PowerList, PowerControl.InitCN0, PowerControl.Adjust, &ParamSet->GpsSatParam[GpsEphVisible[i]->svid - 1]);
+	for (i = 0; i < BdsSatNumber; i ++)
+		GetSatelliteCN0(ListCount, PowerList, PowerControl.InitCN0, PowerControl.Adjust, &ParamSet->BdsSatParam[BdsEphVisible[i]->svid - 1]);
 	for (i = 0; i < GalSatNumber; i ++)
-	{
-		index = GalEphVisible[i]->svid - 1;
-		GetSatelliteParam(CurPos, PosLLA, CurTime, GalileoSystem, GalEphVisible[i], IonoParam, &GalSatParam[index]);
-		GetSatelliteCN0(ListCount, PowerList, PowerControl.InitCN0, PowerControl.Adjust, &GalSatParam[index]);
-	}
+		GetSatelliteCN0(ListCount, PowerList, PowerControl.InitCN0, PowerControl.Adjust, &ParamSet->GalSatParam[GalEphVisible[i]->svid - 1]);
 	for (i = 0; i < GloSatNumber; i++)
 	{
 		index = GloEphVisible[i]->n - 1;
-		GetSatelliteParam(CurPos, PosLLA, CurTime, GlonassSystem, (PGPS_EPHEMERIS)GloEphVisible[i], IonoParam, &GloSatParam[index]);
-		GetSatelliteCN0(ListCount, PowerList, PowerControl.InitCN0, PowerControl.Adjust, &GloSatParam[index]);
+		GetSatelliteParam(CurPos, PosLLA, CurTime, GlonassSystem, (PGPS_EPHEMERIS)GloEphVisible[i], IonoParam, &ParamSet->GloSatParam[index], &GloOrbit[index]);
+		GetSatelliteCN0(ListCount, PowerList, PowerControl.InitCN0, PowerControl.Adjust, &ParamSet->GloSatParam[index]);
+	}
+}
+
+// update visibility at CurTime, parameter lists keep satellites visible at previous update
+// so that channels of satellites just set still have parameter at end of the block
+void UpdateVisibleList(GNSS_TIME CurTime, KINEMATIC_INFO CurPos, PSAT_PARAM_SET ParamSet)
+{
+	GpsSatNumber = GetParamList(CurTime, CurPos, GpsSystem, GpsEph, TOTAL_GPS_SAT, GpsVisibility, ParamSet, GpsEphVisible);
+	BdsSatNumber = GetParamList(CurTime, CurPos, BdsSystem, BdsEph, TOTAL_BDS_SAT, BdsVisibility, ParamSet, BdsEphVisible);
+	GalSatNumber = GetParamList(CurTime, CurPos, GalileoSystem, GalEph, TOTAL_GAL_SAT, GalVisibility, ParamSet, GalEphVisible);
+	GloSatNumber = GetParamList(CurTime, CurPos, GlonassSystem, (PGPS_EPHEMERIS *)GloEph, TOTAL_GLO_SAT, GloVisibility, ParamSet, (PGPS_EPHEMERIS *)GloEphVisible);
+}
+
+// VisibleMask of ParamSet holds visibility of previous update on entry
+int GetParamList(GNSS_TIME CurTime, KINEMATIC_INFO CurPos, GnssSystem System, PGPS_EPHEMERIS Eph[], int Number, SAT_VISIBILITY Visibility[], PSAT_PARAM_SET ParamSet, PGPS_EPHEMERIS EphList[])
+{
+	PGPS_EPHEMERIS EphVisible[TOTAL_BDS_SAT];
+	unsigned long long VisibleMask = 0;
+	int i, SatNumber = 0;
+
+	if (OutputParam.FreqSelect[System])
+	{
+		UpdateVisibleSatellite(CurPos, CurTime, OutputParam, System, Eph, Number, Visibility, EphVisible);
+		for (i = 0; i < Number; i ++)
+			if (Visibility[i].Visible)
+				VisibleMask |= (1ULL << i);
 	}
+	ParamSet->ParamMask[System] = VisibleMask | ParamSet->VisibleMask[System];
+	ParamSet->VisibleMask[System] = VisibleMask;
+	for (i = 0; i < Number; i ++)
+		if (ParamSet->ParamMask[System] & (1ULL << i))
+			EphList[SatNumber ++] = Eph[i];
+	return SatNumber;
 }
 
-int StepToNextMs()
+int StepToNextBlock()
 {
 	KINEMATIC_INFO CurPos;
-	int ListCount = 0;
+	int i, ListCount = 0;
 	PSIGNAL_POWER PowerList = NULL;
-//	UTC_TIME UtcTime;
-//	GLONASS_TIME GlonassTime;
 
-	if (!Trajectory.GetNextPosVelECEF(0.001, CurPos))
-		return -1;
+	// trajectory steps 1ms each time so that position at block end is the same for any block length
+	for (i = 0; i < OutputParam.BlockLength; i ++)
+		if (!Trajectory.GetNextPosVelECEF(0.001, CurPos))
+			return -1;
 
 	// calculate new satellite parameter
-	ListCount = PowerControl.GetPowerControlList(1, PowerList);
-	if (++CurTime.MilliSeconds > 604800000)
+	ListCount = PowerControl.GetPowerControlList(OutputParam.BlockLength, PowerList);
+	if ((NextSatParam.Time.MilliSeconds += OutputParam.BlockLength) > 604800000)
 	{
-		CurTime.Week ++;
-		CurTime.MilliSeconds -= 604800000;
+		NextSatParam.Time.Week ++;
+		NextSatParam.Time.MilliSeconds -= 604800000;
 	}
-/*	UtcTime = GpsTimeToUtc(CurTime);
-	if ((CurTime.MilliSeconds % 60000) == 0)	// recalculate visible satellite at minute boundary
-	{
-		GlonassTime = UtcToGlonassTime(UtcTime);
-		GpsSatNumber = (OutputParam.FreqSelect[GpsSystem]) ? GetVisibleSatellite(CurPos, CurTime, OutputParam, GpsSystem, GpsEph, TOTAL_GPS_SAT, GpsEphVisible) : 0;
-		BdsSatNumber = (OutputParam.FreqSelect[BdsSystem]) ? GetVisibleSatellite(CurPos, CurTime, OutputParam, BdsSystem, BdsEph, TOTAL_BDS_SAT, BdsEphVisible) : 0;
-		GalSatNumber = (OutputParam.FreqSelect[GalileoSystem]) ? GetVisibleSatellite(CurPos, CurTime, OutputParam, GalileoSystem, GalEph, TOTAL_GAL_SAT, GalEphVisible) : 0;
-		GloSatNumber = (OutputParam.FreqSelect[GlonassSystem]) ? GetGlonassVisibleSatellite(CurPos, GlonassTime, OutputParam, GloEph, TOTAL_GLO_SAT, GloEphVisible) : 0;
-	}*/
-	UpdateSatParamList(CurTime, CurPos, ListCount, PowerList, NavData.GetGpsIono());
+	if (NextSatParam.Time.Week * 604800000LL + NextSatParam.Time.MilliSeconds >= EphSwitchTime)
+		UpdateEphemeris(NextSatParam.Time, true);
+	UpdateSatParamList(NextSatParam.Time, CurPos, ListCount, PowerList, NavData.GetGpsIono(), &NextSatParam);
 	return 0;
 }
 
-complex_number GenerateNoise(double Sigma)
+// find ephemeris of all satellites at Time and queue changed ones to composer, then set EphSwitchTime to earliest switch
+// on start ephemeris of all systems are queued and composed by caller together with almanac
+// when running only selected systems are checked and new ephemeris queued with Time as switch time, called ahead of
+// synthesis if pipelined, so navigation data is composed by synthesis on reaching Time while satellite parameter uses
+// new ephemeris from Time on, orbit of switched satellites refitted on following parameter update as interpolation and
+// GLONASS orbit are bound to ephemeris
+void UpdateEphemeris(GNSS_TIME Time, bool Running)
+{
+	UTC_TIME UtcTime = GpsTimeToUtc(Time);
+	GLONASS_TIME GlonassTime = UtcToGlonassTime(UtcTime);
+	GNSS_TIME BdsTime = UtcToBdsTime(UtcTime);
+	long long SwitchTime = Time.Week * 604800000LL + Time.MilliSeconds;
+	int Switch[4], NextSwitch = -1, i;
+
+	Switch[GpsSystem] = (!Running || OutputParam.FreqSelect[GpsSystem]) ? UpdateSystemEphemeris(GpsSystem, Time, GlonassTime, SwitchTime, GpsEph, GpsVisibility, TOTAL_GPS_SAT) : -1;
+	Switch[BdsSystem] = (!Running || OutputParam.FreqSelect[BdsSystem]) ? UpdateSystemEphemeris(BdsSystem, BdsTime, GlonassTime, SwitchTime, BdsEph, BdsVisibility, TOTAL_BDS_SAT) : -1;
+	Switch[GalileoSystem] = (!Running || OutputParam.FreqSelect[GalileoSystem]) ? UpdateSystemEphemeris(GalileoSystem, Time, GlonassTime, SwitchTime, GalEph, GalVisibility, TOTAL_GAL_SAT) : -1;
+	Switch[GlonassSystem] = (!Running || OutputParam.FreqSelect[GlonassSystem]) ? UpdateSystemEphemeris(GlonassSystem, Time, GlonassTime, SwitchTime, (PGPS_EPHEMERIS *)GloEph, GloVisibility, TOTAL_GLO_SAT) : -1;
+	for (i = 0; i < 4; i ++)
+		if (Switch[i] >= 0 && (NextSwitch < 0 || Switch[i] < NextSwitch))
+			NextSwitch = Switch[i];
+	EphSwitchTime = (NextSwitch < 0) ? EPH_SWITCH_NEVER : SwitchTime + NextSwitch;
+}
+
+// Time is system time of System (not used for GLONASS), SwitchTime is GPS millisecond the new ephemeris composed at
+// return milliseconds to earliest ephemeris switch of satellites in system if system selected, -1 if none,
+// NULL ephemeris found keeps current one
+int UpdateSystemEphemeris(GnssSystem System, GNSS_TIME Time, GLONASS_TIME GlonassTime, long long SwitchTime, PGPS_EPHEMERIS Eph[], SAT_VISIBILITY Visibility[], int Number)
+{
+	PGPS_EPHEMERIS NewEph;
+	int i, Switch, NextSwitch = -1;
+
+	for (i = 1; i <= Number; i ++)
+	{
+		NewEph = (System == GlonassSystem) ? (PGPS_EPHEMERIS)NavData.FindGloEphemeris(GlonassTime, i) : NavData.FindEphemeris(System, Time, i);
+		if (NavBitComposer.SetEphemeris(System, i, NewEph, SwitchTime))
+		{
+			Eph[i-1] = NewEph;
+			Visibility[i-1].CheckTime = 0;	// health may differ, evaluate visibility again
+		}
+		if (!OutputParam.FreqSelect[System])
+			continue;
+		Switch = (System == GlonassSystem) ? NavData.GetGloEphemerisSwitchTime(GlonassTime, i) : NavData.GetEphemerisSwitchTime(System, Time, i);
+		if (Switch >= 0 && (NextSwitch < 0 || Switch < NextSwitch))
+			NextSwitch = Switch;
+	}
+	return NextSwitch;
+}
+
+// copy time, visibility and parameters of satellites in parameter list
+void CopySatParam(PSAT_PARAM_SET Dest, const SAT_PARAM_SET *Src)
+{
+	Dest->Time = Src->Time;
+	memcpy(Dest->VisibleMask, Src->VisibleMask, sizeof(Dest->VisibleMask));
+	memcpy(Dest->ParamMask, Src->ParamMask, sizeof(Dest->ParamMask));
+	CopyParamArray(Src->ParamMask[GpsSystem], Dest->GpsSatParam, Src->GpsSatParam, TOTAL_GPS_SAT);
+	CopyParamArray(Src->ParamMask[BdsSystem], Dest->BdsSatParam, Src->BdsSatParam, TOTAL_BDS_SAT);
+	CopyParamArray(Src->ParamMask[GalileoSystem], Dest->GalSatParam, Src->GalSatParam, TOTAL_GAL_SAT);
+	CopyParamArray(Src->ParamMask[GlonassSystem], Dest->GloSatParam, Src->GloSatParam, TOTAL_GLO_SAT);
+}
+
+void CopyParamArray(unsigned long long Mask, SATELLITE_PARAM Dest[], const SATELLITE_PARAM Src[], int Number)
+{
+	int i;
+
+	for (i = 0; i < Number; i ++)
+		if (Mask & (1ULL << i))
+			Dest[i] = Src[i];
+}
+
+// pipeline stage running on its own thread: trajectory and satellite parameter of following blocks
+// trajectory, power control and NextSatParam are only accessed by this thread once pipeline started
+void ParameterStage(CPipelineQueue *ParamQueue, SAT_PARAM_SET ParamSlot[])
+{
+	int Slot;
+
+	while (true)
+	{
+		Slot = ParamQueue->GetWriteSlot();
+		if (StepToNextBlock())
+			break;
+		CopySatParam(&ParamSlot[Slot], &NextSatParam);
+		ParamQueue->Push();
+	}
+	ParamQueue->Finish();
+}
+
+// pipeline stage running on its own thread: quantize IF blocks in order and pass to file writer
+void QuantizeStage(CPipelineQueue *BlockQueue, void *BlockBuffer[], CQuantizer *Quantizer, CIfFileWriter *IfWriter)
+{
+	int Slot;
+
+	while ((Slot = BlockQueue->GetReadSlot()) >= 0)
+	{
+		QuantizeIfBlock(BlockBuffer[Slot], Quantizer, IfWriter);
+		BlockQueue->Pop();
+	}
+}
+
+// quantize one block of IF samples into file writer buffer and update AGC
+void QuantizeIfBlock(void *Samples, CQuantizer *Quantizer, CIfFileWriter *IfWriter)
+{
+	switch (OutputParam.SampleType)
+	{
+	case SampleTypeFloat:
+		Quantizer->Quantize((float *)Samples, OutputParam.SampleFreq * OutputParam.BlockLength, IfWriter->GetBuffer());
+		break;
+	case SampleTypeInt16:
+		Quantizer->Quantize((short *)Samples, OutputParam.SampleFreq * OutputParam.BlockLength, IfWriter->GetBuffer());
+		break;
+	default:
+		Quantizer->Quantize((double *)Samples, OutputParam.SampleFreq * OutputParam.BlockLength, IfWriter->GetBuffer());
+		break;
+	}
+	IfWriter->Commit(Quantizer->GetOutputSize(OutputParam.SampleFreq * OutputParam.BlockLength));
+
+	// adjust gain every AGC_UPDATE_PERIOD ms
+	switch (Quantizer->UpdateAgc(OutputParam.BlockLength))
+	{
+	case -1: printf("[WARNING]\tAGC: Clipping %.2f%%, reducing gain to %.3f\n", Quantizer->GetClippingRate() * 100, Quantizer->GetGain()); break;
+	case 1: printf("[WARNING]\tAGC: Clipping %.2f%%, increasing gain to %.3f\n", Quantizer->GetClippingRate() * 100, Quantizer->GetGain()); break;
+	}
+}
+
+// generate IF data of BlockLength ms into Samples, including noise and signal of all channels
+// MsIndex is index of first ms in the block
+template <typename T> void GenerateIfBlock(T *Samples, int ThreadNumber, CSatIfSignal *SatIfSignal[], int ChannelNumber, int MsSampleNumber, int BlockLength, unsigned long long MsIndex)
+{
+	const int SampleNumber = MsSampleNumber * BlockLength;
+	int i, j;
+
+	// generate white noise of each ms, so noise does not depend on block length
+	// signal of channels accumulates on top of noise
+	for (i = 0; i < BlockLength; i ++)
+		NoiseGenerator.Generate(Samples + i * MsSampleNumber * 2, MsSampleNumber, MsIndex + i, 1.0);
+
+	// Use parallel or serial processing based on thread number
+	if (ThreadNumber > 1)
+	{
+		#ifdef _OPENMP
+		// Each channel first advances its state to this block, then the block is split into tiles of
+		// IF_TILE_SAMPLES samples dynamically taken by idle threads, each tile adds all channels in order,
+		// so all threads are busy regardless of channel number and result is the same as serial execution
+		const int TileNumber = (SampleNumber + IF_TILE_SAMPLES - 1) / IF_TILE_SAMPLES;
+
+		#pragma omp parallel num_threads(ThreadNumber) private(i, j)
+		{
+			#pragma omp for schedule(dynamic)
+			for (i = 0; i < ChannelNumber; i++)
+				SatIfSignal[i]->PrepareBlock(CurTime);
+			#pragma omp for schedule(dynamic)
+			for (j = 0; j < TileNumber; j++)
+			{
+				int Start = j * IF_TILE_SAMPLES, Count = (Start + IF_TILE_SAMPLES < SampleNumber) ? IF_TILE_SAMPLES : (SampleNumber - Start);
+
+				for (i = 0; i < ChannelNumber; i++)
+					SatIfSignal[i]->AccumulateIfRange(Samples, Start, Count);
+			}
+		}
+		#endif
+	}
+	else
+	{
+		// True serial execution - no OpenMP overhead, channels add to noise directly
+		for (i = 0; i < ChannelNumber; i++)
+			SatIfSignal[i]->AccumulateIfSample(CurTime, Samples);
+	}
+}
+
+// Pre-generate noise ring buffer of BufferSize MB and report repetition period
+// each output sample takes one of RingBufferLength samples with one of NOISE_PERMUTATION_NUMBER permutations,
+// so same buffer sample with same permutation reappears every RingBufferLength * NOISE_PERMUTATION_NUMBER samples on average
+void CreateNoiseBuffer(IfSampleType SampleType, int BufferSize, int SampleNumber)
+{
+	long long Size = (long long)BufferSize << 20, Length;
+	double BufferPeriod;
+
+	if (SampleType == SampleTypeFloat)
+		Length = NoiseGenerator.CreateRingBuffer<float>(Size, 1.0);
+	else if (SampleType == SampleTypeInt16)
+		Length = NoiseGenerator.CreateRingBuffer<short>(Size, 1.0);
+	else
+		Length = NoiseGenerator.CreateRingBuffer<double>(Size, 1.0);
+	if (Length == 0)
+	{
+		printf("[WARNING]\tFail to create %d MB noise buffer, generate noise directly\n", BufferSize);
+		return;
+	}
+	BufferPeriod = (double)Length / SampleNumber / 1000.;	// in second
+	printf("[INFO]\tNoise buffer: %d MB, %lld samples (%.3f s), effective repetition period %.3f s\n", BufferSize, Length, BufferPeriod, BufferPeriod * NOISE_PERMUTATION_NUMBER);
+}
+
+// Compare signal of all channels generated with SampleType against double precision (SampleNumber samples of one block)
+// Print SNR loss caused by the error (relative to unit sigma noise), channel state not changed
+void CheckSampleTypePrecision(IfSampleType SampleType, CSatIfSignal *SatIfSignal[], int ChannelNumber, int SampleNumber)
+{
+	GNSS_TIME NextTime = CurTime;
+	double ErrorPower = 0.0, SignalPower = 0.0, ChannelPower, NoiseError = 0.0, Value, SnrLoss;
+	double *NoiseReference = new double[SampleNumber * 2];
+	float *NoiseFloat = new float[SampleNumber * 2];
+	short *NoiseInt16 = new short[SampleNumber * 2];
+	int i;
+
+	NextTime.MilliSeconds += OutputParam.BlockLength;
+	for (i = 0; i < ChannelNumber; i ++)
+	{
+		if (SampleType == SampleTypeFloat)
+			ErrorPower += SatIfSignal[i]->GetSampleTypeError<float>(NextTime, ChannelPower);
+		else if (SampleType == SampleTypeInt16)
+			ErrorPower += SatIfSignal[i]->GetSampleTypeError<short>(NextTime, ChannelPower);
+		else
+			ErrorPower += SatIfSignal[i]->GetSampleTypeError<double>(NextTime, ChannelPower);
+		SignalPower += ChannelPower;
+	}
+	// error of noise representation
+	NoiseGenerator.Generate(NoiseReference, SampleNumber, 0, 1.0);
+	NoiseGenerator.Generate(NoiseFloat, SampleNumber, 0, 1.0);
+	NoiseGenerator.Generate(NoiseInt16, SampleNumber, 0, 1.0);
+	for (i = 0; i < SampleNumber * 2; i ++)
+	{
+		Value = (SampleType == SampleTypeFloat) ? NoiseFloat[i] - NoiseReference[i] : (SampleType == SampleTypeInt16) ? NoiseInt16[i] / (double)INT16_SAMPLE_SCALE - NoiseReference[i] : 0.0;
+		NoiseError += Value * Value;
+	}
+	delete[] NoiseReference;
+	delete[] NoiseFloat;
+	delete[] NoiseInt16;
+	ErrorPower /= SampleNumber * 2;
+	NoiseError /= SampleNumber * 2;
+	SnrLoss = 10 * log10(1.0 + ErrorPower + NoiseError);	// noise power is 1 for each of I/Q
+	printf("[INFO]\tPrecision check: signal power %.3e, signal error %.3e, noise error %.3e, SNR loss %.6f dB\n", SignalPower / (SampleNumber * 2), ErrorPower, NoiseError, SnrLoss);
+	if (SnrLoss > SAMPLE_TYPE_MAX_SNR_LOSS)
+		printf("[WARNING]\tSNR loss of sample type exceeds %.3f dB\n", SAMPLE_TYPE_MAX_SNR_LOSS);
+}
+
+// Compare throughput of vectorized quantizer against scalar reference for all sample types and output formats
+// input is unit sigma noise at gain 1.3 so that a few samples are clipped
+void QuantizerBenchmark(int SampleNumber)
 {
-	double fvalue1, fvalue2, mag;
+	printf("[INFO]\tQuantizer benchmark: %d blocks of %d samples\n", QUANT_BENCHMARK_BLOCKS, SampleNumber);
+	QuantizerBenchmark<double>("double", SampleNumber, QUANT_BENCHMARK_BLOCKS);
+	QuantizerBenchmark<float>("float", SampleNumber, QUANT_BENCHMARK_BLOCKS);
+	QuantizerBenchmark<short>("int16", SampleNumber, QUANT_BENCHMARK_BLOCKS);
+}
+
+template <typename T> void QuantizerBenchmark(const char *TypeName, int SampleNumber, int BlockNumber)
+{
+	const OutputFormat FormatList[4] = { OutputFormatIQ2, OutputFormatIQ4, OutputFormatIQ8, OutputFormatIQ16 };
+	const char *FormatName[4] = { "IQ2", "IQ4", "IQ8", "IQ16" };
+	T *Samples = new T[SampleNumber * 2];
+	unsigned char *QuantScalar = new unsigned char[SampleNumber * 4], *QuantVector = new unsigned char[SampleNumber * 4];
+	int i, j, ClippedScalar, ClippedVector, Length;
+	double TimeScalar, TimeVector;
+
+	NoiseGenerator.Generate(Samples, SampleNumber, 0, 1.0);
+	for (i = 0; i < 4; i ++)
+	{
+		CQuantizer Quantizer(FormatList[i]);
+
+		Length = Quantizer.GetOutputSize(SampleNumber);
+		auto Start = std::chrono::high_resolution_clock::now();
+		for (j = 0, ClippedScalar = 0; j < BlockNumber; j ++)
+			ClippedScalar += CQuantizer::QuantizeBlockScalar(Samples, SampleNumber, QuantScalar, 1.3, FormatList[i]);
+		auto Middle = std::chrono::high_resolution_clock::now();
+		for (j = 0, ClippedVector = 0; j < BlockNumber; j ++)
+			ClippedVector += CQuantizer::QuantizeBlock(Samples, SampleNumber, QuantVector, 1.3, FormatList[i]);
+		auto End = std::chrono::high_resolution_clock::now();
+		TimeScalar = std::chrono::duration<double>(Middle - Start).count();
+		TimeVector = std::chrono::duration<double>(End - Middle).count();
+		printf("[INFO]\t%-6s %-4s scalar %8.1f Msps, vector %8.1f Msps, speedup %5.2f, %s\n", TypeName, FormatName[i],
+			(double)SampleNumber * BlockNumber / TimeScalar / 1e6, (double)SampleNumber * BlockNumber / TimeVector / 1e6, TimeScalar / TimeVector,
+			(ClippedScalar == ClippedVector && memcmp(QuantScalar, QuantVector, Length) == 0) ? "output match" : "OUTPUT MISMATCH");
+	}
+	delete[] Samples;
+	delete[] QuantScalar;
+	delete[] QuantVector;
+}
+
+// compare table driven LDPC encoders against reference encoders and measure encode time of both
+// return false if any encoded vector or frame differs
+bool VerifyLDPCEncode()
+{
+	static BCNav1Bit BCNav1;	// static as encode tables too large for stack
+	static BCNav2Bit BCNav2;
+	static BCNav3Bit BCNav3;
+	static CNav2Bit CNav2;
+	bool Pass;
+
+	printf("[INFO]\tLDPC encoder verification: %d random vectors for each code, %d frames for each svid\n", LDPC_VERIFY_VECTORS, LDPC_VERIFY_FRAMES);
+	Pass = VerifyLDPCEncode("BCNAV1", &BCNav1, 18000);
+	Pass = VerifyLDPCEncode("BCNAV2", &BCNav2, 3000) && Pass;
+	Pass = VerifyLDPCEncode("BCNAV3", &BCNav3, 1000) && Pass;
+	Pass = VerifyLDPCEncode("CNAV2", &CNav2) && Pass;
+	return Pass;
+}
+
+bool VerifyLDPCEncode(const char *NavName, BCNavBit *Nav, int FrameLength)
+{
+	int *TableSymbols = new int[LDPC_VERIFY_VECTORS * LDPC_MAX_SYMBOL * 2], *ReferenceSymbols = new int[LDPC_VERIFY_VECTORS * LDPC_MAX_SYMBOL * 2];
+	const char *MatrixGen;
+	const unsigned long long *Table;
+	int i, j, Index, SymbolLength, Mismatch, FrameCompared;
+	double TimeReference, TimeTable;
+	GNSS_TIME StartTime;
+	bool Pass = true;
+
+	srand(1);
+	for (Index = 0; (SymbolLength = Nav->GetLDPCCode(Index, MatrixGen, Table)) > 0; Index ++)
+	{
+		for (i = 0; i < LDPC_VERIFY_VECTORS; i ++)
+			for (j = 0; j < SymbolLength; j ++)
+				TableSymbols[i * SymbolLength * 2 + j] = ReferenceSymbols[i * SymbolLength * 2 + j] = (i == 0) ? 0 : (i <= SymbolLength) ? ((j == i - 1) ? 1 : 0) : (rand() & 0x3f);
+		auto Start = std::chrono::high_resolution_clock::now();
+		for (j = 0; j < LDPC_VERIFY_ROUNDS; j ++)
+			for (i = 0; i < LDPC_VERIFY_VECTORS; i ++)
+				Nav->LDPCEncodeReference(ReferenceSymbols + i * SymbolLength * 2, SymbolLength, MatrixGen);
+		auto Middle = std::chrono::high_resolution_clock::now();
+		for (j = 0; j < LDPC_VERIFY_ROUNDS; j ++)
+			for (i = 0; i < LDPC_VERIFY_VECTORS; i ++)
+				Nav->LDPCEncode(TableSymbols + i * SymbolLength * 2, SymbolLength, Table);
+		auto End = std::chrono::high_resolution_clock::now();
+		TimeReference = std::chrono::duration<double>(Middle - Start).count() * 1e6 / LDPC_VERIFY_ROUNDS / LDPC_VERIFY_VECTORS;
+		TimeTable = std::chrono::duration<double>(End - Middle).count() * 1e6 / LDPC_VERIFY_ROUNDS / LDPC_VERIFY_VECTORS;
+		for (i = 0, Mismatch = 0; i < LDPC_VERIFY_VECTORS; i ++)
+			if (memcmp(TableSymbols + i * SymbolLength * 2, ReferenceSymbols + i * SymbolLength * 2, SymbolLength * 2 * sizeof(int)) != 0)
+				Mismatch ++;
+		printf("[INFO]\t%-6s LDPC(%d,%d) reference %8.2f us, table %8.2f us, speedup %6.2f, %d mismatch\n", NavName, SymbolLength * 2, SymbolLength,
+			TimeReference, TimeTable, TimeReference / TimeTable, Mismatch);
+		Pass = Pass && (Mismatch == 0);
+	}
+
+	StartTime.Week = 2300;
+	StartTime.MilliSeconds = 0;
+	StartTime.SubMilliSeconds = 0.0;
+	Mismatch = Nav->VerifyLDPC(StartTime, FrameLength, LDPC_VERIFY_FRAMES, FrameCompared);
+	printf("[INFO]\t%-6s %d frames of svid 1~63 compared, %d mismatch\n", NavName, FrameCompared, Mismatch);
+	delete[] TableSymbols;
+	delete[] ReferenceSymbols;
+	return Pass && (Mismatch == 0);
+}
+
+// CNAV-2 subframe 2 and 3 use binary LDPC code with information bits packed MSB first in DWORDs
+bool VerifyLDPCEncode(const char *NavName, CNav2Bit *Nav)
+{
+	unsigned int *Streams = new unsigned int[LDPC_VERIFY_VECTORS * 19];
+	int ReferenceBits[L1C_SUBFRAME2_SYMBOL_LENGTH * 2];
+	unsigned long long TableWords[NAV_FRAME_WORDS(L1C_SUBFRAME2_SYMBOL_LENGTH * 2)], ReferenceWords[NAV_FRAME_WORDS(L1C_SUBFRAME2_SYMBOL_LENGTH * 2)];
+	const unsigned int *MatrixGen;
+	const unsigned long long *Table;
+	int i, j, Index, SymbolLength, TableSize, Mismatch, SubframeCompared;
+	double TimeReference, TimeTable;
+	GNSS_TIME StartTime;
+	bool Pass = true;
+
+	srand(1);
+	for (Index = 0; (SymbolLength = Nav->GetLDPCCode(Index, MatrixGen, Table, TableSize)) > 0; Index ++)
+	{
+		for (i = 0; i < LDPC_VERIFY_VECTORS; i ++)
+			for (j = 0; j < TableSize; j ++)
+				Streams[i * TableSize + j] = (i == 0) ? 0 : (i <= SymbolLength) ? (((i - 1) >> 5) == j ? (0x80000000u >> ((i - 1) & 0x1f)) : 0) : (((unsigned int)rand() << 16) ^ (unsigned int)rand());
+		auto Start = std::chrono::high_resolution_clock::now();
+		for (j = 0; j < LDPC_VERIFY_ROUNDS; j ++)
+			for (i = 0; i < LDPC_VERIFY_VECTORS; i ++)
+				Nav->LDPCEncodeReference(Streams + i * TableSize, ReferenceBits, SymbolLength, TableSize, MatrixGen);
+		auto Middle = std::chrono::high_resolution_clock::now();
+		for (j = 0; j < LDPC_VERIFY_ROUNDS; j ++)
+			for (i = 0; i < LDPC_VERIFY_VECTORS; i ++)
+			{
+				memset(TableWords, 0, sizeof(TableWords));
+				Nav->LDPCEncode(Streams + i * TableSize, TableWords, 0, SymbolLength, TableSize, Table);
+			}
+		auto End = std::chrono::high_resolution_clock::now();
+		TimeReference = std::chrono::duration<double>(Middle - Start).count() * 1e6 / LDPC_VERIFY_ROUNDS / LDPC_VERIFY_VECTORS;
+		TimeTable = std::chrono::duration<double>(End - Middle).count() * 1e6 / LDPC_VERIFY_ROUNDS / LDPC_VERIFY_VECTORS;
+		for (i = 0, Mismatch = 0; i < LDPC_VERIFY_VECTORS; i ++)
+		{
+			Nav->LDPCEncodeReference(Streams + i * TableSize, ReferenceBits, SymbolLength, TableSize, MatrixGen);
+			memset(TableWords, 0, sizeof(TableWords));
+			Nav->LDPCEncode(Streams + i * TableSize, TableWords, 0, SymbolLength, TableSize, Table);
+			NavBit::PackBits(ReferenceBits, SymbolLength * 2, ReferenceWords);
+			if (memcmp(TableWords, ReferenceWords, NAV_FRAME_WORDS(SymbolLength * 2) * sizeof(unsigned long long)) != 0)
+				Mismatch ++;
+		}
+		printf("[INFO]\t%-6s LDPC(%d,%d) reference %8.2f us, table %8.2f us, speedup %6.2f, %d mismatch\n", NavName, SymbolLength * 2, SymbolLength,
+			TimeReference, TimeTable, TimeReference / TimeTable, Mismatch);
+		Pass = Pass && (Mismatch == 0);
+	}
+
+	StartTime.Week = 2300;
+	StartTime.MilliSeconds = 0;
+	StartTime.SubMilliSeconds = 0.0;
+	Mismatch = Nav->VerifyLDPC(StartTime, LDPC_VERIFY_FRAMES, SubframeCompared);
+	printf("[INFO]\t%-6s %d subframe 2/3 of PRN 1~63 compared, %d mismatch\n", NavName, SubframeCompared, Mismatch);
+	delete[] Streams;
+	return Pass && (Mismatch == 0);
+}
+
+// evaluate all valid ephemeris at EPH_VERIFY_EPOCHS epochs around Time with GpsSatPosSpeedEph() and GpsSatPosSpeedBatch()
+// print maximum difference and time of both method, return false if position difference exceeds EPH_VERIFY_TOLERANCE
+bool VerifyEphemerisBatch(const char *SystemName, GnssSystem System, PGPS_EPHEMERIS Eph[], int Number, double Time)
+{
+	PGPS_EPHEMERIS ValidEph[EPH_BATCH_SIZE];
+	KINEMATIC_INFO PosVelScalar[EPH_BATCH_SIZE], PosVelBatch[EPH_BATCH_SIZE];
+	double EpochTime[EPH_BATCH_SIZE], PosDiff = 0.0, VelDiff = 0.0, TimeScalar = 0.0, TimeBatch = 0.0;
+	EPHEMERIS_BATCH Batch;
+	int i, j, k, SatNumber = 0;
+
+	for (i = 0; i < Number && SatNumber < EPH_BATCH_SIZE; i ++)
+		if (Eph[i] && (Eph[i]->valid & 1))
+			ValidEph[SatNumber ++] = Eph[i];
+	if (SatNumber == 0)
+		return true;
+	SetEphemerisBatch(System, ValidEph, SatNumber, &Batch);
+	for (k = 0; k < EPH_VERIFY_EPOCHS; k ++)
+	{
+		for (i = 0; i < SatNumber; i ++)
+			EpochTime[i] = Time + (k - EPH_VERIFY_EPOCHS / 2);
+		auto Start = std::chrono::high_resolution_clock::now();
+		for (i = 0; i < SatNumber; i ++)
+			GpsSatPosSpeedEph(System, EpochTime[i], ValidEph[i], &PosVelScalar[i], NULL);
+		auto Middle = std::chrono::high_resolution_clock::now();
+		GpsSatPosSpeedBatch(&Batch, EpochTime, PosVelBatch);
+		auto End = std::chrono::high_resolution_clock::now();
+		TimeScalar += std::chrono::duration<double>(Middle - Start).count();
+		TimeBatch += std::chrono::duration<double>(End - Middle).count();
+		for (i = 0; i < SatNumber; i ++)
+			for (j = 0; j < 3; j ++)
+			{
+				PosDiff = std::max(PosDiff, fabs(PosVelScalar[i].PosVel[j] - PosVelBatch[i].PosVel[j]));
+				VelDiff = std::max(VelDiff, fabs(PosVelScalar[i].PosVel[j+3] - PosVelBatch[i].PosVel[j+3]));
+			}
+	}
+	printf("[INFO]\t%-7s %2d satellites, scalar %6.1f ns, batch %6.1f ns per satellite, max difference %.2e m %.2e m/s, %s\n", SystemName, SatNumber,
+		TimeScalar / EPH_VERIFY_EPOCHS / SatNumber * 1e9, TimeBatch / EPH_VERIFY_EPOCHS / SatNumber * 1e9, PosDiff, VelDiff,
+		(PosDiff <= EPH_VERIFY_TOLERANCE) ? "match" : "MISMATCH");
+	return PosDiff <= EPH_VERIFY_TOLERANCE;
+}
 
-	// Marsaglia Polar method (improved Box-Muller method)
-    do
+// step trajectory through whole scenario in 1ms steps and calculate satellite parameters of GPS/BDS/Galileo
+// both with orbit interpolation and exact evaluation, and of GLONASS both with integration from tb and dense output
+// print maximum difference and time of both method, return false if range difference exceeds ORBIT_VERIFY_TOLERANCE
+bool VerifyOrbitInterp(GNSS_TIME CurTime, KINEMATIC_INFO CurPos, PIONO_PARAM IonoParam, int DurationMs)
+{
+	static SAT_PARAM_SET ExactParam, InterpParam;
+	LLA_POSITION PosLLA;
+	double MaxDiff[3] = { 0.0, 0.0, 0.0 }, TimeExact = 0.0, TimeInterp = 0.0;
+	double GloMaxDiff[3] = { 0.0, 0.0, 0.0 }, GloTimeExact = 0.0, GloTimeInterp = 0.0;
+	bool Match = true;
+	int i, index, Ms;
+
+	if (OutputParam.OrbitInterpWindow == 0)
+		printf("[WARNING]\tOrbit interpolation disabled, only GLONASS dense output verified\n");
+	for (Ms = 0; Ms < DurationMs; Ms ++)
 	{
-        fvalue1 = 2.0 * ((double)rand() / RAND_MAX) - 1.0;
-        fvalue2 = 2.0 * ((double)rand() / RAND_MAX) - 1.0;
-        mag = fvalue1 * fvalue1 + fvalue2 * fvalue2;
-    } while (mag >= 1.0 || mag == 0.0);
-	mag = sqrt(-2.0 * log(mag) / mag) * Sigma;
+		PosLLA = EcefToLla(CurPos);
+		if (OutputParam.OrbitInterpWindow > 0)
+		{
+			auto Start = std::chrono::high_resolution_clock::now();
+			GetSatelliteParamBatch(CurPos, PosLLA, CurTime, GpsSystem, GpsEphVisible, GpsSatNumber, IonoParam, ExactParam.GpsSatParam);
+			GetSatelliteParamBatch(CurPos, PosLLA, CurTime, BdsSystem, BdsEphVisible, BdsSatNumber, IonoParam, ExactParam.BdsSatParam);
+			GetSatelliteParamBatch(CurPos, PosLLA, CurTime, GalileoSystem, GalEphVisible, GalSatNumber, IonoParam, ExactParam.GalSatParam);
+			auto Middle = std::chrono::high_resolution_clock::now();
+			GetSatelliteParamInterp(CurPos, PosLLA, CurTime, GpsSystem, GpsEphVisible, GpsSatNumber, IonoParam, OutputParam.OrbitInterpWindow, GpsOrbitInterp, InterpParam.GpsSatParam);
+			GetSatelliteParamInterp(CurPos, PosLLA, CurTime, BdsSystem, BdsEphVisible, BdsSatNumber, IonoParam, OutputParam.OrbitInterpWindow, BdsOrbitInterp, InterpParam.BdsSatParam);
+			GetSatelliteParamInterp(CurPos, PosLLA, CurTime, GalileoSystem, GalEphVisible, GalSatNumber, IonoParam, OutputParam.OrbitInterpWindow, GalOrbitInterp, InterpParam.GalSatParam);
+			auto End = std::chrono::high_resolution_clock::now();
+			TimeExact += std::chrono::duration<double>(Middle - Start).count();
+			TimeInterp += std::chrono::duration<double>(End - Middle).count();
+			CompareSatParam(GpsSatNumber, GpsEphVisible, ExactParam.GpsSatParam, InterpParam.GpsSatParam, MaxDiff);
+			CompareSatParam(BdsSatNumber, BdsEphVisible, ExactParam.BdsSatParam, InterpParam.BdsSatParam, MaxDiff);
+			CompareSatParam(GalSatNumber, GalEphVisible, ExactParam.GalSatParam, InterpParam.GalSatParam, MaxDiff);
+		}
+		if (GloSatNumber > 0)
+		{
+			auto Start = std::chrono::high_resolution_clock::now();
+			for (i = 0; i < GloSatNumber; i ++)
+				GetSatelliteParam(CurPos, PosLLA, CurTime, GlonassSystem, (PGPS_EPHEMERIS)GloEphVisible[i], IonoParam, &ExactParam.GloSatParam[GloEphVisible[i]->n - 1]);
+			auto Middle = std::chrono::high_resolution_clock::now();
+			for (i = 0; i < GloSatNumber; i ++)
+			{
+				index = GloEphVisible[i]->n - 1;
+				GetSatelliteParam(CurPos, PosLLA, CurTime, GlonassSystem, (PGPS_EPHEMERIS)GloEphVisible[i], IonoParam, &InterpParam.GloSatParam[index], &GloOrbit[index]);
+			}
+			auto End = std::chrono::high_resolution_clock::now();
+			GloTimeExact += std::chrono::duration<double>(Middle - Start).count();
+			GloTimeInterp += std::chrono::duration<double>(End - Middle).count();
+			for (i = 0; i < GloSatNumber; i ++)
+			{
+				index = GloEphVisible[i]->n - 1;
+				GloMaxDiff[0] = std::max(GloMaxDiff[0], fabs(ExactParam.GloSatParam[index].TravelTime - InterpParam.GloSatParam[index].TravelTime) * LIGHT_SPEED);
+				GloMaxDiff[1] = std::max(GloMaxDiff[1], fabs(ExactParam.GloSatParam[index].IonoDelay - InterpParam.GloSatParam[index].IonoDelay));
+				GloMaxDiff[2] = std::max(GloMaxDiff[2], fabs(ExactParam.GloSatParam[index].RelativeSpeed - InterpParam.GloSatParam[index].RelativeSpeed));
+			}
+		}
+		if (!Trajectory.GetNextPosVelECEF(0.001, CurPos))
+			break;
+		if (++ CurTime.MilliSeconds >= 604800000)
+		{
+			CurTime.Week ++;
+			CurTime.MilliSeconds -= 604800000;
+		}
+	}
+	if (Ms == 0)
+		return true;
+	if (OutputParam.OrbitInterpWindow > 0)
+	{
+		printf("[INFO]\tOrbit interpolation over %d s window, %d ms checked, exact %.2f us, interpolation %.2f us per ms\n", OutputParam.OrbitInterpWindow, Ms,
+			TimeExact / Ms * 1e6, TimeInterp / Ms * 1e6);
+		printf("[INFO]\tMaximum difference: range %.2e m, ionosphere delay %.2e m, relative speed %.2e m/s, %s\n", MaxDiff[0], MaxDiff[1], MaxDiff[2],
+			(MaxDiff[0] <= ORBIT_VERIFY_TOLERANCE) ? "match" : "MISMATCH");
+		Match = Match && (MaxDiff[0] <= ORBIT_VERIFY_TOLERANCE);
+	}
+	if (GloSatNumber > 0)
+	{
+		printf("[INFO]\tGLONASS dense output of %d satellites, %d ms checked, integration %.2f us, dense output %.2f us per ms\n", GloSatNumber, Ms,
+			GloTimeExact / Ms * 1e6, GloTimeInterp / Ms * 1e6);
+		printf("[INFO]\tMaximum difference: range %.2e m, ionosphere delay %.2e m, relative speed %.2e m/s, %s\n", GloMaxDiff[0], GloMaxDiff[1], GloMaxDiff[2],
+			(GloMaxDiff[0] <= ORBIT_VERIFY_TOLERANCE) ? "match" : "MISMATCH");
+		Match = Match && (GloMaxDiff[0] <= ORBIT_VERIFY_TOLERANCE);
+	}
+	return Match;
+}
 
-	return complex_number(fvalue1 * mag, fvalue2 * mag);
+// update maximum difference of range, ionosphere delay and relative speed between parameters of visible satellites
+void CompareSatParam(int SatNumber, PGPS_EPHEMERIS EphVisible[], SATELLITE_PARAM ExactParam[], SATELLITE_PARAM InterpParam[], double MaxDiff[3])
+{
+	int i, index;
+
+	for (i = 0; i < SatNumber; i ++)
+	{
+		index = EphVisible[i]->svid - 1;
+		MaxDiff[0] = std::max(MaxDiff[0], fabs(ExactParam[index].TravelTime - InterpParam[index].TravelTime) * LIGHT_SPEED);
+		MaxDiff[1] = std::max(MaxDiff[1], fabs(ExactParam[index].IonoDelay - InterpParam[index].IonoDelay));
+		MaxDiff[2] = std::max(MaxDiff[2], fabs(ExactParam[index].RelativeSpeed - InterpParam[index].RelativeSpeed));
+	}
+}
+
+// retire channels of satellites set and add channels of satellites risen according to visibility at SatParam.Time
+// remaining channels keep their order and state, added channels start with satellite parameter at SatParam.Time
+int UpdateChannelList(CChannelPool *ChannelPool, CSatIfSignal *SatIfSignal[], int ChannelNumber, unsigned long long ChannelMask[], NavBit *NavBitArray[])
+{
+	unsigned long long Retired, Added;
+	int System, Index, i, Count;
+
+	for (System = GpsSystem; System <= GlonassSystem; System ++)
+	{
+		Retired = ChannelMask[System] & ~SatParam.VisibleMask[System];
+		Added = SatParam.VisibleMask[System] & ~ChannelMask[System];
+		ChannelMask[System] = SatParam.VisibleMask[System];
+		if (Retired)
+		{
+			for (i = Count = 0; i < ChannelNumber; i ++)
+			{
+				if (SatIfSignal[i]->GetSystem() == System && (Retired & (1ULL << (SatIfSignal[i]->GetSvid() - 1))))
+					ChannelPool->ReleaseChannel(SatIfSignal[i]);
+				else
+					SatIfSignal[Count ++] = SatIfSignal[i];
+			}
+			for (i = Count; i < ChannelNumber; i ++)
+				SatIfSignal[i] = NULL;
+			ChannelNumber = Count;
+			for (; Retired; Retired &= Retired - 1)
+				ChannelRetireCount ++;
+		}
+		for (Index = 0; Added; Index ++, Added >>= 1)
+		{
+			if (Added & 1)
+			{
+				ChannelNumber = AddSatelliteChannel(ChannelPool, SatIfSignal, ChannelNumber, (GnssSystem)System, Index, NavBitArray);
+				ChannelAddCount ++;
+			}
+		}
+	}
+	return ChannelNumber;
+}
+
+// add channels of all selected signals of satellite with svid Index+1, channels exceeding TOTAL_SAT_CHANNEL skipped
+int AddSatelliteChannel(CChannelPool *ChannelPool, CSatIfSignal *SatIfSignal[], int ChannelNumber, GnssSystem System, int Index, NavBit *NavBitArray[])
+{
+	PSATELLITE_PARAM Param;
+	int SignalIndex, IfFreq;
+
+	Param = (System == GpsSystem) ? &SatParam.GpsSatParam[Index] : (System == BdsSystem) ? &SatParam.BdsSatParam[Index] :
+		(System == GalileoSystem) ? &SatParam.GalSatParam[Index] : &SatParam.GloSatParam[Index];
+	for (SignalIndex = 0; SignalIndex <= SignalLastIndex[System] && ChannelNumber < TOTAL_SAT_CHANNEL; SignalIndex ++)
+	{
+		if (!(OutputParam.FreqSelect[System] & (1 << SignalIndex)))
+			continue;
+		IfFreq = SignalCenterFreq[System][SignalIndex] - OutputParam.CenterFreq * 1000;
+		if (System == GlonassSystem)
+			IfFreq += (SignalIndex == SIGNAL_INDEX_G1) ? Param->FreqID * 562500 : Param->FreqID * 437500;	// GloEph may be switched by parameter stage
+		SatIfSignal[ChannelNumber] = ChannelPool->GetChannel(IfFreq, System, SignalIndex, Index + 1);
+		SatIfSignal[ChannelNumber]->InitState(CurTime, Param, GetNavData(System, SignalIndex, NavBitArray));
+		ChannelNumber ++;
+	}
+	return ChannelNumber;
 }
 
 NavBit* GetNavData(GnssSystem SatSystem, int SatSignalIndex, NavBit* NavBitArray[])
@@ -901,160 +1627,6 @@ NavBit* GetNavData(GnssSystem SatSystem, int SatSignalIndex, NavBit* NavBitArray
 	}
 }
 
-// PocketSDR compatible 2-bit IQ quantization 
-// (TODO: Test)
-// (FIXME: Optimize)
- int QuantSamplesIQ2(complex_number Samples[], int Length, unsigned char QuantSamples[], double GainScale)
- {
-	int ClippedCount = 0;
-	const double threshold = 1.1 / GainScale;	// the optimal threshold for Gauss noise is Sigma, increase a little to compensate added signal power
-	const double ClippedThreshold = 5 * threshold;	// clip threshold set to 5 Sigma
-	double Value;
-	unsigned char QuantByte;
-
-     // Process 2 complex samples at a time to produce 1 byte of output.
-     // Bit definition within each byte is (from MSB): Sign-Q2, Mag-Q2, Sign-I2, Mag-I2, Sign-Q1, Mag-Q1, Sign-I1, Mag-I1
-    for (int i = 0; i < Length; i += 2)
-    {
-		QuantByte = (Samples[i].real < 0.0) ? 2 : 0;
-		Value = fabs(Samples[i].real);
-		QuantByte |= (Value < threshold) ? 0 : 1;
-		if (Value >= ClippedThreshold) ClippedCount ++;
-		QuantByte |= (Samples[i].imag < 0.0) ? 8 : 0;
-		Value = fabs(Samples[i].imag);
-		QuantByte |= (Value < threshold) ? 0 : 4;
-		if (Value >= ClippedThreshold) ClippedCount ++;
-
-		QuantByte = (Samples[i+1].real < 0.0) ? 0x20 : 0;
-		Value = fabs(Samples[i+1].real);
-		QuantByte |= (Value < threshold) ? 0 : 0x10;
-		if (Value >= ClippedThreshold) ClippedCount ++;
-		QuantByte |= (Samples[i+1].imag < 0.0) ? 0x80 : 0;
-		Value = fabs(Samples[i+1].imag);
-		QuantByte |= (Value < threshold) ? 0 : 0x40;
-		if (Value >= ClippedThreshold) ClippedCount ++;
-	}
-
-	return ClippedCount;
-}
-
-int QuantSamplesIQ4(complex_number Samples[], int Length, unsigned char QuantSamples[], double GainScale)
-{
-	int i;
-	double Value;
-	unsigned char QuantValue, QuantSample;
-	const double Gain = GainScale * 3.0;
-	int ClippedCount = 0;
-
-	for (i = 0; i < Length; i++)
-	{
-		Value = fabs(Samples[i].real);
-		QuantValue = (int)(Value * Gain);	// optimal quantization for sigma=1 noise
-		if (QuantValue > 7)
-		{
-			QuantValue = 7;
-			ClippedCount ++;
-		}
-		QuantValue += ((Samples[i].real >= 0) ? 0 : (1 << 3));	// add sign bit as MSB
-		QuantSample = QuantValue << 4;
-		Value = fabs(Samples[i].imag);
-		QuantValue = (int)(Value * Gain);	// optimal quantization for sigma=1 noise
-		if (QuantValue > 7)
-		{
-			QuantValue = 7;
-			ClippedCount ++;
-		}
-		QuantValue += ((Samples[i].imag >= 0) ? 0 : (1 << 3));	// add sign bit as MSB
-		QuantSample |= QuantValue;
-		QuantSamples[i] = QuantSample;
-	}
-
-	return ClippedCount;
-}
-
-int QuantSamplesIQ8(complex_number Samples[], int Length, unsigned char QuantSamples[], double GainScale)
-{
-	int i;
-	int QuantValue;
-	const double Gain = GainScale * 25.0;
-	int ClippedCount = 0;
-
-	for (i = 0; i < Length; i++)
-	{
-		QuantValue = (int)(Samples[i].real * Gain);	// sigma scaled at 25 -> +-5 sigma scaled within range of INT8
-		if (QuantValue > 127)	// saturate at -128~127
-		{
-			QuantValue = 127;
-			ClippedCount ++;
-		}
-		else if (QuantValue < -128)
-		{
-			QuantValue = -128;
-			ClippedCount ++;
-		}
-		QuantSamples[i * 2] = (unsigned char)(QuantValue & 0xff);
-		QuantValue = (int)(Samples[i].imag * Gain);	// sigma scaled at 25 -> +-5 sigma scaled within range of INT8
-		if (QuantValue > 127)	// saturate at -128~127
-		{
-			QuantValue = 127;
-			ClippedCount ++;
-		}
-		else if (QuantValue < -128)
-		{
-			QuantValue = -128;
-			ClippedCount ++;
-		}
-		QuantSamples[i * 2 + 1] = (unsigned char)(QuantValue & 0xff);
-	}
-
-	return ClippedCount;
-}
-
-int QuantSamplesIQ16(complex_number Samples[], int Length, unsigned char QuantSamples[], double GainScale)
-{
-    int i;
-    int QuantValue;
-    
-    const double Gain = GainScale * 3277;
-    int ClippedCount = 0;
-
-    for (i = 0; i < Length; i++)
-    {
-        QuantValue = (int)(Samples[i].real * Gain);  
-        if (QuantValue > 32767)  
-        {
-            QuantValue = 32767;
-            ClippedCount++;
-        }
-        else if (QuantValue < -32768)
-        {
-            QuantValue = -32768;
-            ClippedCount++;
-        }
-    
-        QuantSamples[i * 4] = (unsigned char)(QuantValue & 0xff);       
-        QuantSamples[i * 4 + 1] = (unsigned char)((QuantValue >> 8) & 0xff);  
-
-      
-        QuantValue = (int)(Samples[i].imag * Gain);  
-        if (QuantValue > 32767)  
-        {
-            QuantValue = 32767;
-            ClippedCount++;
-        }
-        else if (QuantValue < -32768)
-        {
-            QuantValue = -32768;
-            ClippedCount++;
-        }
-      
-        QuantSamples[i * 4 + 2] = (unsigned char)(QuantValue & 0xff);        
-        QuantSamples[i * 4 + 3] = (unsigned char)((QuantValue >> 8) & 0xff);  
-    }
-
-    return ClippedCount;
-}
-
 void ShowHelp(const char* ProgramPath)
 {
 	// Extract just the executable name from the path
@@ -1075,6 +1647,17 @@ void ShowHelp(const char* ProgramPath)
 	std::cout << "   -mt, 	--multi-thread     Force use multi-thread\n";
 	std::cout << "   -st, 	--single-thread    Force use single-thread\n";
 	std::cout << "   -t,  	--tag              Output tag file (output file name with .tag appended)\n";
+	std::cout << "   -sp, 	--sample-type <T>  IF sample type double/float/int16 (overrides config)\n";
+	std::cout << "   -pc, 	--precision-check  Print SNR loss of sample type against double before generation\n";
+	std::cout << "   -sd, 	--seed <N>         Noise seed (overrides config), same seed gives identical output\n";
+	std::cout << "   -qb, 	--quant-bench      Run quantizer benchmark (vectorized against scalar) and exit\n";
+	std::cout << "   -dio,	--direct-io        Write IF file with O_DIRECT (Linux only, bypass page cache)\n";
+	std::cout << "   -bl, 	--block-length <N> Generation block length in ms 1/2/4/5/10/20 (overrides config)\n";
+	std::cout << "   -vp, 	--verify-prn       Verify compile time PRN code tables against run time generation and exit\n";
+	std::cout << "   -ve, 	--verify-eph       Verify batch satellite position calculation against scalar calculation and exit\n";
+	std::cout << "   -oi, 	--orbit-interp <S> Satellite orbit interpolation window in second 10~600, 0 for exact evaluation (overrides config)\n";
+	std::cout << "   -vi, 	--verify-interp    Verify orbit interpolation and GLONASS dense output against exact evaluation along trajectory and exit\n";
+	std::cout << "   -vl, 	--verify-ldpc      Verify table driven LDPC encoders against reference encoders with encode time and exit\n";
 	std::cout << "   -v, 	--version          Show version information\n";
 	std::cout << "   -h, 	--help             Show this help message\n\n";
 	std::cout << "Examples:\n";
@@ -1094,7 +1677,19 @@ bool ParseCommandLineArgs(int argc, char* argv[], CommandArguments &Arguments)
 		"--multi-thread", "-mt",	// 4
 		"--single-thread", "-st",	// 5
 		"--tag", "-t",	// 6
+		"--sample-type", "-sp",	// 7
+		"--precision-check", "-pc",	// 8
+		"--seed", "-sd",	// 9
+		"--quant-bench", "-qb",	// 10
+		"--direct-io", "-dio",	// 11
+		"--block-length", "-bl",	// 12
+		"--verify-prn", "-vp",	// 13
+		"--verify-eph", "-ve",	// 14
+		"--orbit-interp", "-oi",	// 15
+		"--verify-interp", "-vi",	// 16
+		"--verify-ldpc", "-vl",	// 17
 	};
+	const std::vector<std::string> SampleTypeList = { "double", "float", "int16" };
 	std::string arg;
 	int i = 1, index;
 
@@ -1137,6 +1732,59 @@ bool ParseCommandLineArgs(int argc, char* argv[], CommandArguments &Arguments)
 		case 6:	// --tag
 			Arguments.OutputTag = true;
 			break;
+		case 7:	// --sample-type
+			if (i + 1 >= argc || std::find(SampleTypeList.begin(), SampleTypeList.end(), argv[i+1]) == SampleTypeList.end())
+			{
+				std::cerr << "[ERROR] " << arg << " requires double, float or int16\n";
+				return false;
+			}
+			Arguments.SampleType = (int)(std::find(SampleTypeList.begin(), SampleTypeList.end(), argv[++i]) - SampleTypeList.begin());
+			break;
+		case 8:	// --precision-check
+			Arguments.PrecisionCheck = true;
+			break;
+		case 9:	// --seed
+			if (i + 1 >= argc || argv[i+1][0] < '0' || argv[i+1][0] > '9')
+			{
+				std::cerr << "[ERROR] " << arg << " requires a non-negative integer\n";
+				return false;
+			}
+			Arguments.NoiseSeed = strtoul(argv[++i], NULL, 0) & 0xffffffff;
+			break;
+		case 10:	// --quant-bench
+			Arguments.QuantBenchmark = true;
+			break;
+		case 11:	// --direct-io
+			Arguments.DirectIo = true;
+			break;
+		case 12:	// --block-length
+			if (i + 1 >= argc || argv[i+1][0] < '1' || argv[i+1][0] > '9')
+			{
+				std::cerr << "[ERROR] " << arg << " requires a positive integer\n";
+				return false;
+			}
+			Arguments.BlockLength = atoi(argv[++i]);
+			break;
+		case 13:	// --verify-prn
+			Arguments.VerifyPrn = true;
+			break;
+		case 14:	// --verify-eph
+			Arguments.VerifyEph = true;
+			break;
+		case 15:	// --orbit-interp
+			if (i + 1 >= argc || argv[i+1][0] < '0' || argv[i+1][0] > '9')
+			{
+				std::cerr << "[ERROR] " << arg << " requires a non-negative integer\n";
+				return false;
+			}
+			Arguments.OrbitInterpWindow = atoi(argv[++i]);
+			break;
+		case 16:	// --verify-interp
+			Arguments.VerifyInterp = true;
+			break;
+		case 17:	// --verify-ldpc
+			Arguments.VerifyLdpc = true;
+			break;
 		default:
 			std::cout << "[WARNING] Unknown option " << arg << "\n";
 		}
@@ -20,13 +20,15 @@ public:
 	BCNav1Bit();
 	~BCNav1Bit();
 
-	int GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits);
+	int GetPackedFrame(GNSS_TIME StartTime, int svid, int Param, unsigned long long *PackedBits);
 
 private:
 	static const unsigned int BCH_prn_table[64];		// BCH encode table for SVID
 	static const unsigned long long BCH_soh_table[256];	// BCH encode table for SOH
 	static const char B1CMatrixGen2[B1C_SUBFRAME2_SYMBOL_LENGTH*B1C_SUBFRAME2_SYMBOL_LENGTH+1];
 	static const char B1CMatrixGen3[B1C_SUBFRAME3_SYMBOL_LENGTH*B1C_SUBFRAME3_SYMBOL_LENGTH+1];
+	unsigned long long B1CTable2[LDPC_TABLE_SIZE(B1C_SUBFRAME2_SYMBOL_LENGTH)];	// LDPC encode table of subframe 2
+	unsigned long long B1CTable3[LDPC_TABLE_SIZE(B1C_SUBFRAME3_SYMBOL_LENGTH)];	// LDPC encode table of subframe 3
 
 	void ComposeSubframe2(int week, int how, int svid, unsigned int Frame2Data[25]);
 	void ComposeSubframe3(int soh, unsigned int Flags, unsigned int AccurateIndex, unsigned int Frame3Data[11]);
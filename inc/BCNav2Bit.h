@@ -19,10 +19,11 @@ public:
 	BCNav2Bit();
 	~BCNav2Bit();
 
-	int GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits);
+	int GetPackedFrame(GNSS_TIME StartTime, int svid, int Param, unsigned long long *PackedBits);
 
 private:
 	static const char B2aMatrixGen[B2a_SYMBOL_LENGTH*B2a_SYMBOL_LENGTH+1];
+	unsigned long long B2aTable[LDPC_TABLE_SIZE(B2a_SYMBOL_LENGTH)];	// LDPC encode table
 	static const int MessageOrder[20];
 
 	void ComposeMessage(int MessageType, int week, int sow, int svid, unsigned int FrameData[]);
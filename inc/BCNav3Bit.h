@@ -19,11 +19,12 @@ public:
 	BCNav3Bit();
 	~BCNav3Bit();
 
-	int GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits);
+	int GetPackedFrame(GNSS_TIME StartTime, int svid, int Param, unsigned long long *PackedBits);
 
 private:
 
 	static const char B2bMatrixGen[B2b_SYMBOL_LENGTH*B2b_SYMBOL_LENGTH+1];
+	unsigned long long B2bTable[LDPC_TABLE_SIZE(B2b_SYMBOL_LENGTH)];	// LDPC encode table
 	static const int MessageOrder[6];
 
 	void ComposeMessage(int MessageType, int week, int sow, int svid, unsigned int FrameData[]);
@@ -11,6 +11,11 @@
 
 #include "NavBit.h"
 
+#define LDPC_MAX_SYMBOL 100		// maximum number of information symbols of BDS3 GF(64) LDPC code
+#define LDPC_TABLE_WORDS(n) (((n) + 7) / 8)		// number of 64bit words to hold n parity symbols, one symbol in each byte
+#define LDPC_TABLE_SIZE(n) ((n) * 16 * LDPC_TABLE_WORDS(n))	// size of LDPC encode table in 64bit words for n information symbols
+#define LDPC_MAX_CODE 2			// maximum number of LDPC codes (generator matrix and encode table) of one instance
+
 class BCNavBit : public NavBit
 {
 public:
@@ -24,8 +29,14 @@ public:
 	int AppendWord(unsigned int *Dest, int StartBit, unsigned int *Src, int Length);
 	int AssignBits(unsigned int Data, int BitNumber, int BitStream[]);
 	int AppendCRC(unsigned int DataStream[], int Length);
-	int LDPCEncode(int SymbolStream[], int SymbolLength, const char *MatrixGen);
+	void BuildLDPCTable(const char *MatrixGen, int SymbolLength, unsigned long long Table[]);
+	int LDPCEncode(int SymbolStream[], int SymbolLength, const unsigned long long Table[]);
+	int LDPCEncodeReference(int SymbolStream[], int SymbolLength, const char *MatrixGen);
 	int GF6IntMul(int a, int b);
+	int GetLDPCCode(int Index, const char *&MatrixGen, const unsigned long long *&Table);
+	int VerifyLDPC(GNSS_TIME StartTime, int FrameLength, int FrameNumber, int &FrameCompared);
+
+	bool LDPCReference;		// LDPCEncode() uses GF6IntMul() on generator matrix instead of table, for verification only
 
 	unsigned int Ephemeris1[63][9];		// IODE + ephemeris I (211 bits)
 	unsigned int Ephemeris2[63][10];	// ephemeris II (222 bits)
@@ -46,6 +57,10 @@ private:
 	static const unsigned int crc24q[256];				// CRC24Q table
 	static const unsigned int e2v_table[128];
 	static const unsigned int v2e_table[64];
+	int LDPCCodeNumber;		// LDPC codes recorded by BuildLDPCTable()
+	int LDPCSymbolLength[LDPC_MAX_CODE];
+	const char *LDPCMatrixGen[LDPC_MAX_CODE];
+	const unsigned long long *LDPCTable[LDPC_MAX_CODE];
 
 	int FillBdsAlmanacPage(PGPS_ALMANAC Almanac, unsigned int MidiAlm[8], unsigned int ReducedAlm[2]);
 };
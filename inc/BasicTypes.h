@@ -189,7 +189,6 @@ typedef struct
 typedef struct
 {
 	unsigned char flag;	// bit0 means ephemeris valid
-						// bit1 means position and velocity at tc valid (avoid extrapolation from beginning)
 	signed char freq;	// frequency number of satellite
 	unsigned char P;	// place P1, P2, P3, P4, ln, P from LSB at bit
 						//      0/1, 2, 3, 4, 5, 6/7
@@ -207,10 +206,6 @@ typedef struct
 	double x, y, z;		// posistion in PZ-90 at instant tb
 	double vx, vy, vz;	// velocity in PZ-90 at instant tb
 	double ax, ay, az;	// acceleration in PZ-90 at instant tb
-
-	// derived variables
-	double tc;			// reference time giving the following position and velocity
-	KINEMATIC_INFO PosVelT;	// position and velocity in CIS coordinate at instant tc
 } GLONASS_EPHEMERIS, *PGLONASS_EPHEMERIS;
 
 typedef struct
@@ -294,6 +289,14 @@ typedef struct
 
 typedef enum { OutputTypePosition, OutputTypeObservation, OutputTypeIFdata, OutputTypeBaseband } OutputType;
 typedef enum { OutputFormatEcef, OutputFormatLla, OutputFormatNmea, OutputFormatKml, OutputFormatRinex, OutputFormatIQ8, OutputFormatIQ4, OutputFormatIQ2, OutputFormatIQ16 } OutputFormat;
+typedef enum { SampleTypeDouble, SampleTypeFloat, SampleTypeInt16 } IfSampleType;	// data type of IF sample before quantization
+typedef enum { InterpolationLinear, InterpolationQuadratic } BlockInterpolation;	// carrier phase interpolation within generation block
+
+#define INT16_SAMPLE_SCALE 2048	// fixed point value of unit noise sigma for int16 IF sample
+
+// value of unit noise sigma for IF sample stored as T
+template <typename T> constexpr double IfSampleScale() { return 1.0; }
+template <> constexpr double IfSampleScale<short>() { return INT16_SAMPLE_SCALE; }
 
 typedef struct
 {
@@ -308,6 +311,12 @@ typedef struct
 	int Interval;	// in millisecond
 	int SampleFreq, CenterFreq;	// in kHz
 	unsigned int FreqSelect[4];	// Frequency select mask, 0~3 for GPS/BDS/Galileo/GLONASS respectively, bit selection uses SIGNAL_INDEX_XXXX
+	IfSampleType SampleType;	// IF sample type used in signal generation
+	unsigned int NoiseSeed;		// seed of IF noise generator
+	int NoiseBufferSize;		// size of pre-generated noise ring buffer in MB, 0 to generate noise of each ms directly
+	int BlockLength;			// generation block length in millisecond, satellite parameters calculated once per block
+	BlockInterpolation Interpolation;	// carrier phase interpolation within block
+	int OrbitInterpWindow;		// window length in second of satellite orbit interpolation, 0 to evaluate ephemeris every block
 } OUTPUT_PARAM, *POUTPUT_PARAM;
 
 typedef struct
@@ -13,6 +13,8 @@
 
 #define L1C_SUBFRAME2_SYMBOL_LENGTH 600
 #define L1C_SUBFRAME3_SYMBOL_LENGTH 274
+#define L1C_LDPC_WORDS(n) (((n) + 63) / 64)	// number of 64bit words to hold n parity bits
+#define L1C_LDPC_TABLE_SIZE(n, t) ((t) * 8 * 16 * L1C_LDPC_WORDS(n))	// size of LDPC encode table in 64bit words for n parity bits and t input DWORDs
 
 #define PAGE_INDEX_IONO_UTC 0	// Subframe3 index 0 for ionosphere and UTC parameters
 #define PAGE_INDEX_REDUCED_ALM 1	// Subframe3 index start from 1 for reduced-almanac
@@ -24,10 +26,14 @@ public:
 	CNav2Bit();
 	~CNav2Bit();
 
-	int GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits);
+	int GetPackedFrame(GNSS_TIME StartTime, int svid, int Param, unsigned long long *PackedBits);
 	int SetEphemeris(int svid, PGPS_EPHEMERIS Eph);
 	int SetAlmanac(GPS_ALMANAC Alm[]) { return 0; };
 	int SetIonoUtc(PIONO_PARAM IonoParam, PUTC_PARAM UtcParam);
+	void LDPCEncode(unsigned int Stream[], unsigned long long Bits[], int StartBit, int SymbolLength, int TableSize, const unsigned long long Table[]);
+	void LDPCEncodeReference(unsigned int Stream[], int bits[], int SymbolLength, int TableSize, const unsigned int MatrixGen[]);
+	int GetLDPCCode(int Index, const unsigned int *&MatrixGen, const unsigned long long *&Table, int &TableSize);
+	int VerifyLDPC(GNSS_TIME StartTime, int FrameNumber, int &SubframeCompared);
 
 private:
 	unsigned int Subframe2[32][18];	// 32 SVs, 576bits in subframe 2, 32bits in each DWORD MSB first, lowest address first
@@ -37,9 +43,11 @@ private:
 	static const unsigned long long BCH_toi_table[256];	// BCH encode table for TOI
 	static const unsigned int L1CMatrixGen2[L1C_SUBFRAME2_SYMBOL_LENGTH*19];
 	static const unsigned int L1CMatrixGen3[L1C_SUBFRAME3_SYMBOL_LENGTH*9];
+	unsigned long long L1CTable2[L1C_LDPC_TABLE_SIZE(L1C_SUBFRAME2_SYMBOL_LENGTH, 19)];	// LDPC encode table of subframe 2
+	unsigned long long L1CTable3[L1C_LDPC_TABLE_SIZE(L1C_SUBFRAME3_SYMBOL_LENGTH, 9)];	// LDPC encode table of subframe 3
 
 	void ComposeSubframe2(PGPS_EPHEMERIS Eph, unsigned int Subframe2[18], unsigned int ISCData[2]);
-	void LDPCEncode(unsigned int Stream[], int bits[], int SymbolLength, int TableSize, const unsigned int MatrixGen[]);
+	void BuildLDPCTable(const unsigned int MatrixGen[], int SymbolLength, int TableSize, unsigned long long Table[]);
 	int XorBits(unsigned int Data);
 	void GetSubframe3Data(int Svid, int PageIndex, unsigned int Subframe3Data[9]);
 };
@@ -17,7 +17,7 @@ public:
 	CNavBit();
 	~CNavBit();
 
-	int GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits);
+	int GetPackedFrame(GNSS_TIME StartTime, int svid, int Param, unsigned long long *PackedBits);
 	int SetEphemeris(int svid, PGPS_EPHEMERIS Eph);
 	int SetAlmanac(GPS_ALMANAC Alm[]);
 	int SetIonoUtc(PIONO_PARAM IonoParam, PUTC_PARAM UtcParam);
@@ -35,8 +35,12 @@ private:
 	unsigned int UTCMessage[4];			// 98bits from bit20 DWORD4 to bit19 DWORD7
 
 	// save convolutional encode state
-	unsigned char ConvEncodeBitsL2[32];
+	unsigned char ConvEncodeBitsL2[32];	// state after last encoded message
 	unsigned char ConvEncodeBitsL5[32];
+	unsigned char ConvStartBitsL2[32];	// state before last encoded message, used when the same message encoded again
+	unsigned char ConvStartBitsL5[32];
+	int LastMessageL2[32];	// index of last encoded message counted from week 0, -1 if none
+	int LastMessageL5[32];
 
 	int ComposeEphWords(PGPS_EPHEMERIS Ephemeris, unsigned int EphData[2][9], unsigned int ClockData[4], unsigned int DelayData[3]);
 	int ComposeAlmWords(GPS_ALMANAC Almanac[], unsigned int &ReducedAlmData, unsigned int MidiAlmData[6]);
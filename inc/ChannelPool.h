@@ -0,0 +1,41 @@
+//----------------------------------------------------------------------
+// ChannelPool.h:
+//   Declaration of pool of satellite IF signal channels
+//
+//          Copyright (C) 2020-2029 by Jun Mo, All rights reserved.
+//
+//----------------------------------------------------------------------
+
+#ifndef __CHANNEL_POOL_H__
+#define __CHANNEL_POOL_H__
+
+#include "BasicTypes.h"
+
+#define CHANNEL_POOL_SIZE 256	// maximum number of released channels kept for reuse
+
+class CSatIfSignal;
+
+// Channels of satellites that set are released to the pool instead of deleted and handed out again to rising satellites
+// A released channel keeps its PRN code, so a satellite getting back its own channel needs no code generation
+// All channels share sample number, block length and interpolation set by SetSampleFormat()
+class CChannelPool
+{
+public:
+	CChannelPool();
+	~CChannelPool();
+
+	void SetSampleFormat(int MsSampleNumber, int BlockMs, BlockInterpolation Interpolation);
+	CSatIfSignal *GetChannel(int SatIfFreq, GnssSystem SatSystem, int SatSignalIndex, unsigned char SatId);	// InitState() to be called before use
+	void ReleaseChannel(CSatIfSignal *Channel);
+	int GetCreateCount() { return CreateCount; }	// number of channels created
+	int GetReuseCount() { return ReuseCount; }	// number of channels handed out from pool
+
+private:
+	int MsSamples, BlockLength;
+	BlockInterpolation InterpolationType;
+	CSatIfSignal *FreeChannel[CHANNEL_POOL_SIZE];
+	int FreeNumber;
+	int CreateCount, ReuseCount;
+};
+
+#endif //__CHANNEL_POOL_H__
@@ -11,10 +11,44 @@
 
 #include "BasicTypes.h"
 
+#define EPH_BATCH_SIZE 64	// maximum number of satellites evaluated in one batch
+
+// orbit parameters of a group of GPS/BDS/Galileo satellites in structure of arrays layout
+// so that position/velocity of all satellites can be calculated with SIMD instructions
+typedef struct
+{
+	int Number;
+	PGPS_EPHEMERIS Eph[EPH_BATCH_SIZE];	// source ephemeris, Ek and Ek_dot written back on each evaluation
+	BOOL BdsGeo[EPH_BATCH_SIZE];		// BDS GEO satellite needs extra rotation
+	double toe[EPH_BATCH_SIZE], M0[EPH_BATCH_SIZE], n[EPH_BATCH_SIZE], delta_n_dot[EPH_BATCH_SIZE];
+	double ecc[EPH_BATCH_SIZE], root_ecc[EPH_BATCH_SIZE], w[EPH_BATCH_SIZE], axis[EPH_BATCH_SIZE], axis_dot[EPH_BATCH_SIZE];
+	double i0[EPH_BATCH_SIZE], idot[EPH_BATCH_SIZE], omega_t[EPH_BATCH_SIZE], omega_delta[EPH_BATCH_SIZE];
+	double cuc[EPH_BATCH_SIZE], cus[EPH_BATCH_SIZE], crc[EPH_BATCH_SIZE], crs[EPH_BATCH_SIZE], cic[EPH_BATCH_SIZE], cis[EPH_BATCH_SIZE];
+	double Ek[EPH_BATCH_SIZE], Ek_dot[EPH_BATCH_SIZE];
+} EPHEMERIS_BATCH, *PEPHEMERIS_BATCH;
+
+#define GLONASS_GRID_STEP 30	// interval in second of stored GLONASS integrator states, same as integration step
+#define GLONASS_GRID_HALF 360	// number of stored states on each side of tb, covering +-3 hours
+
+// integrator states of one GLONASS satellite on a GLONASS_GRID_STEP grid around tb
+// states are integrated on demand and kept, position and velocity in between are interpolated
+// with quintic Hermite polynomial from position, velocity and acceleration at both ends of the step
+// ephemeris is not modified, so each thread keeps its own states and evaluation takes constant time
+typedef struct
+{
+	PGLONASS_EPHEMERIS Eph;	// ephemeris the states integrated from, NULL if not initialized
+	int First, Last;		// range of grid index with state calculated, index GLONASS_GRID_HALF at tb
+	double State[GLONASS_GRID_HALF*2+1][9];	// position, velocity and acceleration in CIS coordinate at each grid point
+} GLONASS_ORBIT, *PGLONASS_ORBIT;
+
 double GpsClockCorrection(PGPS_EPHEMERIS Eph, double TransmitTime);
 double GlonassClockCorrection(PGLONASS_EPHEMERIS Eph, double TransmitTime);
 bool GpsSatPosSpeedEph(GnssSystem system, double TransmitTime, PGPS_EPHEMERIS pEph, PKINEMATIC_INFO pPosVel, double Acc[3]);
+void SetEphemerisBatch(GnssSystem system, PGPS_EPHEMERIS Eph[], int Number, PEPHEMERIS_BATCH Batch);
+void GpsSatPosSpeedBatch(PEPHEMERIS_BATCH Batch, const double TransmitTime[], KINEMATIC_INFO PosVel[]);
 bool GlonassSatPosSpeedEph(double TransmitTime, PGLONASS_EPHEMERIS pEph, PKINEMATIC_INFO pPosVel, double Acc[3]);
+void InitGlonassOrbit(GLONASS_ORBIT Orbit[], int Number);
+bool GlonassSatPosSpeedOrbit(double TransmitTime, PGLONASS_EPHEMERIS pEph, PGLONASS_ORBIT Orbit, PKINEMATIC_INFO pPosVel, double Acc[3]);
 LLA_POSITION EcefToLla(KINEMATIC_INFO ecef_pos);
 KINEMATIC_INFO LlaToEcef(LLA_POSITION lla_pos);
 CONVERT_MATRIX CalcConvMatrix(KINEMATIC_INFO Position);
@@ -27,6 +27,7 @@ public:
 private:
     // Static lookup tables
     static double sin_lut[TRIG_LUT_SIZE + TRIG_LUT_SIZE / 4];
+    static float sin_lut_f[TRIG_LUT_SIZE + TRIG_LUT_SIZE / 4];  // single precision copy for float/int16 samples
 //    static double cos_lut[TRIG_LUT_SIZE];
     static bool lut_initialized;
     
@@ -37,12 +38,21 @@ public:
             for (int i = 0; i < TRIG_LUT_SIZE + TRIG_LUT_SIZE / 4; i++) {
                 double angle = (PI2 * i) / TRIG_LUT_SIZE;
                 sin_lut[i] = std::sin(angle);
+                sin_lut_f[i] = (float)sin_lut[i];
 //                cos_lut[i] = std::cos(angle);
             }
             lut_initialized = true;
         }
     }
 
+    // Raw sine table for vectorized kernels, cosine starts at offset TRIG_LUT_SIZE / 4
+    static const double *GetSinLut() {
+        return sin_lut;
+    }
+    static const float *GetSinLutFloat() {
+        return sin_lut_f;
+    }
+
     // Fast sine using lookup table - force inline for performance
     static FORCE_INLINE double FastSin(double angle) {
         // Normalize angle to [0, 2*PI)
@@ -93,37 +103,6 @@ public:
         angle_index >>= TRIG_LUT_SHIFT;
         return complex_number(sin_lut[angle_index + TRIG_LUT_SIZE / 4], sin_lut[angle_index]);
     }
-    
-    // Fast noise generation using Box-Muller with cached values
-    static complex_number FastGaussianNoise(double sigma) {
-        static bool hasSpare = false;
-        static double spare;
-        
-        if (hasSpare) { // this will result the Gauss noise only has real part on every other sample
-            hasSpare = false;
-            return complex_number(spare * sigma, 0);
-        }
-        
-        double u1, u2, mag;
-        do {
-            u1 = 2.0 * ((double)rand() / RAND_MAX) - 1.0;
-            u2 = 2.0 * ((double)rand() / RAND_MAX) - 1.0;
-            mag = u1 * u1 + u2 * u2;
-        } while (mag >= 1.0 || mag == 0.0);
-        
-        double factor = std::sqrt(-2.0 * std::log(mag) / mag);
-        spare = u2 * factor;
-        hasSpare = true;
-        
-        return complex_number(u1 * factor * sigma, u2 * factor * sigma);
-    }
-    
-    // Batch noise generation for better cache efficiency
-    static void GenerateNoiseBlock(complex_number* output, int count, double sigma) {
-        for (int i = 0; i < count; i++) {
-            output[i] = FastGaussianNoise(sigma);
-        }
-    }
 };
 
 #endif // FAST_MATH_H
\ No newline at end of file
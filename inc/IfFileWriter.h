@@ -0,0 +1,67 @@
+//----------------------------------------------------------------------
+// IfFileWriter.h:
+//   Declaration of asynchronous IF data file writer class
+//
+//          Copyright (C) 2020-2029 by Jun Mo, All rights reserved.
+//
+//----------------------------------------------------------------------
+
+#ifndef __IF_FILE_WRITER_H__
+#define __IF_FILE_WRITER_H__
+
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+
+#include "BasicTypes.h"
+
+#define IF_WRITER_BUFFER_NUMBER 4			// number of buffers in the pool
+#define IF_WRITER_BUFFER_SIZE (4 << 20)		// bytes of one file write
+#define IF_WRITER_ALIGNMENT 4096			// alignment of buffer address and write size for direct IO
+
+// Write quantized IF data to file on a dedicated thread
+// Data of many blocks are coalesced into buffers of IF_WRITER_BUFFER_SIZE bytes and handed to
+// writer thread through a lock-free single producer single consumer ring, so generation of
+// next block overlaps with file write. Producer waits (stall) only if all buffers are in use.
+// Usage: GetBuffer() to get space of one block, fill the data, then Commit()
+class CIfFileWriter
+{
+public:
+	CIfFileWriter(int PoolSize = IF_WRITER_BUFFER_NUMBER);
+	~CIfFileWriter();
+
+	BOOL Open(const char *FileName, int MaxBlockSize, BOOL DirectIo);	// DirectIo uses O_DIRECT on Linux, fall back to buffered write if not supported
+	void Close();	// write remaining data, stop writer thread and close file
+	unsigned char *GetBuffer() { return Buffers[WriteIndex % BufferNumber] + CurrentFill; }	// space of MaxBlockSize bytes
+	void Commit(int Size);
+	BOOL IsDirectIo() { return UseDirectIo; }
+
+	// statistics, write side values valid after Close()
+	long long GetBytesWritten() { return BytesWritten; }
+	int GetWriteCount() { return WriteCount; }
+	double GetWriteTime() { return WriteTime; }	// time spent in file write in second
+	int GetStallCount() { return StallCount; }
+	double GetStallTime() { return StallTime; }	// time producer waited for free buffer in second
+	BOOL HasError() { return WriteError; }
+
+private:
+	int BufferNumber, BufferSize;
+	unsigned char **Buffers;
+	int *FillSize;
+	int CurrentFill;	// bytes in buffer being filled by producer
+	std::atomic<unsigned int> WriteIndex, ReadIndex;	// number of buffers handed to / finished by writer thread
+	std::atomic<bool> StopFlag;
+	std::thread WriterThread;
+	FILE *File;
+	int FileDescriptor;
+	BOOL UseDirectIo, WriteError;
+	long long BytesWritten;
+	int WriteCount, StallCount;
+	double WriteTime, StallTime;
+
+	void WaitFreeBuffer();
+	void WriterLoop();
+	void WriteData(const unsigned char *Data, int Size);
+};
+
+#endif //__IF_FILE_WRITER_H__
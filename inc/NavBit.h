@@ -9,9 +9,20 @@
 #ifndef __NAV_BIT_H__
 #define __NAV_BIT_H__
 
+#include <mutex>
+
 #include "BasicTypes.h"
 
+#define NAV_FRAME_CACHE_SVID 63		// maximum svid with frames cached, frames of larger svid encoded each time
+#define NAV_FRAME_CACHE_PARAM 2		// number of Param values with frames cached
+#define NAV_FRAME_CACHE_SLOT 2		// frames kept for each svid and Param, current frame and the next one
+#define NAV_FRAME_CACHE_SIZE (NAV_FRAME_CACHE_SVID * NAV_FRAME_CACHE_PARAM * NAV_FRAME_CACHE_SLOT)	// number of encoded frames kept by each navigation bit instance
+#define NAV_FRAME_MAX_BITS 1800		// maximum encoded data bit for one subframe/page
+#define NAV_FRAME_WORDS(n) (((n) + 63) / 64)	// number of 64bit words to hold n packed data bits
+
 #define COMPOSE_BITS(data, start, width) (((data) & ((1UL << (width)) - 1)) << (start))
+#define SET_PACKED_BIT(bits, i, value) ((bits)[(i) >> 6] |= (unsigned long long)((value) & 1) << ((i) & 63))	// OR one bit into packed data bits
+#define GET_PACKED_BIT(bits, i) ((int)((bits)[(i) >> 6] >> ((i) & 63)) & 1)
 
 typedef union
 {
@@ -19,6 +30,15 @@ typedef union
 	unsigned int i_data[2];
 } DOUBLE_INT_UNION;
 
+// encoded data bits of one subframe/page, stored in the slot of its svid and Param,
+// identified within the slot by frame start time (week and millisecond of converted transmit time)
+typedef struct
+{
+	int svid;				// 0 for empty entry
+	int Week, FrameStart;
+	unsigned long long Bits[NAV_FRAME_WORDS(NAV_FRAME_MAX_BITS)];	// packed data bits, bit i at bit (i&63) of Bits[i>>6]
+} NAV_FRAME_CACHE, *PNAV_FRAME_CACHE;
+
 class NavBit
 {
 public:
@@ -27,11 +47,19 @@ public:
 	NavBit();
 	~NavBit();
 
-	virtual int GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits) = 0;	// Param reserved for same Navigation bit structure in different signal
+	virtual int GetPackedFrame(GNSS_TIME StartTime, int svid, int Param, unsigned long long *PackedBits) = 0;	// Param reserved for same Navigation bit structure in different signal
+	int GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits);	// one bit in each int, unpacked from GetPackedFrame()
 	virtual int SetEphemeris(int svid, PGPS_EPHEMERIS Eph) = 0;
 	virtual int SetAlmanac(GPS_ALMANAC Alm[]) = 0;
 	virtual int SetIonoUtc(PIONO_PARAM IonoParam, PUTC_PARAM UtcParam) = 0;
 	virtual int SetNavParam(NavParamType ParamType, void *Param) { return 0; }
+	int GetFrameBits(GNSS_TIME StartTime, int FrameStart, GNSS_TIME NextFrame, int svid, int Param, int BitNumber, unsigned long long *PackedBits);
+	static void PackBits(const int *NavBits, int BitNumber, unsigned long long *PackedBits);
+	static void AssignPackedBits(unsigned int Data, int BitNumber, unsigned long long PackedBits[], int StartBit);
+	static void CopyPackedBits(const unsigned long long Src[], int BitNumber, unsigned long long PackedBits[], int StartBit);
+	void ClearFrameCache(int svid = 0);
+	int UpdateEphemeris(int svid, PGPS_EPHEMERIS Eph);	// SetEphemeris()/SetAlmanac() safe to call while frames are filled
+	int UpdateAlmanac(GPS_ALMANAC Alm[]);
 	int roundi(double data);
 	int roundu(double data);
 	double UnscaleDouble(double value, int scale);
@@ -45,6 +73,16 @@ public:
 
 	static const unsigned char ConvEncodeTable[256];
 	static const unsigned int Crc24q[256];
+
+protected:
+	int FrameBitNumber;		// number of data bits written by GetPackedFrame(), set by derived class
+
+private:
+	PNAV_FRAME_CACHE FrameCache;	// allocated on first use, NAV_FRAME_CACHE_SLOT entries for each svid and Param
+	std::recursive_mutex FrameCacheMutex;	// channels sharing one instance fill frames in parallel, recursive for Set* called within Update*
+
+	PNAV_FRAME_CACHE FindFrame(PNAV_FRAME_CACHE Slot, int Week, int FrameStart);
+	PNAV_FRAME_CACHE EncodeFrame(PNAV_FRAME_CACHE Slot, PNAV_FRAME_CACHE Keep, GNSS_TIME StartTime, int FrameStart, int svid, int Param, int &Result);
 };
 
 #endif // __NAV_BIT_H__
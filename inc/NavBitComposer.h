@@ -0,0 +1,51 @@
+//----------------------------------------------------------------------
+// NavBitComposer.h:
+//   Declaration of ephemeris and almanac composition for all navigation bit instances
+//
+//          Copyright (C) 2020-2029 by Jun Mo, All rights reserved.
+//
+//----------------------------------------------------------------------
+
+#ifndef __NAV_BIT_COMPOSER_H__
+#define __NAV_BIT_COMPOSER_H__
+
+#include <mutex>
+
+#include "BasicTypes.h"
+#include "NavBit.h"
+
+#define COMPOSER_SYSTEM_NUMBER 4	// GPS, BDS, Galileo and GLONASS
+#define COMPOSER_MAX_NAVBIT 4		// maximum number of navigation bit instances of one system
+#define COMPOSER_MAX_SVID 63		// maximum svid (slot for GLONASS) of all systems
+#define COMPOSER_MAX_TASK (COMPOSER_SYSTEM_NUMBER * COMPOSER_MAX_NAVBIT * COMPOSER_MAX_SVID)
+
+// ephemeris and almanac go to all navigation bit instances of a system through the composer,
+// ephemeris same as the one set last time is skipped, others are queued with switch time until Compose() or Update()
+// Compose() distributes (instance, satellite) pairs to OpenMP threads, used before signals start
+// Update() composes one by one with frame cache of the instance locked, only ephemeris with switch time reached,
+// so ephemeris found ahead by parameter stage goes to navigation data when synthesis reaches the switch time
+class CNavBitComposer
+{
+public:
+	CNavBitComposer();
+	~CNavBitComposer();
+
+	void AddNavBit(GnssSystem System, NavBit *Nav);
+	bool SetEphemeris(GnssSystem System, int svid, PGPS_EPHEMERIS Eph, long long SwitchTime = 0);	// return true if ephemeris changed and queued
+	void SetAlmanac(GnssSystem System, PGPS_ALMANAC Alm);
+	int Compose();	// return number of satellites composed
+	int Update(long long Time);	// return number of satellites composed, queued almanac composed as well
+
+private:
+	NavBit *NavBitList[COMPOSER_SYSTEM_NUMBER][COMPOSER_MAX_NAVBIT];
+	int NavBitNumber[COMPOSER_SYSTEM_NUMBER];
+	PGPS_EPHEMERIS LastEph[COMPOSER_SYSTEM_NUMBER][COMPOSER_MAX_SVID];	// ephemeris set last time, NULL if never set
+	PGPS_ALMANAC PendingAlm[COMPOSER_SYSTEM_NUMBER];	// NULL if no almanac queued
+	int PendingSystem[COMPOSER_SYSTEM_NUMBER * COMPOSER_MAX_SVID], PendingSvid[COMPOSER_SYSTEM_NUMBER * COMPOSER_MAX_SVID];
+	PGPS_EPHEMERIS PendingEph[COMPOSER_SYSTEM_NUMBER * COMPOSER_MAX_SVID];
+	long long PendingTime[COMPOSER_SYSTEM_NUMBER * COMPOSER_MAX_SVID];	// switch time in millisecond since GPS epoch
+	int PendingNumber;
+	std::mutex PendingMutex;	// ephemeris queued by parameter stage while Update() called by synthesis
+};
+
+#endif // __NAV_BIT_COMPOSER_H__
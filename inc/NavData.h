@@ -13,6 +13,8 @@
 #include "Rinex.h"
 
 #define EPH_NUMBER_INIT 100
+#define EPH_INDEX_SVID 64	// svid range covered by ephemeris index (BDS has most satellites)
+#define EPH_SWITCH_MAX_SPAN 604800	// ephemeris switch later than this number of seconds reported as no switch
 
 class CNavData
 {
@@ -28,6 +30,8 @@ public:
 	bool AddNavData(NavDataType Type, void *NavData);
 	PGPS_EPHEMERIS FindEphemeris(GnssSystem system, GNSS_TIME time, int svid, int IgnoreTimeLimit = 0, unsigned char FirstPrioritySource = 0);
 	PGLONASS_EPHEMERIS FindGloEphemeris(GLONASS_TIME GlonassTime, int slot);
+	int GetEphemerisSwitchTime(GnssSystem system, GNSS_TIME time, int svid, int IgnoreTimeLimit = 0, unsigned char FirstPrioritySource = 0);
+	int GetGloEphemerisSwitchTime(GLONASS_TIME GlonassTime, int slot);
 	PGPS_ALMANAC GetGpsAlmanac() { return GpsAlmanac; }
 	PGPS_ALMANAC GetBdsAlmanac() { return BdsAlmanac; }
 	PGPS_ALMANAC GetGalileoAlmanac() { return GalileoAlmanac; }
@@ -69,6 +73,17 @@ private:
 	UTC_PARAM GalileoUtcParam;
 //	UTC_PARAM GalileoGpsParam;
 	int GlonassSlotFreq[24];	// FreqID for each slot
+
+	// pool index of usable ephemeris of each system sorted by svid (slot for GLONASS) then by reference time
+	// EphIndex[system][EphIndexStart[system][svid]] to EphIndex[system][EphIndexStart[system][svid+1]-1] for each svid
+	// built on first search after ephemeris added, so loading many files does not sort repeatedly
+	int *EphIndex[4];
+	int EphIndexStart[4][EPH_INDEX_SVID+2];
+	bool EphIndexValid[4];
+
+	void BuildEphIndex(GnssSystem system);
+	int EphemerisKey(GnssSystem system, int PoolIndex);
+	int EphIndexLowerBound(GnssSystem system, int First, int Last, int Key);
 };
 
 #endif // __NAV_DATA_H__
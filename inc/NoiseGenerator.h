@@ -0,0 +1,46 @@
+//----------------------------------------------------------------------
+// NoiseGenerator.h:
+//   Declaration of Gaussian noise generation class
+//
+//          Copyright (C) 2020-2029 by Jun Mo, All rights reserved.
+//
+//----------------------------------------------------------------------
+
+#ifndef __NOISE_GENERATOR_H__
+#define __NOISE_GENERATOR_H__
+
+#define NOISE_SUB_BLOCK_SIZE 1024	// number of samples generated by one random stream
+#define NOISE_LANE_NUMBER 4			// number of interleaved xoshiro256+ generators in one random stream
+#define NOISE_PERMUTATION_NUMBER 8	// sign of I, sign of Q and IQ swap applied to ring buffer samples
+
+// Complex Gaussian noise generator
+// Each block (1ms) is divided into sub-blocks of NOISE_SUB_BLOCK_SIZE samples, and each
+// sub-block uses its own random stream derived from (Seed, BlockIndex, SubBlockIndex),
+// so the result only depends on seed and block index, not on thread number or call order.
+// Noise uses Box-Muller transform with radius from polynomial logarithm and angle from sine LUT.
+// Optionally noise is taken from a pre-generated ring buffer, each sub-block uses a random
+// offset within the buffer and one of NOISE_PERMUTATION_NUMBER sign/IQ-swap permutations.
+class CNoiseGenerator
+{
+public:
+	CNoiseGenerator(unsigned int NoiseSeed = 0);
+	~CNoiseGenerator();
+
+	void SetSeed(unsigned int NoiseSeed) { Seed = NoiseSeed; }
+	template <typename T> void Generate(T *Samples, int SampleNumber, unsigned long long BlockIndex, double Sigma);	// T is double, float or short, real/imag interleaved
+	template <typename T> long long CreateRingBuffer(long long BufferSize, double Sigma);	// BufferSize in bytes, return number of samples in buffer
+	void ReleaseRingBuffer();
+
+private:
+	unsigned int Seed;
+	void *RingBuffer;
+	long long RingBufferLength;	// number of complex samples in ring buffer
+	int RingBufferSampleSize;	// size of real/imag part of samples in ring buffer
+	double RingBufferSigma;
+
+	void InitStream(unsigned long long State[4][NOISE_LANE_NUMBER], unsigned long long BlockIndex, int SubBlockIndex);
+	template <typename T> void GenerateSubBlock(T *Samples, int SampleNumber, unsigned long long State[4][NOISE_LANE_NUMBER], double Sigma);
+	template <typename T> void CopySubBlock(T *Samples, int SampleNumber, unsigned long long BlockIndex, int SubBlockIndex);
+};
+
+#endif //__NOISE_GENERATOR_H__
@@ -0,0 +1,47 @@
+//----------------------------------------------------------------------
+// OrbitInterp.h:
+//   Declaration of Chebyshev polynomial interpolation of satellite orbit
+//
+//          Copyright (C) 2020-2029 by Jun Mo, All rights reserved.
+//
+//----------------------------------------------------------------------
+
+#if !defined (__ORBIT_INTERP_H__)
+#define __ORBIT_INTERP_H__
+
+#include "BasicTypes.h"
+
+#define ORBIT_INTERP_ORDER 10		// number of Chebyshev coefficients of each fitted quantity
+#define ORBIT_INTERP_MARGIN 1.0		// fitting window starts this number of seconds before current time to cover signal travel time
+#define ORBIT_INTERP_TOLERANCE 1e-4	// maximum error in meter of fitted position and clock correction, use exact evaluation if exceeded
+#define ORBIT_INTERP_MIN_WINDOW 10	// range of fitting window length in second
+#define ORBIT_INTERP_MAX_WINDOW 600
+#define ATMOS_UPDATE_INTERVAL 0.1	// ionosphere and troposphere delay re-evaluated every this number of seconds
+#define ATMOS_MAX_ERROR 0.01		// extrapolation error in meter found on re-evaluation regarded as discontinuity of delay model
+
+// satellite position and clock correction of one GPS/BDS/Galileo satellite fitted with Chebyshev polynomials
+// over window [StartTime, StartTime + Span] of transmit time, so evaluation within window takes only a few multiply-adds
+// ionosphere and troposphere delay depend on receiver trajectory which is not known ahead,
+// so they are re-evaluated every ATMOS_UPDATE_INTERVAL and extrapolated linearly with rate from last two evaluations
+typedef struct
+{
+	PGPS_EPHEMERIS Eph;		// ephemeris the polynomials fitted from, NULL if not fitted
+	double StartTime;		// start of fitting window in second of week
+	double Span;			// length of fitting window in second
+	double Coef[4][ORBIT_INTERP_ORDER];			// coefficients of x, y, z in meter and clock correction (including relativity) in second
+	double DerivCoef[3][ORBIT_INTERP_ORDER-1];	// coefficients of vx, vy, vz in m/s
+	double MaxError;		// maximum error in meter found by accuracy check after fitting
+	BOOL Valid;				// FALSE if accuracy check failed, exact evaluation used within window
+	int AtmosCount;			// number of consecutive atmosphere delay evaluations (up to 2), rate valid if 2
+	double AtmosTime;		// receiver time of last atmosphere delay evaluation in second of week
+	double IonoDelay, IonoRate;		// ionosphere delay in meter at AtmosTime and its rate
+	double TropoDelay, TropoRate;	// troposphere delay in meter at AtmosTime and its rate
+} ORBIT_INTERP, *PORBIT_INTERP;
+
+void InitOrbitInterp(ORBIT_INTERP Interp[], int Number);
+BOOL FitOrbitInterp(GnssSystem system, PGPS_EPHEMERIS Eph, double StartTime, double Span, PORBIT_INTERP Interp);
+BOOL OrbitInterpInWindow(PORBIT_INTERP Interp, PGPS_EPHEMERIS Eph, double TransmitTime);
+void OrbitInterpPosVel(PORBIT_INTERP Interp, double TransmitTime, PKINEMATIC_INFO PosVel, double &ClockCorrection);
+void OrbitInterpAtmosDelay(PORBIT_INTERP Interp, double ReceiverTime, PIONO_PARAM IonoParam, double SatelliteTime, LLA_POSITION PositionLla, double Elevation, double Azimuth, double &Iono, double &Tropo);
+
+#endif //!defined(__ORBIT_INTERP_H__)
@@ -0,0 +1,43 @@
+//----------------------------------------------------------------------
+// PipelineQueue.h:
+//   Declaration of bounded queue between pipeline stages
+//
+//          Copyright (C) 2020-2029 by Jun Mo, All rights reserved.
+//
+//----------------------------------------------------------------------
+
+#ifndef __PIPELINE_QUEUE_H__
+#define __PIPELINE_QUEUE_H__
+
+#include <atomic>
+
+#define PIPELINE_SPIN_COUNT 64		// number of yields before sleeping when waiting
+#define PIPELINE_SLEEP_TIME 20		// microseconds to sleep each time when waiting
+
+// Bounded single producer single consumer queue of slot indices
+// Data of each slot is held by the user in an array of Depth elements,
+// producer fills slot GetWriteSlot() then calls Push(), consumer reads slot GetReadSlot() then calls Pop()
+// Both sides wait (spin then sleep) when queue full/empty, waiting time is counted as stall of each side
+class CPipelineQueue
+{
+public:
+	CPipelineQueue(int QueueDepth);
+	~CPipelineQueue();
+
+	int GetWriteSlot();	// wait until a slot is free, return slot index
+	void Push();
+	int GetReadSlot();	// wait until a slot is filled, return slot index or -1 if finished and empty
+	void Pop();
+	void Finish() { Finished.store(true, std::memory_order_release); }	// producer will push no more slot
+	int GetDepth() { return Depth; }
+	double GetProducerStall() { return ProducerStall; }	// time in second producer waited for free slot
+	double GetConsumerStall() { return ConsumerStall; }	// time in second consumer waited for filled slot
+
+private:
+	int Depth;
+	std::atomic<unsigned int> WriteIndex, ReadIndex;
+	std::atomic<bool> Finished;
+	double ProducerStall, ConsumerStall;
+};
+
+#endif //__PIPELINE_QUEUE_H__
@@ -36,44 +36,69 @@ struct PrnAttribute
 #define PRN_ATTRIBUTE_BOC 1
 #define PRN_ATTRIBUTE_TMD 2
 
+// get sub-chip Index of packed PRN sequence, 0 for +1 and 1 for -1
+inline int GetPackedChip(const unsigned long long *Sequence, int Index)
+{
+	return (int)(Sequence[Index >> 6] >> (Index & 63)) & 1;
+}
+
+// get 32 sub-chips of packed PRN sequence starting at Index, bit 0 is sub-chip Index
+// the word after the one holding Index is always read, so sequences have one padding word at end
+inline unsigned int GetPackedWindow(const unsigned long long *Sequence, int Index)
+{
+	const unsigned long long *Word = Sequence + (Index >> 6);
+	const int Shift = Index & 63;
+
+	return (unsigned int)((Word[0] >> Shift) | ((Word[1] << 1) << (63 - Shift)));
+}
+
+// fixed PRN codes generated at compile time into read-only tables (needs C++17 or later)
+// otherwise all codes are generated at run time
+#if !defined(PRN_CONSTEXPR_TABLE)
+#define PRN_CONSTEXPR_TABLE 0
+#endif
+#if PRN_CONSTEXPR_TABLE && !(__cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L))
+#error "PRN_CONSTEXPR_TABLE requires C++17 or later"
+#endif
+
+// key range of process-wide PRN code cache
+#define PRN_CACHE_SYSTEM 4	// GPS/BDS/Galileo/GLONASS
+#define PRN_CACHE_SIGNAL 8
+#define PRN_CACHE_SVID 64
+
 class PrnGenerate
 {
 public:
-	PrnGenerate(GnssSystem System, int SignalIndex, int Svid);
+	PrnGenerate(GnssSystem System, int SignalIndex, int Svid, BOOL UseTable = TRUE);	// UseTable = FALSE forces run time generation
 	~PrnGenerate();
 
-	int *DataPrn, *PilotPrn;
+	// shared read-only code of (System, SignalIndex, Svid), generated on first request
+	// each GetPrnCode() must be paired with ReleasePrnCode(), code is deleted when last user releases it
+	static PrnGenerate *GetPrnCode(GnssSystem System, int SignalIndex, int Svid);
+	static void ReleasePrnCode(PrnGenerate *PrnCode);
+	static int VerifyCodeTable(int &CodeNumber);
+
+	// PRN code expanded to sub-chips of ChipRate and packed 64 sub-chips per word (LSB first) plus a padding word
+	// BOC has chip and inverted chip (subcarrier sign) as two sub-chips, TMD has CM chip in even
+	// sub-chip of data and CL chip in odd sub-chip of pilot (the other sub-chip is 0)
+	const unsigned long long *DataPrn, *PilotPrn;
+	int DataLength, PilotLength;	// number of sub-chips of the sequence
 	const PrnAttribute* Attribute;
 
 private:
+	int RefCount;	// number of users of cached code, 0 for code not in cache
+	int CacheIndex;	// position in cache
+	unsigned long long *DataBuffer, *PilotBuffer;	// sequences generated at run time
+
+	BOOL FindCodeTable(GnssSystem System, int SignalIndex, int Svid);
+
+	unsigned long long *PackSequence(int *Sequence, int Length, int Odd);
 	int *GetGoldCode(unsigned int G1Init, unsigned int G1Poly, unsigned int G2Init, unsigned int G2Poly, int Length, int Depth, int ResetPos);
-	void LegendreSequence(int *Data, int Length);
+	static void LegendreSequence(int *Data, int Length);
 	int *GetL1CWeil(int InsertPoint, int PhaseDiff);
 	int *GetB1CWeil(int TruncationPoint, int PhaseDiff);
 	int *GetMemorySequence(const unsigned int *BinarySequence, int SectorLength);
 
-	static const unsigned int L1CAPrnInit[32];
-	static const unsigned int L5IPrnInit[32];
-	static const unsigned int L5QPrnInit[32];
-	static const unsigned int L2CMPrnInit[32];
-	static const unsigned int L2CLPrnInit[32];
-	static const unsigned int B1IPrnInit[63];
-	static const unsigned int B3IPrnInit[63];
-	static const unsigned int B2aDPrnInit[63];
-	static const unsigned int B2aPPrnInit[63];
-	static const unsigned int B2bPrnInit[63];
-	static const unsigned int E5aIPrnInit[50];
-	static const unsigned int E5aQPrnInit[50];
-	static const unsigned int E5bIPrnInit[50];
-	static const unsigned int E5bQPrnInit[50];
-	static const int B1CDataTruncation[63];
-	static const int B1CDataPhaseDiff[63];
-	static const int B1CPilotTruncation[63];
-	static const int B1CPilotPhaseDiff[63];
-	static const int L1CDataInsertIndex[63];
-	static const int L1CDataPhaseDiff[63];
-	static const int L1CPilotInsertIndex[63];
-	static const int L1CPilotPhaseDiff[63];
 	static const unsigned int E1MemoryCode[100*128];
 	static const unsigned int E6MemoryCode[100*160];
 	static const PrnAttribute PrnAttributes[];
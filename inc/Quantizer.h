@@ -0,0 +1,50 @@
+//----------------------------------------------------------------------
+// Quantizer.h:
+//   Declaration of IF sample quantization class
+//
+//          Copyright (C) 2020-2029 by Jun Mo, All rights reserved.
+//
+//----------------------------------------------------------------------
+
+#ifndef __QUANTIZER_H__
+#define __QUANTIZER_H__
+
+#include "BasicTypes.h"
+
+#define AGC_UPDATE_PERIOD 100		// milliseconds between AGC gain update
+#define AGC_CLIP_RATE_HIGH 0.01		// reduce gain if clipping rate above 1%
+#define AGC_CLIP_RATE_LOW 0.001		// increase gain if clipping rate below 0.1%
+#define AGC_GAIN_DECREASE 0.95
+#define AGC_GAIN_INCREASE 1.02
+
+// Quantize IF samples (real/imag interleaved, unit noise sigma scaled by IfSampleScale<T>())
+// into IQ2/IQ4/IQ8/IQ16 output format with automatic gain control
+// QuantizeBlock() uses branchless loops vectorized by compiler for any SIMD instruction set,
+// QuantizeBlockScalar() is the per-component reference implementation
+class CQuantizer
+{
+public:
+	CQuantizer(OutputFormat QuantFormat = OutputFormatIQ8);
+	~CQuantizer();
+
+	void SetFormat(OutputFormat QuantFormat) { Format = QuantFormat; }
+	int GetOutputSize(int SampleNumber);	// output bytes of SampleNumber complex samples
+	template <typename T> int Quantize(const T Samples[], int SampleNumber, unsigned char QuantSamples[]);	// return number of clipped samples
+	int UpdateAgc(int BlockMs = 1);	// call once each block of BlockMs ms, return -1 if gain decreased, 1 if increased, 0 if not changed
+	double GetGain() { return AgcGain; }
+	double GetClippingRate() { return ClippingRate; }	// clipping rate of last AGC update
+	long long GetTotalSamples() { return TotalSamples; }
+	long long GetTotalClipped() { return TotalClipped; }
+
+	template <typename T> static int QuantizeBlock(const T Samples[], int SampleNumber, unsigned char QuantSamples[], double GainScale, OutputFormat QuantFormat);
+	template <typename T> static int QuantizeBlockScalar(const T Samples[], int SampleNumber, unsigned char QuantSamples[], double GainScale, OutputFormat QuantFormat);
+
+private:
+	OutputFormat Format;
+	double AgcGain, ClippingRate;
+	int ElapsedMs;
+	long long WindowSamples, WindowClipped;	// statistic since last AGC gain change
+	long long TotalSamples, TotalClipped;
+};
+
+#endif //__QUANTIZER_H__
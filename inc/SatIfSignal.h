@@ -11,17 +11,40 @@
 #include "NavBit.h"
 #include "SatelliteSignal.h"
 
+#define MAX_BLOCK_LENGTH 20	// maximum generation block length in millisecond
+#define MAX_BLOCK_SEGMENT (MAX_BLOCK_LENGTH * 2 + 4)	// maximum number of segments (data code period or 1ms interpolation piece) within block
+
+// Signal of one block is generated with satellite parameters at block start and block end.
+// Code phase is linearly interpolated. Carrier phase is linearly interpolated (InterpolationLinear)
+// or by a parabola through start of previous block, start and end of current block evaluated at
+// every ms of the block (InterpolationQuadratic). For block length T and line of sight acceleration a,
+// maximum carrier phase error of linear interpolation is a*T^2/8 (0.5mm for T=20ms and a=10m/s^2,
+// 5mm or 0.026 cycle at L1 for a=100m/s^2). Quadratic interpolation leaves error of jerk j within j*T^3/15
+// plus a*(1ms)^2/8 between knots. First block after InitState() always uses linear interpolation.
+
 class CSatIfSignal
 {
 public:
-	CSatIfSignal(int MsSampleNumber, int SatIfFreq, GnssSystem SatSystem, int SatSignalIndex, unsigned char SatId);
+	CSatIfSignal(int MsSampleNumber, int SatIfFreq, GnssSystem SatSystem, int SatSignalIndex, unsigned char SatId, int BlockMs = 1, BlockInterpolation Interpolation = InterpolationLinear);
 	~CSatIfSignal();
+	void SetSatellite(int SatIfFreq, GnssSystem SatSystem, int SatSignalIndex, unsigned char SatId);	// reassign channel, InitState() to be called after
 	void InitState(GNSS_TIME CurTime, PSATELLITE_PARAM pSatParam, NavBit* pNavData);
-	void GetIfSample(GNSS_TIME CurTime);
+	GnssSystem GetSystem() { return System; }
+	int GetSignalIndex() { return SignalIndex; }
+	int GetSvid() { return Svid; }
+	void GetIfSample(GNSS_TIME CurTime);	// CurTime is end time of block
+	void AccumulateIfSample(GNSS_TIME CurTime, complex_number *Accumulator) { AccumulateIfSample(CurTime, (double *)Accumulator); }
+	template <typename T> void AccumulateIfSample(GNSS_TIME CurTime, T *Accumulator);	// T is double, float or short, real/imag interleaved
+	void PrepareBlock(GNSS_TIME CurTime);	// advance channel state to next block
+	template <typename T> void AccumulateIfRange(T *Accumulator, int StartSample, int Count);	// add part of block prepared by PrepareBlock()
+	template <typename T> double GetSampleTypeError(GNSS_TIME CurTime, double &SignalPower);
 	complex_number *SampleArray;
 
 private:
-	int SampleNumber;	// sample number within 1ms
+	int SampleNumber;	// sample number within block
+	int MsSamples;	// sample number within 1ms
+	int BlockLength;	// block length in millisecond
+	BlockInterpolation InterpolationType;
 	int IfFreq;	// must be multiple of 500 (for GLONASS) or 1000 (other signal)
 	GnssSystem System;
 	int SignalIndex;
@@ -30,13 +53,19 @@ private:
 	int DataLength, PilotLength;
 	CSatelliteSignal SatelliteSignal;
 	PSATELLITE_PARAM SatParam;
-	double StartCarrierPhase, EndCarrierPhase;
+	double StartCarrierPhase, EndCarrierPhase, PrevCarrierPhase;	// PrevCarrierPhase is start carrier phase of previous block
+	int PrevPhaseValid;
 	GNSS_TIME StartTransmitTime, EndTransmitTime, SignalTime;
-	complex_number DataSignal, PilotSignal;
 	int GlonassHalfCycle, HalfCycleFlag;
+	// NCO state and data/pilot modulation of each segment within current block
+	double BlockAmp;
+	unsigned long long BlockCodePhase, BlockCodeStep;	// code NCO at block start and step (rounded)
+	int SegmentNumber;
+	int SegmentStart[MAX_BLOCK_SEGMENT + 1];	// first sample of each segment, last one is SampleNumber
+	unsigned long long SegmentCodePhase[MAX_BLOCK_SEGMENT];	// code NCO at first sample of segment
+	unsigned int SegmentCarrierPhase[MAX_BLOCK_SEGMENT], SegmentCarrierStep[MAX_BLOCK_SEGMENT];	// carrier NCO at first sample of segment
+	complex_number DataSignal[MAX_BLOCK_SEGMENT], PilotSignal[MAX_BLOCK_SEGMENT];
 
-	complex_number GetPrnValue(double &CurChip, double CodeStep);
-	complex_number GetRotateValue(double & CurPhase, double PhaseStep);
-	complex_number GetRotateValue(unsigned int & CurPhase, int PhaseStep);
-	void GenerateSamplesVectorized(int SampleCount, double& CurChip, double CodeStep, double& CurPhase, double PhaseStep, double Amp);
+	void GetChipAmplitude(int Segment, double Amp, int HasPilot, double DataReal[2], double DataImag[2], double PilotReal[2], double PilotImag[2]);
+	template <typename T> void GenerateSegment(T *Samples, int SampleCount, unsigned long long CodePhase, unsigned long long CodeStep, unsigned int CarrierPhase, unsigned int CarrierStep, int Segment, double Amp);
 };
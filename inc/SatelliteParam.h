@@ -12,10 +12,31 @@
 #include "ConstVal.h"
 #include "BasicTypes.h"
 #include "PowerControl.h"
+#include "Coordinate.h"
+#include "OrbitInterp.h"
+
+#define VISIBILITY_MIN_INTERVAL 1		// range of interval in millisecond between elevation evaluations of one satellite
+#define VISIBILITY_MAX_INTERVAL 30000
+#define VISIBILITY_NEVER 0x7fffffffffffffffLL	// check time of satellite that can never be visible
+
+// elevation of one satellite evaluated occasionally to track crossing of elevation mask
+// next evaluation is scheduled at half of the time to predicted crossing with current elevation rate,
+// so that evaluations get dense only around rise and set time
+typedef struct
+{
+	long long CheckTime;	// receiver time of next evaluation in millisecond since GPS epoch, 0 to evaluate on next call
+	double Elevation;		// elevation and its rate at last evaluation
+	double ElevationRate;
+	BOOL Visible;
+} SAT_VISIBILITY, *PSAT_VISIBILITY;
 
 int GetVisibleSatellite(KINEMATIC_INFO Position, GNSS_TIME time, OUTPUT_PARAM OutputParam, GnssSystem system, PGPS_EPHEMERIS Eph[], int Number, PGPS_EPHEMERIS EphVisible[]);
 int GetGlonassVisibleSatellite(KINEMATIC_INFO Position, GLONASS_TIME time, OUTPUT_PARAM OutputParam, PGLONASS_EPHEMERIS Eph[], int Number, PGLONASS_EPHEMERIS EphVisible[]);
-void GetSatelliteParam(KINEMATIC_INFO PositionEcef, LLA_POSITION PositionLla, GNSS_TIME time, GnssSystem system, PGPS_EPHEMERIS Eph, PIONO_PARAM IonoParam, PSATELLITE_PARAM SatelliteParam);
+void InitSatVisibility(SAT_VISIBILITY Visibility[], int Number);
+int UpdateVisibleSatellite(KINEMATIC_INFO Position, GNSS_TIME time, OUTPUT_PARAM OutputParam, GnssSystem system, PGPS_EPHEMERIS Eph[], int Number, SAT_VISIBILITY Visibility[], PGPS_EPHEMERIS EphVisible[]);
+void GetSatelliteParam(KINEMATIC_INFO PositionEcef, LLA_POSITION PositionLla, GNSS_TIME time, GnssSystem system, PGPS_EPHEMERIS Eph, PIONO_PARAM IonoParam, PSATELLITE_PARAM SatelliteParam, PGLONASS_ORBIT GloOrbit = NULL);
+void GetSatelliteParamBatch(KINEMATIC_INFO PositionEcef, LLA_POSITION PositionLla, GNSS_TIME time, GnssSystem system, PGPS_EPHEMERIS Eph[], int Number, PIONO_PARAM IonoParam, SATELLITE_PARAM SatelliteParam[]);
+void GetSatelliteParamInterp(KINEMATIC_INFO PositionEcef, LLA_POSITION PositionLla, GNSS_TIME time, GnssSystem system, PGPS_EPHEMERIS Eph[], int Number, PIONO_PARAM IonoParam, int Window, ORBIT_INTERP Interp[], SATELLITE_PARAM SatelliteParam[]);
 void GetSatelliteCN0(int PowerListCount, SIGNAL_POWER PowerList[], double DefaultCN0, enum ElevationAdjust Adjust, PSATELLITE_PARAM SatelliteParam);
 double GetWaveLength(int system, int SignalIndex, int FreqID);
 double GetTravelTime(PSATELLITE_PARAM SatelliteParam, int SignalIndex);
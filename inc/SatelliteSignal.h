@@ -14,6 +14,8 @@
 #include "SatelliteParam.h"
 #include "NavBit.h"
 
+#define MAX_FRAME_PERIOD 10000	// maximum number of code periods within one frame/subframe/page (F/NAV page of 1ms code)
+
 struct SignalAttribute
 {
 	int CodeLength;	// PRN length in unit of millisecond
@@ -44,7 +46,20 @@ public:
 	// variables used to calculate modulated signal
 	int CurrentFrame;		// frame number of data stream filling in Bits
 	int CurrentBitIndex;	// bit index used for current ms correlation result
-	int DataBits[1800];		// maximum 1800 encoded data bit for one subframe/page
+	unsigned long long DataBits[NAV_FRAME_WORDS(NAV_FRAME_MAX_BITS)];	// encoded data bits of current subframe/page, bit i at bit (i&63) of DataBits[i>>6]
+
+	// modulation symbols of current frame, resolved once per frame
+	// bit0 set for negative data (data bit x NH code), bit1 set for negative pilot (secondary code)
+	unsigned char SymbolStream[MAX_FRAME_PERIOD];
+	complex_number DataValue[2], PilotValue[2];	// data/pilot signal for positive/negative symbol
+	const unsigned int *SecondaryCode;
+	int SecondaryLength;
+	int NavParam;			// parameter to GetFrameData(), 1 for E1 and L5
+	int FrameBias;			// millisecond bias of frame to week boundary (1000 for E1)
+	int FrameWeek, FrameStartTime;	// week and millisecond of current frame start in unconverted transmit time
+
+	void SetSymbolConstants();
+	void FillSymbolStream(GNSS_TIME TransmitTime, int FrameStart);
 
 	// constant arrays for signal attributes and NH code
 	static const SignalAttribute SignalAttributes[32];
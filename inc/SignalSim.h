@@ -25,12 +25,19 @@
 #include "BCNav2Bit.h"
 #include "BCNav3Bit.h"
 #include "GNavBit.h"
+#include "NavBitComposer.h"
 #include "JsonParser.h"
 #include "XmlInterpreter.h"
 #include "JsonInterpreter.h"
 #include "SatelliteParam.h"
+#include "OrbitInterp.h"
 #include "SatelliteSignal.h"
 #include "SatIfSignal.h"
+#include "ChannelPool.h"
+#include "NoiseGenerator.h"
+#include "Quantizer.h"
+#include "IfFileWriter.h"
+#include "PipelineQueue.h"
 #include "Coordinate.h"
 #include "MessageOutput.h"
 
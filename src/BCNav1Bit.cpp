@@ -77,7 +77,7 @@ const char BCNav1Bit::B1CMatrixGen2[B1C_SUBFRAME2_SYMBOL_LENGTH*B1C_SUBFRAME2_SY
 "Qn=bFSU[NMmcRe^iWJm`5:O7]FjA_j^P0000FKO7[9njS?Hd3<Y_SKWSSMIOXd@11alDAKjU0dRQ0000ib7B@HTQe94gIH9N9EEi"
 "d:O5AQfm>hWKKcT=^eW4Ee[TEAd9=dgO0000`[Z_mlId?;4^DCSLWDVgQCZn8K5<<3<297cf0o:P0000PGDk]hca`l`[Zil>lii="
 "i5^ZgaKo7=b\\\\hQkGO32Nk1B[gJUWJQ^0000gd1fof]JVR2n:Xc>?:GjdXE1e\\S66P>1UIhK0n9@0000@ZBlSLMihNHdECN7Nmm@"
-"32^Zg?Ko7=8\\9hQ@GO8VNl1X[g3UWJQ50000gI1Bof2J?RCn:XcW?IG??=E1enS66P>lUIJK0n9A0000@ZB_SCM3hfHdECf7fmm@"
+"32^Zg?Ko7=8\\9hQ@GO8VNl1X[g3UWJQ50000gI1Bof2J?RCn:XcW?IG?\?=E1enS66P>lUIJK0n9A0000@ZB_SCM3hfHdECf7fmm@"
 "2>?=K:ZZkgaEEKnQN[aC8X4`bK2bQ]n60000A_@LZTm2:JS3L`Rja_U::cioVE74e1eX7_]Z0E>N0000N=L;oS]2ATAIWSTMTSGQ"
 "00000m0[0C0W000000000000K050W0=0?DW20000000000000000000000000H0h0000P0K00000_0c0^0k00000090b0L0Q0000"
 "000090^060n00000000000000H0n070G`4m`000000000000000000000000a0]000000d0G00000:0W0b010000b030]0b00000"
@@ -90,7 +90,7 @@ const char BCNav1Bit::B1CMatrixGen2[B1C_SUBFRAME2_SYMBOL_LENGTH*B1C_SUBFRAME2_SY
 "iYD]THJ3Vfn==_Zo4Wn5QSa3jTijoiZ80000lF1d3c^iHI64A3kKnA>HH7O@:=ea?j?SjF_J0=YX0000X]AUGf_<lclMg6c\\c6do"
 "ONQ?dPI4B;Z]]F3Ga1Z<oLn_ocOKGO3Q0000dnmb4b[OAM<aleVTZlaJnem1H]?DD5g6KEFI02NS0000Sil>?;=@C7Cnm87B788G"
 "=1gMU37bDFTRRVd^j]GE6H[kfU\\N;\\d10000UB[>b>E\\P:EI28?X32j3KF_[`RQooOXHNB\\70Il^0000^Mk<Q@hnV6iK_@6D6WW^"
-"32^Zg?oo7=8\\nhQ@GO8kNl1X[g3U@JQ50000gIHBof23?RCn:XcW8IG??=41enS6JP>lUIJo0n9A0000@ZB_1CJ3hfHdECf7fmm@"
+"32^Zg?oo7=8\\nhQ@GO8kNl1X[g3U@JQ50000gIHBof23?RCn:XcW8IG?\?=41enS6JP>lUIJo0n9A0000@ZB_1CJ3hfHdECf7fmm@"
 "6B:S2NmCWJ@oodlj5D@eHj<GH]6EP6l:00002<`iCi46KbeXTF[=@T51<F`kYo9LL7nkE8dm0XIR0000RSTM9JQ?c_c<`\\_W_VVP"
 "VY82GhJ3\\mn=g_`X4@D5c9S]QGijoi`Y0000GOSd3d5ihF>PA7MohA4hhm1SB=e??CK9jOiJ0PgV0000X2]Ue>EV_cla1>d\\c66X"
 "`FmnWeQQcE6MaW8<oi6RYA@N^W`;<Z8C0000WJ:\\QgP`eolX\\NT[6Joeef3@7aXSZHUA;JZQSaFL0000<n\\]@lZ`Bg:GOlgdg11<"
@@ -206,21 +206,23 @@ const char BCNav1Bit::B1CMatrixGen3[B1C_SUBFRAME3_SYMBOL_LENGTH*B1C_SUBFRAME3_SY
 
 BCNav1Bit::BCNav1Bit()
 {
+	FrameBitNumber = 1800;
+	BuildLDPCTable(B1CMatrixGen2, B1C_SUBFRAME2_SYMBOL_LENGTH, B1CTable2);
+	BuildLDPCTable(B1CMatrixGen2, B1C_SUBFRAME3_SYMBOL_LENGTH, B1CTable3);	// subframe 3 has been encoded with leading part of B1CMatrixGen2
 }
 
 BCNav1Bit::~BCNav1Bit()
 {
 }
 
-int BCNav1Bit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits)
+int BCNav1Bit::GetPackedFrame(GNSS_TIME StartTime, int svid, int Param, unsigned long long *PackedBits)
 {
 	int i, j, page, soh, how;
 	unsigned int Frame2Data[25];
 	unsigned int Frame3Data[11];
 	int Symbol2[200], Symbol3[88];
-	int bits2[1200], bits3[528];
+	unsigned long long bits2[NAV_FRAME_WORDS(1200)], bits3[NAV_FRAME_WORDS(528)];	// packed encoded bits of subframe 2 and 3
 	unsigned int value;
-	int *p1, *p2, *p3;
 
 	// data channel
 	if (svid < 1 || svid > 63)
@@ -242,9 +244,10 @@ int BCNav1Bit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBi
 		Symbol2[i*4+2] = (Frame2Data[i] >> 6) & 0x3f;
 		Symbol2[i*4+3] = Frame2Data[i] & 0x3f;
 	}
-	LDPCEncode(Symbol2, B1C_SUBFRAME2_SYMBOL_LENGTH, B1CMatrixGen2);		// do LDPC encode
+	LDPCEncode(Symbol2, B1C_SUBFRAME2_SYMBOL_LENGTH, B1CTable2);		// do LDPC encode
+	memset(bits2, 0, sizeof(bits2));
 	for (i = 0; i < 200; i ++)
-		AssignBits(Symbol2[i], 6, bits2+i*6);
+		AssignPackedBits(Symbol2[i], 6, bits2, i*6);
 
 	// generate CRC for subframe3
 	ComposeSubframe3(soh, ((HealthFlags[svid-1] & 0x20) ? 0x80 : 0) | ((IntegrityFlags[svid-1] & 0x1c) << 2) | (IntegrityFlags[svid-1] >> 11), 0, Frame3Data);
@@ -257,40 +260,36 @@ int BCNav1Bit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBi
 		Symbol3[i*4+2] = (Frame3Data[i] >> 6) & 0x3f;
 		Symbol3[i*4+3] = Frame3Data[i] & 0x3f;
 	}
-	LDPCEncode(Symbol3, B1C_SUBFRAME3_SYMBOL_LENGTH, B1CMatrixGen2);		// do LDPC encode
+	LDPCEncode(Symbol3, B1C_SUBFRAME3_SYMBOL_LENGTH, B1CTable3);		// do LDPC encode
+	memset(bits3, 0, sizeof(bits3));
 	for (i = 0; i < 88; i ++)
-		AssignBits(Symbol3[i], 6, bits3+i*6);
+		AssignPackedBits(Symbol3[i], 6, bits3, i*6);
 
-	// do interleaving
+	// do interleaving, 36 rows of 48 bits written column by column
+	memset(PackedBits, 0, sizeof(unsigned long long) * NAV_FRAME_WORDS(FrameBitNumber));
 	for (i = 0; i < 11; i ++)	// 11 round of subframe2, subframe2, subframe3
 	{
-		p1 = NavBits + 72 + i * 3;
-		p2 = NavBits + 73 + i * 3;
-		p3 = NavBits + 74 + i * 3;
 		for (j = 0; j < 48; j ++)
 		{
-			*p1 = bits2[i*96+j]; p1 += 36;
-			*p2 = bits2[i*96+48+j]; p2 += 36;
-			*p3 = bits3[i*48+j]; p3 += 36;
+			SET_PACKED_BIT(PackedBits, 72 + i * 3 + j * 36, GET_PACKED_BIT(bits2, i*96+j));
+			SET_PACKED_BIT(PackedBits, 73 + i * 3 + j * 36, GET_PACKED_BIT(bits2, i*96+48+j));
+			SET_PACKED_BIT(PackedBits, 74 + i * 3 + j * 36, GET_PACKED_BIT(bits3, i*48+j));
 		}
 	}
 	// last three rows of subframe2
-	p1 = NavBits + 105;
-	p2 = NavBits + 106;
-	p3 = NavBits + 107;
 	for (j = 0; j < 48; j ++)
 	{
-		*p1 = bits2[22*48+j]; p1 += 36;
-		*p2 = bits2[23*48+j]; p2 += 36;
-		*p3 = bits2[24*48+j]; p3 += 36;
+		SET_PACKED_BIT(PackedBits, 105 + j * 36, GET_PACKED_BIT(bits2, 22*48+j));
+		SET_PACKED_BIT(PackedBits, 106 + j * 36, GET_PACKED_BIT(bits2, 23*48+j));
+		SET_PACKED_BIT(PackedBits, 107 + j * 36, GET_PACKED_BIT(bits2, 24*48+j));
 	}
 
 	// add subframe 1
-	AssignBits(BCH_prn_table[svid], 21, NavBits);
+	AssignPackedBits(BCH_prn_table[svid], 21, PackedBits, 0);
 	value = (unsigned int)(BCH_soh_table[soh] >> 32);
-	AssignBits(value, 19, NavBits + 21);
+	AssignPackedBits(value, 19, PackedBits, 21);
 	value = (unsigned int)(BCH_soh_table[soh]);
-	AssignBits(value, 32, NavBits + 40);
+	AssignPackedBits(value, 32, PackedBits, 40);
 	return 0;
 }
 
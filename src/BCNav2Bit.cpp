@@ -68,13 +68,15 @@ const int BCNav2Bit::MessageOrder[20] = {
 
 BCNav2Bit::BCNav2Bit()
 {
+	FrameBitNumber = 600;
+	BuildLDPCTable(B2aMatrixGen, B2a_SYMBOL_LENGTH, B2aTable);
 }
 
 BCNav2Bit::~BCNav2Bit()
 {
 }
 
-int BCNav2Bit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits)
+int BCNav2Bit::GetPackedFrame(GNSS_TIME StartTime, int svid, int Param, unsigned long long *PackedBits)
 {
 	int i;
 	int sow, MessageType;
@@ -97,10 +99,11 @@ int BCNav2Bit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBi
 		Symbols[i*4+2] = (FrameData[i] >> 6) & 0x3f;
 		Symbols[i*4+3] = FrameData[i] & 0x3f;
 	}
-	LDPCEncode(Symbols, B2a_SYMBOL_LENGTH, B2aMatrixGen);		// do LDPC encode
-	AssignBits(0xe24de8, 24, NavBits);	// Preamble
+	LDPCEncode(Symbols, B2a_SYMBOL_LENGTH, B2aTable);		// do LDPC encode
+	memset(PackedBits, 0, sizeof(unsigned long long) * NAV_FRAME_WORDS(FrameBitNumber));
+	AssignPackedBits(0xe24de8, 24, PackedBits, 0);	// Preamble
 	for (i = 0; i < 96; i ++)
-		AssignBits(Symbols[i], 6, NavBits + 24 + i * 6);	// 96 encoded symbols
+		AssignPackedBits(Symbols[i], 6, PackedBits, 24 + i * 6);	// 96 encoded symbols
 	return 0;
 }
 
@@ -29,7 +29,7 @@ const char BCNav3Bit::B2bMatrixGen[B2b_SYMBOL_LENGTH*B2b_SYMBOL_LENGTH+1] = {
 "7?5@gG>[3?UFg_@JE`M:UBKb`WfjKFFTY[][1235327<\\J2:US5?5=:;42j7a\\nD]bLK:=RIGj?V5iBS4"
 "J6bKagc=_E[6DSAdR]5G7;=VH?S:UC6GneX<TDQb7;kd<l;B4YHE9N03D;FkD_L]X=QoWPmCh:R[bV:II"
 "Ul>ogO5ZMTBKIO39G9bFBV_o5<O=:KEFRZiZZm<L<88`P[VX?PDTDdX1m>?LmfjC[c]_Xd>aOl6NLQ;2>"
-"9Zhk]7]UY;HZinJB<>o\\HdU1^2nmDQZ\\_PaGViIhH?@RG8??=3^;X40Ei?N@iGS>aUIMc[jQ5m<ThRmLL"
+"9Zhk]7]UY;HZinJB<>o\\HdU1^2nmDQZ\\_PaGViIhH?@RG8?\?=3^;X40Ei?N@iGS>aUIMc[jQ5m<ThRmLL"
 "h?ROMG`Lf9UAKG@cEc]TUXLO`3GbSFdTY[o[[n37322<[nX:C8595=:anRC7n\\<DJLjK:=RmG?P>7iBQR"
 "YXH2_[A=FeLB_I2bJ6K`Lc;Z6]Ff;BBUl=M=ia8H8aaPTbY`L<HXHI`9QafYGTGSMgR;`Iej[fXD`nc<Q"
 "`4m[SOSaZ4Xl>A[BFnR@fVacnUY7]ll]6;LYW>5mZ=`^kB==XFm4m90NJ=7`>kMnLc5`i8Hhj742m^7oo"
@@ -102,13 +102,15 @@ const int BCNav3Bit::MessageOrder[6] = {
 
 BCNav3Bit::BCNav3Bit()
 {
+	FrameBitNumber = 1000;
+	BuildLDPCTable(B2bMatrixGen, B2b_SYMBOL_LENGTH, B2bTable);
 }
 
 BCNav3Bit::~BCNav3Bit()
 {
 }
 
-int BCNav3Bit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits)
+int BCNav3Bit::GetPackedFrame(GNSS_TIME StartTime, int svid, int Param, unsigned long long *PackedBits)
 {
 	int i;
 	int sow;
@@ -131,12 +133,13 @@ int BCNav3Bit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBi
 		Symbols[i*4+3] = (FrameData[i+1] >> 6) & 0x3f;
 		Symbols[i*4+4] = FrameData[i+1] & 0x3f;
 	}
-	LDPCEncode(Symbols, B2b_SYMBOL_LENGTH, B2bMatrixGen);		// do LDPC encode
-	AssignBits(0xeb90, 16, NavBits);	// Preamble
-	AssignBits(svid, 6, NavBits + 16);	// PRN
-	AssignBits(0, 6, NavBits + 22);	// reserved
+	LDPCEncode(Symbols, B2b_SYMBOL_LENGTH, B2bTable);		// do LDPC encode
+	memset(PackedBits, 0, sizeof(unsigned long long) * NAV_FRAME_WORDS(FrameBitNumber));
+	AssignPackedBits(0xeb90, 16, PackedBits, 0);	// Preamble
+	AssignPackedBits(svid, 6, PackedBits, 16);	// PRN
+	AssignPackedBits(0, 6, PackedBits, 22);	// reserved
 	for (i = 0; i < 162; i ++)
-		AssignBits(Symbols[i], 6, NavBits + 28 + i * 6);	// 162 encoded symbols
+		AssignPackedBits(Symbols[i], 6, PackedBits, 28 + i * 6);	// 162 encoded symbols
 	return 0;
 }
 
@@ -77,6 +77,8 @@ BCNavBit::BCNavBit()
 	memset(BdtUtcParam, 0, sizeof(BdtUtcParam));
 	memset(EopParam, 0, sizeof(EopParam));
 	memset(BgtoParam, 0, sizeof(BgtoParam));
+	LDPCReference = false;
+	LDPCCodeNumber = 0;
 }
 
 BCNavBit::~BCNavBit()
@@ -203,6 +205,7 @@ int BCNavBit::SetEphemeris(int svid, PGPS_EPHEMERIS Eph)
 	IntValue = UnscaleInt(Eph->tgd_ext[4], -34);	// TGD_B2b
 	Data[2] = COMPOSE_BITS(IntValue, 0, 12);
 
+	ClearFrameCache(svid);
 	return svid;
 }
 
@@ -221,6 +224,7 @@ int BCNavBit::SetAlmanac(GPS_ALMANAC Alm[])
 		}
 	}
 
+	ClearFrameCache();
 	return 0;
 }
 
@@ -288,7 +292,65 @@ int BCNavBit::AppendCRC(unsigned int DataStream[], int Length)
 	return 0;
 }
 
-int BCNavBit::LDPCEncode(int SymbolStream[], int SymbolLength, const char *MatrixGen)
+// MatrixGen has SymbolLength rows of SymbolLength characters, each character is '0' plus GF(64) element
+// parity symbol i is sum of MatrixGen[i][j]*Symbol[j] over j, as multiplication is linear in GF(2),
+// MatrixGen[i][j]*Symbol[j] = MatrixGen[i][j]*(Symbol[j]&7) ^ MatrixGen[i][j]*(Symbol[j]&0x38)
+// so for each information symbol j, Table holds 8 products with low 3bit and 8 products with high 3bit
+// each product is a column of all SymbolLength parity symbols packed in 64bit words, one symbol in each byte
+void BCNavBit::BuildLDPCTable(const char *MatrixGen, int SymbolLength, unsigned long long Table[])
+{
+	int i, j, k, Words = LDPC_TABLE_WORDS(SymbolLength);
+	unsigned long long *Column;
+
+	if (LDPCCodeNumber < LDPC_MAX_CODE)	// keep generator matrix for reference encode
+	{
+		LDPCSymbolLength[LDPCCodeNumber] = SymbolLength;
+		LDPCMatrixGen[LDPCCodeNumber] = MatrixGen;
+		LDPCTable[LDPCCodeNumber ++] = Table;
+	}
+	for (j = 0; j < SymbolLength; j ++)
+		for (k = 0; k < 16; k ++)
+		{
+			Column = Table + (j * 16 + k) * Words;
+			for (i = 0; i < Words; i ++)
+				Column[i] = 0;
+			for (i = 0; i < SymbolLength; i ++)
+				Column[i / 8] |= (unsigned long long)GF6IntMul(MatrixGen[i * SymbolLength + j] - '0', (k < 8) ? k : ((k - 8) << 3)) << ((i & 7) * 8);
+		}
+}
+
+// SymbolLength information symbols in SymbolStream followed by SymbolLength parity symbols
+// each information symbol adds two columns of Table, 8 parity symbols in one XOR
+// if LDPCReference is set, LDPCEncodeReference() with generator matrix of Table is used instead
+int BCNavBit::LDPCEncode(int SymbolStream[], int SymbolLength, const unsigned long long Table[])
+{
+	int i, j, Words = LDPC_TABLE_WORDS(SymbolLength);
+	unsigned long long Parity[LDPC_TABLE_WORDS(LDPC_MAX_SYMBOL)];
+	const unsigned long long *Low, *High;
+
+	if (LDPCReference)
+	{
+		for (i = 0; i < LDPCCodeNumber; i ++)
+			if (LDPCTable[i] == Table)
+				return LDPCEncodeReference(SymbolStream, SymbolLength, LDPCMatrixGen[i]);
+	}
+	for (i = 0; i < Words; i ++)
+		Parity[i] = 0;
+	for (j = 0; j < SymbolLength; j ++, Table += 16 * Words)
+	{
+		Low = Table + (SymbolStream[j] & 7) * Words;
+		High = Table + (8 + ((SymbolStream[j] >> 3) & 7)) * Words;
+		for (i = 0; i < Words; i ++)
+			Parity[i] ^= Low[i] ^ High[i];
+	}
+	for (i = 0; i < SymbolLength; i ++)
+		SymbolStream[SymbolLength + i] = (int)(Parity[i / 8] >> ((i & 7) * 8)) & 0x3f;
+
+	return 0;
+}
+
+// reference encoder multiplying each generator matrix entry with information symbol, result same as LDPCEncode()
+int BCNavBit::LDPCEncodeReference(int SymbolStream[], int SymbolLength, const char *MatrixGen)
 {
 	int i, j;
 	int *Parity;
@@ -319,6 +381,46 @@ int BCNavBit::GF6IntMul(int a, int b)
 		return 0;
 }
 
+// get generator matrix and encode table of LDPC code Index in the order of BuildLDPCTable() calls
+// return number of information symbols, 0 if Index out of range
+int BCNavBit::GetLDPCCode(int Index, const char *&MatrixGen, const unsigned long long *&Table)
+{
+	if (Index < 0 || Index >= LDPCCodeNumber)
+		return 0;
+	MatrixGen = LDPCMatrixGen[Index];
+	Table = LDPCTable[Index];
+	return LDPCSymbolLength[Index];
+}
+
+// encode FrameNumber frames with interval FrameLength millisecond from StartTime for svid 1 to 63
+// with table and reference encoder, return number of frames with different data bits
+int BCNavBit::VerifyLDPC(GNSS_TIME StartTime, int FrameLength, int FrameNumber, int &FrameCompared)
+{
+	int i, svid, Mismatch = 0;
+	int TableBits[NAV_FRAME_MAX_BITS], ReferenceBits[NAV_FRAME_MAX_BITS];
+	GNSS_TIME FrameTime;
+
+	FrameCompared = 0;
+	for (svid = 1; svid <= 63; svid ++)
+		for (i = 0; i < FrameNumber; i ++)
+		{
+			FrameTime = StartTime;
+			FrameTime.MilliSeconds += i * FrameLength;
+			memset(TableBits, 0, sizeof(TableBits));
+			memset(ReferenceBits, 0, sizeof(ReferenceBits));
+			LDPCReference = false;
+			GetFrameData(FrameTime, svid, 0, TableBits);
+			LDPCReference = true;
+			GetFrameData(FrameTime, svid, 0, ReferenceBits);
+			FrameCompared ++;
+			if (memcmp(TableBits, ReferenceBits, sizeof(TableBits)) != 0)
+				Mismatch ++;
+		}
+	LDPCReference = false;
+
+	return Mismatch;
+}
+
 int BCNavBit::FillBdsAlmanacPage(PGPS_ALMANAC Almanac, unsigned int MidiAlm[8], unsigned int ReducedAlm[2])
 {
 	signed int IntValue;
@@ -928,18 +928,24 @@ const unsigned int CNav2Bit::L1CMatrixGen3[L1C_SUBFRAME3_SYMBOL_LENGTH*9] = {
 
 CNav2Bit::CNav2Bit()
 {
+	FrameBitNumber = 1800;
+	memset(Subframe2, 0, sizeof(Subframe2));
+	memset(Subframe3, 0, sizeof(Subframe3));
+	memset(ISC, 0, sizeof(ISC));
+	BuildLDPCTable(L1CMatrixGen2, L1C_SUBFRAME2_SYMBOL_LENGTH, 19, L1CTable2);
+	BuildLDPCTable(L1CMatrixGen3, L1C_SUBFRAME3_SYMBOL_LENGTH, 9, L1CTable3);
 }
 
 CNav2Bit::~CNav2Bit()
 {
 }
 
-int CNav2Bit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits)
+int CNav2Bit::GetPackedFrame(GNSS_TIME StartTime, int svid, int Param, unsigned long long *PackedBits)
 {
 	int i, j, page, toi, itow;
 	unsigned int Stream[19];
-	int bits[1748], *p;
-	unsigned int *data, value;
+	unsigned long long bits[NAV_FRAME_WORDS(1748)];	// packed encoded bits of subframe 2 and 3
+	unsigned int *data, value, msb;
 
 	// data channel
 	if (svid < 1 || svid > 32)
@@ -958,24 +964,26 @@ int CNav2Bit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBit
 	Stream[0] |= COMPOSE_BITS(itow, 11, 8);
 	// generate CRC for subframe2
 	Stream[18] = Crc24qEncode(Stream, 576) << 8;
-	LDPCEncode(Stream, bits, L1C_SUBFRAME2_SYMBOL_LENGTH, 19, L1CMatrixGen2);		// do LDPC encode
+	memset(bits, 0, sizeof(bits));
+	LDPCEncode(Stream, bits, 0, L1C_SUBFRAME2_SYMBOL_LENGTH, 19, L1CTable2);		// do LDPC encode
 
 	// generate CRC for subframe3
 	GetSubframe3Data(svid, 0, Stream);
-	LDPCEncode(Stream, bits + 1200, L1C_SUBFRAME3_SYMBOL_LENGTH, 9, L1CMatrixGen3);		// do LDPC encode
+	LDPCEncode(Stream, bits, 1200, L1C_SUBFRAME3_SYMBOL_LENGTH, 9, L1CTable3);		// do LDPC encode
 
-	// do interleaving
-	p = NavBits + 52;
+	// do interleaving, 38 rows of 46 bits written column by column
+	memset(PackedBits, 0, sizeof(unsigned long long) * NAV_FRAME_WORDS(FrameBitNumber));
 	for (i = 0; i < 46; i ++)
 		for (j = 0; j < 38; j ++)
-			*p ++ = bits[j * 46 + i];
+			SET_PACKED_BIT(PackedBits, 52 + i * 38 + j, GET_PACKED_BIT(bits, j * 46 + i));
 
 	// add subframe 1
-	NavBits[0] = (toi & 0x100) ? 1 : 0;	// MSB of TOI
-	value = (unsigned int)(BCH_toi_table[toi & 0xff] >> 32) ^ (NavBits[0] ? 0x7ffff : 0);	// modulo-2 add MSB
-	AssignBits(value, 19, NavBits + 1);
-	value = (unsigned int)(BCH_toi_table[toi & 0xff]) ^ (NavBits[0] ? 0xffffffff : 0);	// modulo-2 add MSB
-	AssignBits(value, 32, NavBits + 20);
+	msb = (toi & 0x100) ? 1 : 0;	// MSB of TOI
+	SET_PACKED_BIT(PackedBits, 0, msb);
+	value = (unsigned int)(BCH_toi_table[toi & 0xff] >> 32) ^ (msb ? 0x7ffff : 0);	// modulo-2 add MSB
+	AssignPackedBits(value, 19, PackedBits, 1);
+	value = (unsigned int)(BCH_toi_table[toi & 0xff]) ^ (msb ? 0xffffffff : 0);	// modulo-2 add MSB
+	AssignPackedBits(value, 32, PackedBits, 20);
 	return 0;
 }
 
@@ -984,6 +992,7 @@ int CNav2Bit::SetEphemeris(int svid, PGPS_EPHEMERIS Eph)
 	if (svid < 1 || svid > 32 || !Eph || !Eph->valid)
 		return 0;
 	ComposeSubframe2(Eph, Subframe2[svid-1], ISC[svid-1]);
+	ClearFrameCache(svid);
 	return svid;
 }
 
@@ -1136,11 +1145,60 @@ int CNav2Bit::SetIonoUtc(PIONO_PARAM IonoParam, PUTC_PARAM UtcParam)
 	SubFrameData[5] |= COMPOSE_BITS(IntValue, 10, 8);
 
 	SubFrameData[6] = SubFrameData[7] = 0;	// fill reset of 74bits to 0
+	ClearFrameCache();
 	return 0;
 
 }
 
-void CNav2Bit::LDPCEncode(unsigned int Stream[], int bits[], int SymbolLength, int TableSize, const unsigned int MatrixGen[])
+// MatrixGen has SymbolLength rows of TableSize DWORDs, parity bit i is XOR of all bits of Stream[j] & MatrixGen[i][j]
+// the transposed matrix is stored as contribution of each 4bit group of Stream to all parity bits,
+// Table has 16 entries for each group (8 groups in each DWORD, MSB first), each entry has SymbolLength parity bits packed in 64bit words
+void CNav2Bit::BuildLDPCTable(const unsigned int MatrixGen[], int SymbolLength, int TableSize, unsigned long long Table[])
+{
+	int i, j, k, value, Words = L1C_LDPC_WORDS(SymbolLength);
+	unsigned long long *Entry;
+
+	for (j = 0; j < TableSize; j ++)
+		for (k = 0; k < 8; k ++)
+			for (value = 0; value < 16; value ++)
+			{
+				Entry = Table + ((j * 8 + k) * 16 + value) * Words;
+				for (i = 0; i < Words; i ++)
+					Entry[i] = 0;
+				for (i = 0; i < SymbolLength; i ++)
+					Entry[i / 64] |= (unsigned long long)XorBits(MatrixGen[i * TableSize + j] & ((unsigned int)value << (28 - k * 4))) << (i & 63);
+			}
+}
+
+// information bits and parity bits ORed into packed Bits[] from StartBit, Bits[] cleared by caller
+void CNav2Bit::LDPCEncode(unsigned int Stream[], unsigned long long Bits[], int StartBit, int SymbolLength, int TableSize, const unsigned long long Table[])
+{
+	int i, j, k, RemBits, Words = L1C_LDPC_WORDS(SymbolLength);
+	unsigned long long Parity[L1C_LDPC_WORDS(L1C_SUBFRAME2_SYMBOL_LENGTH)];
+	const unsigned long long *Entry;
+
+	// first assign bits in Stream into Bits[]
+	for (i = 0; i < SymbolLength / 32; i ++)
+		AssignPackedBits(Stream[i], 32, Bits, StartBit + i * 32);
+	RemBits = SymbolLength & 0x1f;
+	if (RemBits)
+		AssignPackedBits(Stream[i] >> (32 - RemBits), RemBits, Bits, StartBit + i * 32);
+
+	// generate LDPC check bits, 64 parity bits in one XOR
+	for (i = 0; i < Words; i ++)
+		Parity[i] = 0;
+	for (j = 0; j < TableSize; j ++)
+		for (k = 0; k < 8; k ++, Table += 16 * Words)
+		{
+			Entry = Table + ((Stream[j] >> (28 - k * 4)) & 0xf) * Words;
+			for (i = 0; i < Words; i ++)
+				Parity[i] ^= Entry[i];
+		}
+	CopyPackedBits(Parity, SymbolLength, Bits, StartBit + SymbolLength);
+}
+
+// reference encoder with one parity bit per matrix row, result same as LDPCEncode()
+void CNav2Bit::LDPCEncodeReference(unsigned int Stream[], int bits[], int SymbolLength, int TableSize, const unsigned int MatrixGen[])
 {
 	int i, j, RemBits, parity_bit;
 	unsigned int AndResult;
@@ -1165,6 +1223,68 @@ void CNav2Bit::LDPCEncode(unsigned int Stream[], int bits[], int SymbolLength, i
 	}
 }
 
+// get generator matrix, encode table and DWORDs of input stream of subframe 2 (Index 0) or subframe 3 (Index 1)
+// return number of information bits, 0 if Index out of range
+int CNav2Bit::GetLDPCCode(int Index, const unsigned int *&MatrixGen, const unsigned long long *&Table, int &TableSize)
+{
+	if (Index == 0)
+	{
+		MatrixGen = L1CMatrixGen2;
+		Table = L1CTable2;
+		TableSize = 19;
+		return L1C_SUBFRAME2_SYMBOL_LENGTH;
+	}
+	else if (Index == 1)
+	{
+		MatrixGen = L1CMatrixGen3;
+		Table = L1CTable3;
+		TableSize = 9;
+		return L1C_SUBFRAME3_SYMBOL_LENGTH;
+	}
+	return 0;
+}
+
+// encode subframe 2 and 3 of FrameNumber frames from StartTime for PRN 1 to 63 with table and reference encoder
+// PRN beyond 32 has no ephemeris and ISC, so only WN, ITOW and PRN fields are filled
+// return number of subframes with different encoded bits
+int CNav2Bit::VerifyLDPC(GNSS_TIME StartTime, int FrameNumber, int &SubframeCompared)
+{
+	int i, j, svid, page, itow, Mismatch = 0;
+	unsigned int Stream[19];
+	int ReferenceBits[L1C_SUBFRAME2_SYMBOL_LENGTH*2];
+	unsigned long long TableWords[NAV_FRAME_WORDS(L1C_SUBFRAME2_SYMBOL_LENGTH*2)], ReferenceWords[NAV_FRAME_WORDS(L1C_SUBFRAME2_SYMBOL_LENGTH*2)];
+
+	SubframeCompared = 0;
+	for (svid = 1; svid <= 63; svid ++)
+		for (i = 0; i < FrameNumber; i ++)
+		{
+			page = StartTime.MilliSeconds / 18000 + i;
+			itow = page / 400;
+			for (j = 0; j < 18; j ++)
+				Stream[j] = (svid <= 32) ? Subframe2[svid-1][j] : 0;
+			Stream[0] |= COMPOSE_BITS(StartTime.Week, 19, 13);
+			Stream[0] |= COMPOSE_BITS(itow, 11, 8);
+			Stream[18] = Crc24qEncode(Stream, 576) << 8;
+			memset(TableWords, 0, sizeof(TableWords));
+			LDPCEncode(Stream, TableWords, 0, L1C_SUBFRAME2_SYMBOL_LENGTH, 19, L1CTable2);
+			LDPCEncodeReference(Stream, ReferenceBits, L1C_SUBFRAME2_SYMBOL_LENGTH, 19, L1CMatrixGen2);
+			PackBits(ReferenceBits, L1C_SUBFRAME2_SYMBOL_LENGTH * 2, ReferenceWords);
+			if (memcmp(TableWords, ReferenceWords, sizeof(unsigned long long) * NAV_FRAME_WORDS(L1C_SUBFRAME2_SYMBOL_LENGTH * 2)) != 0)
+				Mismatch ++;
+
+			GetSubframe3Data(svid, 0, Stream);
+			memset(TableWords, 0, sizeof(TableWords));
+			LDPCEncode(Stream, TableWords, 0, L1C_SUBFRAME3_SYMBOL_LENGTH, 9, L1CTable3);
+			LDPCEncodeReference(Stream, ReferenceBits, L1C_SUBFRAME3_SYMBOL_LENGTH, 9, L1CMatrixGen3);
+			PackBits(ReferenceBits, L1C_SUBFRAME3_SYMBOL_LENGTH * 2, ReferenceWords);
+			if (memcmp(TableWords, ReferenceWords, sizeof(unsigned long long) * NAV_FRAME_WORDS(L1C_SUBFRAME3_SYMBOL_LENGTH * 2)) != 0)
+				Mismatch ++;
+			SubframeCompared += 2;
+		}
+
+	return Mismatch;
+}
+
 int CNav2Bit::XorBits(unsigned int Data)
 {
 	Data ^= (Data >> 1);
@@ -1182,7 +1302,7 @@ void CNav2Bit::GetSubframe3Data(int Svid, int PageIndex, unsigned int Subframe3D
 	memcpy(Subframe3Data, Subframe3[PageIndex], sizeof(unsigned int) * 8);
 	Subframe3Data[0] &= 0x3ffff;	// clear MSB and PRN field
 	Subframe3Data[0] |= (Svid << 18);	// put transmitting PRN
-	if (PageIndex == PAGE_INDEX_IONO_UTC)	// page1 append ISC
+	if (PageIndex == PAGE_INDEX_IONO_UTC && Svid <= 32)	// page1 append ISC
 	{
 		Subframe3Data[5] |= COMPOSE_BITS(ISC[Svid-1][0] >> 16, 0, 10);
 		Subframe3Data[6] = COMPOSE_BITS(ISC[Svid-1][0], 16, 16);
@@ -17,6 +17,7 @@
 
 CNavBit::CNavBit()
 {
+	FrameBitNumber = 600;
 	memset(EphMessage, 0, sizeof(EphMessage));
 	memset(MidiAlm, 0, sizeof(MidiAlm));
 	memset(ReducedAlm, 0, sizeof(ReducedAlm));
@@ -26,6 +27,10 @@ CNavBit::CNavBit()
 	memset(UTCMessage, 0, sizeof(UTCMessage));
 	memset(ConvEncodeBitsL2, 0, sizeof(ConvEncodeBitsL2));
 	memset(ConvEncodeBitsL5, 0, sizeof(ConvEncodeBitsL5));
+	memset(ConvStartBitsL2, 0, sizeof(ConvStartBitsL2));
+	memset(ConvStartBitsL5, 0, sizeof(ConvStartBitsL5));
+	memset(LastMessageL2, 0xff, sizeof(LastMessageL2));
+	memset(LastMessageL5, 0xff, sizeof(LastMessageL5));
 	TOA = INVALID_TOA;
 }
 
@@ -43,17 +48,19 @@ CNavBit::~CNavBit()
 // each super frame has 8 message 31 each has 4 reduced amlamanc
 // each super frame has 32 message 37, message index 3 contains SV01 to SV24, message index 2 contains SV25 to SV32
 // Param is used to distinguish from Dc in L2C and D5 in L5 (0 for L2C)
-int CNavBit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits)
+int CNavBit::GetPackedFrame(GNSS_TIME StartTime, int svid, int Param, unsigned long long *PackedBits)
 {
-	int i, j, TOW, message, BitCount;
+	int i, TOW, message, BitCount, MessageIndex;
 	unsigned int EncodeData[9], CrcResult, EncodeWord;	// 276bit to be encoded by CRC
 	unsigned char EncodeMessage[75], ConvEncodeBits;	// EncodeMessage contains 8x75 bits
+	unsigned char *EncodeState = Param ? ConvEncodeBitsL5 : ConvEncodeBitsL2, *StartState = Param ? ConvStartBitsL5 : ConvStartBitsL2;
+	int *LastMessage = Param ? LastMessageL5 : LastMessageL2;
 
 	// validate svid to prevent out-of-bounds array access
 	if (svid < 1 || svid > 32)
 	{
-		// fill NavBits with zeros for invalid svid
-		memset(NavBits, 0, sizeof(int) * 600);
+		// fill PackedBits with zeros for invalid svid
+		memset(PackedBits, 0, sizeof(unsigned long long) * NAV_FRAME_WORDS(FrameBitNumber));
 		return -1;
 	}
 
@@ -61,6 +68,7 @@ int CNavBit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits
 	StartTime.Week += StartTime.MilliSeconds / 604800000;
 	StartTime.MilliSeconds %= 604800000;
 	TOW = StartTime.MilliSeconds / (Param ? 6000 : 12000);
+	MessageIndex = StartTime.Week * (Param ? 100800 : 50400) + TOW;
 	message = TOW % 100;	// message index within super frame
 	TOW ++;		// TOW is the time of NEXT message
 	if (!Param)
@@ -72,7 +80,14 @@ int CNavBit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits
 	CrcResult = Crc24qEncode(EncodeData, 276);
 
 	// do convolution encode (EncodeData[0] bit22 through EncodeData[6] bit0)
-	ConvEncodeBits = Param ? ConvEncodeBitsL5[svid-1] : ConvEncodeBitsL2[svid-1];
+	// the same message encoded again (frame evicted or cleared from cache) starts from the same state,
+	// so symbols are identical to the first encode and the state is not advanced twice
+	if (LastMessage[svid-1] != MessageIndex)
+	{
+		StartState[svid-1] = EncodeState[svid-1];
+		LastMessage[svid-1] = MessageIndex;
+	}
+	ConvEncodeBits = StartState[svid-1];
 	EncodeWord = EncodeData[0] << 12;	// move to MSB
 	for (i = 0, BitCount = 12; i < 276 / 2; i ++)
 	{
@@ -84,15 +99,12 @@ int CNavBit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits
 	EncodeWord = CrcResult << 8;
 	for (; i < 300 / 2; i ++)	// encode CRC
 		EncodeMessage[i/2] = (EncodeMessage[i/2] << 4) + ConvolutionEncodePair(ConvEncodeBits, EncodeWord);
-	if (Param)
-		ConvEncodeBitsL5[svid-1] = ConvEncodeBits;
-	else
-		ConvEncodeBitsL2[svid-1] = ConvEncodeBits;
+	EncodeState[svid-1] = ConvEncodeBits;
 
-	// put into NavBits
+	// put into PackedBits
+	memset(PackedBits, 0, sizeof(unsigned long long) * NAV_FRAME_WORDS(FrameBitNumber));
 	for (i = 0; i < 75; i ++)
-		for (j = 0, ConvEncodeBits = 0x80; j < 8; j ++, ConvEncodeBits >>= 1)
-			*(NavBits ++) = (EncodeMessage[i] & ConvEncodeBits) ? 1 : 0;
+		AssignPackedBits(EncodeMessage[i], 8, PackedBits, i * 8);
 
 	return 0;
 }
@@ -102,6 +114,7 @@ int CNavBit::SetEphemeris(int svid, PGPS_EPHEMERIS Eph)
 	if (svid < 1 || svid > 32 || !Eph || !Eph->valid)
 		return 0;
 	ComposeEphWords(Eph, EphMessage[svid-1], ClockMessage[svid-1], DelayMessage[svid-1]);
+	ClearFrameCache(svid);
 	return svid;
 }
 
@@ -115,6 +128,7 @@ int CNavBit::SetAlmanac(GPS_ALMANAC Alm[])
 		if ((Alm[i].valid & 1) && TOA == INVALID_TOA)
 			TOA = (Alm[i].week << 8) + (Alm[i].toa >> 12);
 	}
+	ClearFrameCache();
 	return 0;
 }
 
@@ -160,6 +174,7 @@ int CNavBit::SetIonoUtc(PIONO_PARAM IonoParam, PUTC_PARAM UtcParam)
 	UTCMessage[3] |= COMPOSE_BITS(UtcParam->DN, 27, 4);
 	UTCMessage[3] |= COMPOSE_BITS(UtcParam->TLSF, 19, 8);
 
+	ClearFrameCache();
 	return 0;
 }
 
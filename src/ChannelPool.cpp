@@ -0,0 +1,70 @@
+//----------------------------------------------------------------------
+// ChannelPool.cpp:
+//   Implementation of pool of satellite IF signal channels
+//
+//          Copyright (C) 2020-2029 by Jun Mo, All rights reserved.
+//
+//----------------------------------------------------------------------
+
+#include "SatIfSignal.h"
+#include "ChannelPool.h"
+
+CChannelPool::CChannelPool()
+{
+	MsSamples = 0;
+	BlockLength = 1;
+	InterpolationType = InterpolationLinear;
+	FreeNumber = 0;
+	CreateCount = ReuseCount = 0;
+}
+
+CChannelPool::~CChannelPool()
+{
+	int i;
+
+	for (i = 0; i < FreeNumber; i ++)
+		delete FreeChannel[i];
+}
+
+void CChannelPool::SetSampleFormat(int MsSampleNumber, int BlockMs, BlockInterpolation Interpolation)
+{
+	int i;
+
+	for (i = 0; i < FreeNumber; i ++)
+		delete FreeChannel[i];
+	FreeNumber = 0;
+	MsSamples = MsSampleNumber;
+	BlockLength = BlockMs;
+	InterpolationType = Interpolation;
+}
+
+// prefer channel released by the same signal of the same satellite, then the most recently released one
+CSatIfSignal *CChannelPool::GetChannel(int SatIfFreq, GnssSystem SatSystem, int SatSignalIndex, unsigned char SatId)
+{
+	CSatIfSignal *Channel;
+	int i;
+
+	if (FreeNumber == 0)
+	{
+		CreateCount ++;
+		return new CSatIfSignal(MsSamples, SatIfFreq, SatSystem, SatSignalIndex, SatId, BlockLength, InterpolationType);
+	}
+	for (i = FreeNumber - 1; i >= 0; i --)
+		if (FreeChannel[i]->GetSystem() == SatSystem && FreeChannel[i]->GetSignalIndex() == SatSignalIndex && FreeChannel[i]->GetSvid() == (int)SatId)
+			break;
+	if (i < 0)
+		i = FreeNumber - 1;
+	Channel = FreeChannel[i];
+	FreeChannel[i] = FreeChannel[-- FreeNumber];
+	Channel->SetSatellite(SatIfFreq, SatSystem, SatSignalIndex, SatId);
+	ReuseCount ++;
+	return Channel;
+}
+
+void CChannelPool::ReleaseChannel(CSatIfSignal *Channel)
+{
+	if (FreeNumber < CHANNEL_POOL_SIZE)
+		FreeChannel[FreeNumber ++] = Channel;
+	else
+		delete Channel;
+}
@@ -14,11 +14,19 @@
 #define COARSE_STEP 30
 #define COS_5 0.99619469809174553
 #define SIN_5 0.087155742747658173559
+#define PIO2_1 1.57079632673412561417e+00	// first 33 bits of pi/2
+#define PIO2_2 6.07710050630396597660e-11	// next 33 bits of pi/2
+#define PIO2_3 2.02226624879595063154e-21	// pi/2 - PIO2_1 - PIO2_2
 
 static void RungeKutta(double h, double State[9]);
 static void CalcAcceleration(double *State, double *Acc);
 static void PredictState(double *State, double *State1, double *VelAcc, double Step);
 static void CisToCts(double *State, double DeltaT, PKINEMATIC_INFO pCtsPos, double *Acc);
+static double GlonassTimeDiff(double TimeDiff);
+static void GlonassInitState(PGLONASS_EPHEMERIS pEph, double State[9]);
+static void GlonassGridState(double State[9], double GridState[9]);
+static void GlonassGridStep(PGLONASS_EPHEMERIS pEph, double *GridState, double *NextGridState, double h);
+static void BdsGeoRotate(double delta_t, PKINEMATIC_INFO pPosVel, double Acc[3]);
 
 double GpsClockCorrection(PGPS_EPHEMERIS Eph, double TransmitTime)
 {
@@ -176,35 +184,7 @@ bool GpsSatPosSpeedEph(GnssSystem system, double TransmitTime, PGPS_EPHEMERIS pE
 	}
 
 	if (system == BdsSystem && pEph->svid <= 5)
-	{
-		// first rotate -5 degree
-		yp = pPosVel->y * COS_5 - pPosVel->z * SIN_5; // rotated y
-		pPosVel->z = pPosVel->z * COS_5 + pPosVel->y * SIN_5; // rotated z
-		yp_dot = pPosVel->vy * COS_5 - pPosVel->vz * SIN_5; // rotated vy
-		pPosVel->vz = pPosVel->vz * COS_5 + pPosVel->vy * SIN_5; // rotated vz
-		// rotate delta_t * CGS2000_OMEGDOTE
-		omega = CGCS2000_OMEGDOTE * delta_t;
-		sin_temp = sin(omega);
-		cos_temp = cos(omega);
-		pPosVel->y = yp * cos_temp - pPosVel->x * sin_temp;
-		pPosVel->x = pPosVel->x * cos_temp + yp * sin_temp;
-		pPosVel->vy = yp_dot * cos_temp - pPosVel->vx * sin_temp;
-		pPosVel->vx = pPosVel->vx * cos_temp + yp_dot * sin_temp;
-		// earth rotate compensation on velocity
-		pPosVel->vx += pPosVel->y * CGCS2000_OMEGDOTE;
-		pPosVel->vy -= pPosVel->x * CGCS2000_OMEGDOTE;
-		if (Acc)
-		{
-			// first rotate -5 degree
-			yp = Acc[1] * COS_5 - Acc[2] * SIN_5; // rotated ay
-			Acc[2] = Acc[2] * COS_5 + Acc[1] * SIN_5; // rotated az
-			Acc[1] = yp * cos_temp - Acc[0] * sin_temp;
-			Acc[0] = Acc[0] * cos_temp + yp * sin_temp;
-			// earth rotate compensation on acceleration
-			Acc[0] += pPosVel->vy * CGCS2000_OMEGDOTE;
-			Acc[1] -= pPosVel->vx * CGCS2000_OMEGDOTE;
-		}
-	}
+		BdsGeoRotate(delta_t, pPosVel, Acc);
 
 	// if ephemeris expire, return 0
 	if (fabs(delta_t) > 7200.0)
@@ -215,83 +195,301 @@ bool GpsSatPosSpeedEph(GnssSystem system, double TransmitTime, PGPS_EPHEMERIS pE
 		return true;
 }
 
+// rotate BDS GEO satellite position/velocity (and acceleration if not NULL) from orbit frame to CGCS2000
+static void BdsGeoRotate(double delta_t, PKINEMATIC_INFO pPosVel, double Acc[3])
+{
+	double yp, yp_dot, omega, sin_temp, cos_temp;
+
+	// first rotate -5 degree
+	yp = pPosVel->y * COS_5 - pPosVel->z * SIN_5; // rotated y
+	pPosVel->z = pPosVel->z * COS_5 + pPosVel->y * SIN_5; // rotated z
+	yp_dot = pPosVel->vy * COS_5 - pPosVel->vz * SIN_5; // rotated vy
+	pPosVel->vz = pPosVel->vz * COS_5 + pPosVel->vy * SIN_5; // rotated vz
+	// rotate delta_t * CGS2000_OMEGDOTE
+	omega = CGCS2000_OMEGDOTE * delta_t;
+	sin_temp = sin(omega);
+	cos_temp = cos(omega);
+	pPosVel->y = yp * cos_temp - pPosVel->x * sin_temp;
+	pPosVel->x = pPosVel->x * cos_temp + yp * sin_temp;
+	pPosVel->vy = yp_dot * cos_temp - pPosVel->vx * sin_temp;
+	pPosVel->vx = pPosVel->vx * cos_temp + yp_dot * sin_temp;
+	// earth rotate compensation on velocity
+	pPosVel->vx += pPosVel->y * CGCS2000_OMEGDOTE;
+	pPosVel->vy -= pPosVel->x * CGCS2000_OMEGDOTE;
+	if (Acc)
+	{
+		// first rotate -5 degree
+		yp = Acc[1] * COS_5 - Acc[2] * SIN_5; // rotated ay
+		Acc[2] = Acc[2] * COS_5 + Acc[1] * SIN_5; // rotated az
+		Acc[1] = yp * cos_temp - Acc[0] * sin_temp;
+		Acc[0] = Acc[0] * cos_temp + yp * sin_temp;
+		// earth rotate compensation on acceleration
+		Acc[0] += pPosVel->vy * CGCS2000_OMEGDOTE;
+		Acc[1] -= pPosVel->vx * CGCS2000_OMEGDOTE;
+	}
+}
+
+// sin/cos and atan2 used by batch evaluation, branchless so that loops calling them are vectorized by compiler
+// argument reduced to [-pi/4, pi/4] by multiple of pi/2 in three parts, accuracy within a few ulp for |x| < 1e5
+static inline void BatchSinCos(double x, double &SinValue, double &CosValue)
+{
+	int q = (int)(x * 0.63661977236758134308 + (x >= 0 ? 0.5 : -0.5));
+	double r = ((x - q * PIO2_1) - q * PIO2_2) - q * PIO2_3, z = r * r;
+	double s, c;
+
+	s = r + r * z * (((((1.58962301576546568060e-10 * z - 2.50507477628578072866e-8) * z + 2.75573136213857245213e-6) * z - 1.98412698295895385996e-4) * z + 8.33333333332211858878e-3) * z - 1.66666666666666307295e-1);
+	c = 1.0 - 0.5 * z + z * z * (((((-1.13585365213876817300e-11 * z + 2.08757008419747316778e-9) * z - 2.75573141792967388112e-7) * z + 2.48015872888517045348e-5) * z - 1.38888888888730564116e-3) * z + 4.16666666666665929218e-2);
+	SinValue = (q & 1) ? c : s;
+	CosValue = (q & 1) ? s : c;
+	SinValue = (q & 2) ? -SinValue : SinValue;
+	CosValue = ((q + 1) & 2) ? -CosValue : CosValue;
+}
+
+// atan of min(|x|,|y|)/max(|x|,|y|) within [0, 1] then map to quadrant
+static inline double BatchAtan2(double y, double x)
+{
+	double ay = fabs(y), ax = fabs(x);
+	double Max = (ax > ay) ? ax : ay, Min = (ax > ay) ? ay : ax;
+	double t = Min / ((Max > 0) ? Max : 1.0), Big, u, z, r;
+
+	Big = (t > 0.66) ? 1.0 : 0.0;	// reduce to (t-1)/(t+1) for large t, division done on all lanes
+	u = (t - Big) / (1.0 + Big * t);
+	z = u * u;
+	r = ((((-8.750608600031904122785e-1 * z - 1.615753718733365076637e1) * z - 7.500855792314704667340e1) * z - 1.228866684490136173410e2) * z - 6.485021904942025371773e1);
+	r = u + u * z * r / (((((z + 2.485846490142306297962e1) * z + 1.650270098316988542046e2) * z + 4.328810604912902668951e2) * z + 4.853903996359136964868e2) * z + 1.945506571482613964425e2);
+	r += Big * (PI / 4 + 3.061616997868382943065e-17);
+	r = (ay > ax) ? (PI / 2 - r) + 6.123233995736765886130e-17 : r;
+	r = (x < 0) ? (PI - r) + 1.2246467991473531772e-16 : r;
+	return (y < 0) ? -r : r;
+}
+
+// copy orbit parameters of Number satellites (at most EPH_BATCH_SIZE) into batch
+void SetEphemerisBatch(GnssSystem system, PGPS_EPHEMERIS Eph[], int Number, PEPHEMERIS_BATCH Batch)
+{
+	int i;
+
+	Batch->Number = (Number > EPH_BATCH_SIZE) ? EPH_BATCH_SIZE : Number;
+	for (i = 0; i < Batch->Number; i ++)
+	{
+		Batch->Eph[i] = Eph[i];
+		Batch->BdsGeo[i] = (system == BdsSystem && Eph[i]->svid <= 5) ? TRUE : FALSE;
+		Batch->toe[i] = Eph[i]->toe;
+		Batch->M0[i] = Eph[i]->M0;
+		Batch->n[i] = Eph[i]->n;
+		Batch->delta_n_dot[i] = Eph[i]->delta_n_dot;
+		Batch->ecc[i] = Eph[i]->ecc;
+		Batch->root_ecc[i] = Eph[i]->root_ecc;
+		Batch->w[i] = Eph[i]->w;
+		Batch->axis[i] = Eph[i]->axis;
+		Batch->axis_dot[i] = Eph[i]->axis_dot;
+		Batch->i0[i] = Eph[i]->i0;
+		Batch->idot[i] = Eph[i]->idot;
+		Batch->omega_t[i] = Eph[i]->omega_t;
+		Batch->omega_delta[i] = Eph[i]->omega_delta;
+		Batch->cuc[i] = Eph[i]->cuc;
+		Batch->cus[i] = Eph[i]->cus;
+		Batch->crc[i] = Eph[i]->crc;
+		Batch->crs[i] = Eph[i]->crs;
+		Batch->cic[i] = Eph[i]->cic;
+		Batch->cis[i] = Eph[i]->cis;
+	}
+}
+
+// same as GpsSatPosSpeedEph() without acceleration and ephemeris expire check,
+// satellite i in batch evaluated at TransmitTime[i] with result in PosVel[i]
+// each step loops over all satellites so that the loop is vectorized by compiler,
+// Kepler equation uses fixed 10 iterations (maximum of GpsSatPosSpeedEph()) on all satellites
+void GpsSatPosSpeedBatch(PEPHEMERIS_BATCH Batch, const double TransmitTime[], KINEMATIC_INFO PosVel[])
+{
+	int i, j;
+	double DeltaT[EPH_BATCH_SIZE], Mk[EPH_BATCH_SIZE];
+	double PosX[EPH_BATCH_SIZE], PosY[EPH_BATCH_SIZE], PosZ[EPH_BATCH_SIZE], VelX[EPH_BATCH_SIZE], VelY[EPH_BATCH_SIZE], VelZ[EPH_BATCH_SIZE];
+	double delta_t, alpha, Ek, Ek1, Ek_dot, SinEk, CosEk;
+	double phi, phi_dot, sin_temp, cos_temp;
+	double uk, rk, ik, uk_dot, rk_dot, ik_dot;
+	double xp, yp, xp_dot, yp_dot, omega, sin_omega, cos_omega, sin_ik, cos_ik;
+	double x, y, z;
+
+	// calculate time difference with protection for time ring back at week end
+	for (i = 0; i < Batch->Number; i ++)
+	{
+		delta_t = TransmitTime[i] - Batch->toe[i];
+		delta_t -= (delta_t > 302400.0) ? 604800.0 : 0.0;
+		delta_t += (delta_t < -302400.0) ? 604800.0 : 0.0;
+		DeltaT[i] = delta_t;
+		Batch->Ek[i] = Mk[i] = Batch->M0[i] + ((Batch->n[i] + Batch->delta_n_dot[i] * delta_t / 2) * delta_t);
+	}
+	// get Ek from Mk with recursive algorithm
+	for (j = 0; j < 10; j ++)
+		for (i = 0; i < Batch->Number; i ++)
+		{
+			BatchSinCos(Batch->Ek[i], SinEk, CosEk);
+			Batch->Ek[i] = Mk[i] + Batch->ecc[i] * SinEk;
+		}
+
+	for (i = 0; i < Batch->Number; i ++)
+	{
+		delta_t = DeltaT[i];
+		alpha = Batch->delta_n_dot[i] * delta_t;
+		Ek = Batch->Ek[i];
+		BatchSinCos(Ek, SinEk, CosEk);
+		Ek1 = 1.0 - (Batch->ecc[i] * CosEk);
+
+		// get u(k), r(k) and i(k) with 2nd order correction
+		phi = BatchAtan2(Batch->root_ecc[i] * SinEk, CosEk - Batch->ecc[i]) + Batch->w[i];
+		BatchSinCos(phi + phi, sin_temp, cos_temp);
+		uk = phi + (Batch->cuc[i] * cos_temp) + (Batch->cus[i] * sin_temp);
+		rk = (Batch->axis[i] + Batch->axis_dot[i] * delta_t) * Ek1 + (Batch->crc[i] * cos_temp) + (Batch->crs[i] * sin_temp);
+		ik = Batch->i0[i] + (Batch->idot[i] * delta_t) + (Batch->cic[i] * cos_temp) + (Batch->cis[i] * sin_temp);
+		// calculate derivatives of r(k), u(k) and i(k)
+		Batch->Ek_dot[i] = Ek_dot = (Batch->n[i] + alpha) / Ek1;
+		uk_dot = phi_dot = Ek_dot * Batch->root_ecc[i] / Ek1;
+		phi_dot = phi_dot * 2.0;
+		rk_dot = Batch->axis[i] * Batch->ecc[i] * SinEk * Ek_dot + Batch->axis_dot[i] * Ek1;
+		rk_dot += ((Batch->crs[i] * cos_temp) - (Batch->crc[i] * sin_temp)) * phi_dot;
+		uk_dot += ((Batch->cus[i] * cos_temp) - (Batch->cuc[i] * sin_temp)) * phi_dot;
+		ik_dot = Batch->idot[i] + ((Batch->cis[i] * cos_temp) - (Batch->cic[i] * sin_temp)) * phi_dot;
+
+		// calculate Xp and Yp and corresponding derivatives
+		BatchSinCos(uk, sin_temp, cos_temp);
+		xp = rk * cos_temp;
+		yp = rk * sin_temp;
+		xp_dot = rk_dot * cos_temp - yp * uk_dot;
+		yp_dot = rk_dot * sin_temp + xp * uk_dot;
+
+		// get final position and speed in ECEF coordinate
+		omega = Batch->omega_t[i] + Batch->omega_delta[i] * delta_t;
+		BatchSinCos(omega, sin_omega, cos_omega);
+		BatchSinCos(ik, sin_ik, cos_ik);
+		x = xp * cos_omega - yp * cos_ik * sin_omega;
+		y = xp * sin_omega + yp * cos_ik * cos_omega;
+		z = yp * sin_ik;
+		phi_dot = yp_dot * cos_ik - z * ik_dot;
+		PosX[i] = x;
+		PosY[i] = y;
+		PosZ[i] = z;
+		VelX[i] = xp_dot * cos_omega - phi_dot * sin_omega - y * Batch->omega_delta[i];
+		VelY[i] = xp_dot * sin_omega + phi_dot * cos_omega + x * Batch->omega_delta[i];
+		VelZ[i] = yp_dot * sin_ik + yp * ik_dot * cos_ik;
+	}
+
+	// copy result, write back Ek used for relativity correction and apply GEO rotation
+	for (i = 0; i < Batch->Number; i ++)
+	{
+		PosVel[i].x = PosX[i]; PosVel[i].y = PosY[i]; PosVel[i].z = PosZ[i];
+		PosVel[i].vx = VelX[i]; PosVel[i].vy = VelY[i]; PosVel[i].vz = VelZ[i];
+		Batch->Eph[i]->Ek = Batch->Ek[i];
+		Batch->Eph[i]->Ek_dot = Batch->Ek_dot[i];
+		if (Batch->BdsGeo[i])
+			BdsGeoRotate(DeltaT[i], &PosVel[i], NULL);
+	}
+}
+
 bool GlonassSatPosSpeedEph(double TransmitTime, PGLONASS_EPHEMERIS pEph, PKINEMATIC_INFO pPosVel, double Acc[3])
 {
 	double DeltaT, DeltaT1;
 	double State[9];
 	int i, StepNumber;
 
-	DeltaT = TransmitTime - (double)pEph->tb;
-	if (DeltaT > 43200.0)
-		DeltaT -= 86400.0;
-	else if (DeltaT < -43200.0)
-		DeltaT += 86400.0;
+	DeltaT = GlonassTimeDiff(TransmitTime - (double)pEph->tb);
 
 	// delta t correction according to satellite clock error and clock drift
 //	DeltaT += (pEph->tn + pEph->gamma * DeltaT);	
 
-	// if position and velocity at tc not yet calculated
-	if ((pEph->flag & 0x2) == 0)
+	// satellite position and velocity in CIS coordinate
+	GlonassInitState(pEph, State);
+	StepNumber = (int)DeltaT / COARSE_STEP;
+	if (StepNumber >= 0)
 	{
-		// satellite position and velocity in CIS coordinate
-		State[0] = pEph->x;
-		State[1] = pEph->y;
-		State[2] = pEph->z;
-		State[3] = pEph->vx - PZ90_OMEGDOTE * pEph->y;
-		State[4] = pEph->vy + PZ90_OMEGDOTE * pEph->x;
-		State[5] = pEph->vz;
-		State[6] = pEph->ax;
-		State[7] = pEph->ay;
-		State[8] = pEph->az;
-
-		StepNumber = (int)DeltaT / COARSE_STEP;
-		if (StepNumber >= 0)
+		for (i = StepNumber; i > 0; i --)
 		{
-			for (i = StepNumber; i > 0; i --)
-			{
-				RungeKutta(COARSE_STEP, State);
-			}
+			RungeKutta(COARSE_STEP, State);
 		}
-		else
-		{
-			for (i = StepNumber; i < 0; i ++)
-			{
-				RungeKutta(-COARSE_STEP, State);
-			}
-		}
-		DeltaT1 = DeltaT - StepNumber * COARSE_STEP;
 	}
-	// prediction from tc
 	else
 	{
-		State[0] = pEph->PosVelT.x;
-		State[1] = pEph->PosVelT.y;
-		State[2] = pEph->PosVelT.z;
-		State[3] = pEph->PosVelT.vx;
-		State[4] = pEph->PosVelT.vy;
-		State[5] = pEph->PosVelT.vz;
-		State[6] = pEph->ax;
-		State[7] = pEph->ay;
-		State[8] = pEph->az;
-		DeltaT1 = TransmitTime - pEph->tc;
-		if (DeltaT1 > 43200.0)
-			DeltaT1 -= 86400.0;
-		else if (DeltaT1 < -43200.0)
-			DeltaT1 += 86400.0;
-
-		// delta t correction according to satellite clock error and clock drift
-//		DeltaT1 += pEph->gamma * DeltaT1;
+		for (i = StepNumber; i < 0; i ++)
+		{
+			RungeKutta(-COARSE_STEP, State);
+		}
 	}
+	DeltaT1 = DeltaT - StepNumber * COARSE_STEP;
 	RungeKutta(DeltaT1, State);
-	
-	pEph->tc = TransmitTime;
-	pEph->flag |= 0x2;	// can predict from pEph->tc instead of pEph->tn
-	pEph->PosVelT.x = State[0];
-	pEph->PosVelT.y = State[1];
-	pEph->PosVelT.z = State[2];
-	pEph->PosVelT.vx = State[3];
-	pEph->PosVelT.vy = State[4];
-	pEph->PosVelT.vz = State[5];
+
+	// CIS to CTS(PZ-90) convertion
+	CisToCts(State, DeltaT, pPosVel, Acc);
+
+	return true;
+}
+
+void InitGlonassOrbit(GLONASS_ORBIT Orbit[], int Number)
+{
+	int i;
+
+	for (i = 0; i < Number; i ++)
+		Orbit[i].Eph = NULL;
+}
+
+// same result as GlonassSatPosSpeedEph() to sub-millimeter, but integration only done once for each grid step
+// and position/velocity within the step interpolated, fall back to GlonassSatPosSpeedEph() outside the grid
+bool GlonassSatPosSpeedOrbit(double TransmitTime, PGLONASS_EPHEMERIS pEph, PGLONASS_ORBIT Orbit, PKINEMATIC_INFO pPosVel, double Acc[3])
+{
+	double DeltaT, u, u2, u3, State[9];
+	double HermitePos[6], HermiteVel[6];
+	double *State0, *State1;
+	int i, Index;
+
+	DeltaT = GlonassTimeDiff(TransmitTime - (double)pEph->tb);
+	Index = (int)floor(DeltaT / GLONASS_GRID_STEP) + GLONASS_GRID_HALF;
+	if (Index < 0 || Index >= GLONASS_GRID_HALF * 2)
+		return GlonassSatPosSpeedEph(TransmitTime, pEph, pPosVel, Acc);
+
+	if (Orbit->Eph != pEph)
+	{
+		Orbit->Eph = pEph;
+		Orbit->First = Orbit->Last = GLONASS_GRID_HALF;
+		GlonassInitState(pEph, State);
+		GlonassGridState(State, Orbit->State[GLONASS_GRID_HALF]);
+	}
+	// extend grid to cover both ends of the step
+	while (Orbit->Last <= Index)
+	{
+		GlonassGridStep(pEph, Orbit->State[Orbit->Last], Orbit->State[Orbit->Last + 1], GLONASS_GRID_STEP);
+		Orbit->Last ++;
+	}
+	while (Orbit->First > Index)
+	{
+		GlonassGridStep(pEph, Orbit->State[Orbit->First], Orbit->State[Orbit->First - 1], -GLONASS_GRID_STEP);
+		Orbit->First --;
+	}
+
+	// quintic Hermite basis functions and their derivatives, with velocity and acceleration terms scaled by step
+	u = (DeltaT - (Index - GLONASS_GRID_HALF) * GLONASS_GRID_STEP) / GLONASS_GRID_STEP;
+	u2 = u * u; u3 = u2 * u;
+	HermitePos[0] = 1 + u3 * (-10 + u * (15 - 6 * u));
+	HermitePos[1] = (u + u3 * (-6 + u * (8 - 3 * u))) * GLONASS_GRID_STEP;
+	HermitePos[2] = u2 * (1 + u * (-3 + u * (3 - u))) * (0.5 * GLONASS_GRID_STEP * GLONASS_GRID_STEP);
+	HermitePos[3] = 1 - HermitePos[0];
+	HermitePos[4] = u3 * (-4 + u * (7 - 3 * u)) * GLONASS_GRID_STEP;
+	HermitePos[5] = u3 * (1 + u * (-2 + u)) * (0.5 * GLONASS_GRID_STEP * GLONASS_GRID_STEP);
+	HermiteVel[0] = u2 * (-30 + u * (60 - 30 * u)) / GLONASS_GRID_STEP;
+	HermiteVel[1] = 1 + u2 * (-18 + u * (32 - 15 * u));
+	HermiteVel[2] = u * (2 + u * (-9 + u * (12 - 5 * u))) * (0.5 * GLONASS_GRID_STEP);
+	HermiteVel[3] = -HermiteVel[0];
+	HermiteVel[4] = u2 * (-12 + u * (28 - 15 * u));
+	HermiteVel[5] = u2 * (3 + u * (-8 + 5 * u)) * (0.5 * GLONASS_GRID_STEP);
+	State0 = Orbit->State[Index];
+	State1 = Orbit->State[Index + 1];
+	for (i = 0; i < 3; i ++)
+	{
+		State[i] = HermitePos[0] * State0[i] + HermitePos[1] * State0[i+3] + HermitePos[2] * State0[i+6]
+		         + HermitePos[3] * State1[i] + HermitePos[4] * State1[i+3] + HermitePos[5] * State1[i+6];
+		State[i+3] = HermiteVel[0] * State0[i] + HermiteVel[1] * State0[i+3] + HermiteVel[2] * State0[i+6]
+		           + HermiteVel[3] * State1[i] + HermiteVel[4] * State1[i+3] + HermiteVel[5] * State1[i+6];
+	}
+	State[6] = pEph->ax;
+	State[7] = pEph->ay;
+	State[8] = pEph->az;
 
 	// CIS to CTS(PZ-90) convertion
 	CisToCts(State, DeltaT, pPosVel, Acc);
@@ -627,3 +825,54 @@ static void CisToCts(double *State, double DeltaT, PKINEMATIC_INFO pCtsPos, doub
 		Acc[1] -= State[4] * SinValue + State[3] * CosValue;
 	}
 }
+
+// protection for time ring back at day end
+static double GlonassTimeDiff(double TimeDiff)
+{
+	if (TimeDiff > 43200.0)
+		TimeDiff -= 86400.0;
+	else if (TimeDiff < -43200.0)
+		TimeDiff += 86400.0;
+	return TimeDiff;
+}
+
+// satellite position and velocity at tb in CIS coordinate with lunisolar acceleration
+static void GlonassInitState(PGLONASS_EPHEMERIS pEph, double State[9])
+{
+	State[0] = pEph->x;
+	State[1] = pEph->y;
+	State[2] = pEph->z;
+	State[3] = pEph->vx - PZ90_OMEGDOTE * pEph->y;
+	State[4] = pEph->vy + PZ90_OMEGDOTE * pEph->x;
+	State[5] = pEph->vz;
+	State[6] = pEph->ax;
+	State[7] = pEph->ay;
+	State[8] = pEph->az;
+}
+
+// grid state keeps total acceleration instead of lunisolar acceleration for interpolation
+static void GlonassGridState(double State[9], double GridState[9])
+{
+	double VelAcc[6];
+	int i;
+
+	CalcAcceleration(State, VelAcc);
+	for (i = 0; i < 6; i ++)
+		GridState[i] = State[i];
+	for (i = 0; i < 3; i ++)
+		GridState[i+6] = VelAcc[i+3];
+}
+
+static void GlonassGridStep(PGLONASS_EPHEMERIS pEph, double *GridState, double *NextGridState, double h)
+{
+	double State[9];
+	int i;
+
+	for (i = 0; i < 6; i ++)
+		State[i] = GridState[i];
+	State[6] = pEph->ax;
+	State[7] = pEph->ay;
+	State[8] = pEph->az;
+	RungeKutta(h, State);
+	GlonassGridState(State, NextGridState);
+}
@@ -21,6 +21,7 @@ D1D2NavBit::D1D2NavBit()
 {
 	int i;
 
+	FrameBitNumber = 300;
 	memset(BdsStream123, 0x0, sizeof(BdsStream123));
 	memset(BdsStreamAlm, 0x0, sizeof(BdsStreamAlm));
 	memset(BdsStreamInfo, 0x0, sizeof(BdsStreamInfo));
@@ -61,7 +62,7 @@ D1D2NavBit::~D1D2NavBit()
 {
 }
 
-int D1D2NavBit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits)
+int D1D2NavBit::GetPackedFrame(GNSS_TIME StartTime, int svid, int Param, unsigned long long *PackedBits)
 {
 	int i, SOW, subframe, page = 0, page_ext, D1Data;
 	unsigned int CurWord, Stream[10];
@@ -129,18 +130,19 @@ int D1D2NavBit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavB
 		}
 	}
 
+	memset(PackedBits, 0, sizeof(unsigned long long) * NAV_FRAME_WORDS(FrameBitNumber));
 	// add preamble and SOW
 	Stream[0] = (0x712 << 19) | (subframe << 12) | ((SOW >> 8) & 0xff0);
 	Stream[1] |= ((SOW & 0xfff) << 10);
 
 	Stream[0] = GetBCH(Stream[0]);
-	AssignBits(Stream[0], 30, NavBits);
+	AssignPackedBits(Stream[0], 30, PackedBits, 0);
 	for (i = 1; i < 10; i++)
 	{
 		CurWord = GetBCH((Stream[i] >> 7) & 0x7ff0) << 16;
 		CurWord |= GetBCH((Stream[i] << 4) & 0x7ff0);
 		CurWord = Interleave(CurWord);
-		AssignBits(CurWord, 30, NavBits + i * 30);
+		AssignPackedBits(CurWord, 30, PackedBits, i * 30);
 	}
 
 	return 0;
@@ -162,6 +164,7 @@ int D1D2NavBit::SetEphemeris(int svid, PGPS_EPHEMERIS Eph)
 	else
 		return 0;
 
+	ClearFrameCache(svid);
 	return svid;
 }
 
@@ -200,6 +203,7 @@ int D1D2NavBit::SetAlmanac(GPS_ALMANAC Alm[])
 	FillBdsHealthPage(Alm + 43, 13, BdsStreamHealth[1]);
 	FillBdsHealthPage(Alm + 56, 7, BdsStreamHealth[2]);
 
+	ClearFrameCache();
 	return 0;
 }
 
@@ -228,6 +232,7 @@ int D1D2NavBit::SetIonoUtc(PIONO_PARAM IonoParam, PUTC_PARAM UtcParam)
 	Stream[4] = COMPOSE_BITS((IntValue & 0xfff), 10, 12);
 	Stream[4] |= COMPOSE_BITS(UtcParam->DN, 2, 8);
 
+	ClearFrameCache();
 	return 0;
 }
 
@@ -19,6 +19,7 @@ const int FNavBit::SyncPattern[12] = {
 
 FNavBit::FNavBit()
 {
+	FrameBitNumber = 500;
 	memset(GalEphData, 0, sizeof(GalEphData));
 	memset(GalAlmData, 0, sizeof(GalAlmData));
 	memset(GalUtcData, 0, sizeof(GalUtcData));
@@ -29,7 +30,7 @@ FNavBit::~FNavBit()
 {
 }
 
-int FNavBit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits)
+int FNavBit::GetPackedFrame(GNSS_TIME StartTime, int svid, int Param, unsigned long long *PackedBits)
 {
 	int i, j, TOW, subframe, page, BitCount;
 	unsigned int EncodeData[7], GST, CrcResult, EncodeWord;	// 214bit to be encoded by CRC
@@ -64,12 +65,14 @@ int FNavBit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits
 	EncodeMessage[60] = GalConvolutionEncode(ConvEncodeBits, EncodeWord);
 	EncodeMessage[60] = (EncodeMessage[60] << 4) + GalConvolutionEncode(ConvEncodeBits, EncodeWord);
 
-	// do interleaving and put into NavBits
+	// do interleaving and put into PackedBits
+	memset(PackedBits, 0, sizeof(unsigned long long) * NAV_FRAME_WORDS(FrameBitNumber));
 	for (i = 0; i < 12; i ++)
-		*(NavBits ++) = SyncPattern[i];
-	for (i = 0, ConvEncodeBits = 0x80; i < 8; i ++, ConvEncodeBits >>= 1)
-		for (j = 0; j < 61; j ++)
-			*(NavBits ++) = (EncodeMessage[j] & ConvEncodeBits) ? 1 : 0;
+		SET_PACKED_BIT(PackedBits, i, SyncPattern[i]);
+	for (i = 0, BitCount = 12, ConvEncodeBits = 0x80; i < 8; i ++, ConvEncodeBits >>= 1)
+		for (j = 0; j < 61; j ++, BitCount ++)
+			if (EncodeMessage[j] & ConvEncodeBits)
+				SET_PACKED_BIT(PackedBits, BitCount, 1);
 
 	return 0;
 }
@@ -79,6 +82,7 @@ int FNavBit::SetEphemeris(int svid, PGPS_EPHEMERIS Eph)
 	if (svid < 1 || svid > 36 || !Eph || !Eph->valid)
 		return 0;
 	ComposeEphWords(Eph, GalEphData[svid-1]);
+	ClearFrameCache(svid);
 	return svid;
 }
 
@@ -94,6 +98,7 @@ int FNavBit::SetAlmanac(GPS_ALMANAC Alm[])
 		}
 	for (i = 0; i < 12; i ++)
 		ComposeAlmWords(Alm + i * 3, GalAlmData[i], week);
+	ClearFrameCache();
 	return 0;
 }
 
@@ -128,6 +133,7 @@ int FNavBit::SetIonoUtc(PIONO_PARAM IonoParam, PUTC_PARAM UtcParam)
 	GalUtcData[3] |= COMPOSE_BITS(UtcParam->DN, 11, 3);
 	GalUtcData[3] |= COMPOSE_BITS(UtcParam->TLSF, 3, 8);
 
+	ClearFrameCache();
 	return 0;
 }
 
@@ -2,5 +2,6 @@
 
 // Static member definitions
 double FastMath::sin_lut[FastMath::TRIG_LUT_SIZE + TRIG_LUT_SIZE / 4];
+float FastMath::sin_lut_f[FastMath::TRIG_LUT_SIZE + TRIG_LUT_SIZE / 4];
 //double FastMath::cos_lut[FastMath::TRIG_LUT_SIZE];
 bool FastMath::lut_initialized = false;
@@ -24,6 +24,7 @@ const unsigned int GNavBit::CheckSumTable[8][3] = {
 
 GNavBit::GNavBit()
 {
+	FrameBitNumber = 200;
 	memset(StringEph, 0x0, sizeof(StringEph));
 	memset(StringAlm, 0x0, sizeof(StringAlm));
 }
@@ -32,9 +33,9 @@ GNavBit::~GNavBit()
 {
 }
 
-int GNavBit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits)
+int GNavBit::GetPackedFrame(GNSS_TIME StartTime, int svid, int Param, unsigned long long *PackedBits)
 {
-	int i, string, frame, bit;
+	int i, string, frame, bit, value;
 	unsigned int* data, Stream[3];
 
 	if (svid < 1 || svid > 24)
@@ -61,23 +62,21 @@ int GNavBit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits
 	else if (string >= 4)
 		Stream[0] |= (string + 1) << 16;
 
-	// add check sum and put 85 bits to NavBits position 85~169 (leave first 85 places for meander code expansion)
+	// add check sum, then take 85 bits of the string (21 bits in Stream[0], 32 bits in Stream[1] and Stream[2]) MSB first
 	Stream[2] |= CheckSum(Stream);
-	AssignBits(Stream[0], 21, NavBits + 85);
-	AssignBits(Stream[1], 32, NavBits + 106);
-	AssignBits(Stream[2], 32, NavBits + 138);
-	// do relative coding
-	bit = 0;	// first bit of the string is always 0
-	for (i = 86; i < 170; i++)
-		bit = NavBits[i] = (bit ^ NavBits[i]);
-	// expand to meander code
+	memset(PackedBits, 0, sizeof(unsigned long long) * NAV_FRAME_WORDS(FrameBitNumber));
+	bit = 0;
 	for (i = 0; i < 85; i++)
 	{
-		NavBits[i * 2] = NavBits[i + 85];
-		NavBits[i * 2 + 1] = 1 - NavBits[i + 85];
+		value = (int)((i < 21) ? (Stream[0] >> (20 - i)) : (i < 53) ? (Stream[1] >> (52 - i)) : (Stream[2] >> (84 - i))) & 1;
+		if (i > 0)	// do relative coding, first bit of the string is always 0 and not coded
+			value = bit = (bit ^ value);
+		// expand to meander code
+		SET_PACKED_BIT(PackedBits, i * 2, value);
+		SET_PACKED_BIT(PackedBits, i * 2 + 1, 1 - value);
 	}
 	// append time mark
-	AssignBits(0x3e375096, 30, NavBits + 170);
+	AssignPackedBits(0x3e375096, 30, PackedBits, 170);
 
 	return 0;
 }
@@ -87,6 +86,7 @@ int GNavBit::SetEphemeris(int svid, PGPS_EPHEMERIS Eph)
 	if (svid < 1 || svid > 24 || !Eph || !Eph->flag)
 		return 0;
 	ComposeStringEph((PGLONASS_EPHEMERIS)Eph, StringEph[svid-1]);
+	ClearFrameCache(svid);
 	return svid;
 }
 
@@ -114,6 +114,7 @@ int GNavBit::SetAlmanac(GPS_ALMANAC Alm[])
 		StringAlm[frame][string - 4][0] |= ((string + 1) << 16);
 	}
 
+	ClearFrameCache();
 	return 0;
 }
 
@@ -142,6 +142,7 @@ const unsigned char INavBit::Power2Oct[510] = {
 
 INavBit::INavBit()
 {
+	FrameBitNumber = 500;
 	GalSpareData[0] = 0x02000000; GalSpareData[1] = GalSpareData[2] = GalSpareData[3] = 0;
 	GalDummyData[0] = 0xfc000000; GalDummyData[1] = GalDummyData[2] = GalDummyData[3] = 0;
 	memset(GalEphData, 0, sizeof(GalEphData));
@@ -155,7 +156,7 @@ INavBit::~INavBit()
 }
 
 // Param is used to distinguish from E1 and E5b (1 for E1)
-int INavBit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits)
+int INavBit::GetPackedFrame(GNSS_TIME StartTime, int svid, int Param, unsigned long long *PackedBits)
 {
 	int i, j, TOW, subframe, page;
 	int Word, BitCount;
@@ -244,17 +245,21 @@ int INavBit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits
 	OddPart[29] = GalConvolutionEncode(ConvEncodeBits, EncodeWord);
 	OddPart[29] = (OddPart[29] << 4) + GalConvolutionEncode(ConvEncodeBits, EncodeWord);
 
-	// do interleaving and put into NavBits
+	// do interleaving and put into PackedBits
+	memset(PackedBits, 0, sizeof(unsigned long long) * NAV_FRAME_WORDS(FrameBitNumber));
 	for (i = 0; i < 10; i ++)
-		*(NavBits ++) = SyncPattern[i];
-	for (i = 0, ConvEncodeBits = 0x80; i < 8; i ++, ConvEncodeBits >>= 1)
-		for (j = 0; j < 30; j ++)
-			*(NavBits ++) = (EvenPart[j] & ConvEncodeBits) ? 1 : 0;
-	for (i = 0; i < 10; i ++)
-		*(NavBits ++) = SyncPattern[i];
-	for (i = 0, ConvEncodeBits = 0x80; i < 8; i ++, ConvEncodeBits >>= 1)
-		for (j = 0; j < 30; j ++)
-			*(NavBits ++) = (OddPart[j] & ConvEncodeBits) ? 1 : 0;
+	{
+		SET_PACKED_BIT(PackedBits, i, SyncPattern[i]);
+		SET_PACKED_BIT(PackedBits, 250 + i, SyncPattern[i]);
+	}
+	for (i = 0, BitCount = 10, ConvEncodeBits = 0x80; i < 8; i ++, ConvEncodeBits >>= 1)
+		for (j = 0; j < 30; j ++, BitCount ++)
+		{
+			if (EvenPart[j] & ConvEncodeBits)
+				SET_PACKED_BIT(PackedBits, BitCount, 1);
+			if (OddPart[j] & ConvEncodeBits)
+				SET_PACKED_BIT(PackedBits, BitCount + 250, 1);
+		}
 
 	return 0;
 }
@@ -265,6 +270,7 @@ int INavBit::SetEphemeris(int svid, PGPS_EPHEMERIS Eph)
 		return 0;
 	ComposeEphWords(Eph, GalEphData[svid-1]);
 	ComposeParityWords(GalEphData[svid-1], GalRsVector[svid-1]);
+	ClearFrameCache(svid);
 	return svid;
 }
 
@@ -280,6 +286,7 @@ int INavBit::SetAlmanac(GPS_ALMANAC Alm[])
 		}
 	for (i = 0; i < 12; i ++)
 		ComposeAlmWords(Alm + i * 3, GalAlmData[i], week);
+	ClearFrameCache();
 	return 0;
 }
 
@@ -323,6 +330,7 @@ int INavBit::SetIonoUtc(PIONO_PARAM IonoParam, PUTC_PARAM UtcParam)
 	GalUtcData[3] = COMPOSE_BITS(UtcParam->DN, 31, 1);
 	GalUtcData[3] |= COMPOSE_BITS(UtcParam->TLSF, 23, 8);
 
+	ClearFrameCache();
 	return 0;
 }
 
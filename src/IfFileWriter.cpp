@@ -0,0 +1,202 @@
+//----------------------------------------------------------------------
+// IfFileWriter.cpp:
+//   Implementation of asynchronous IF data file writer class
+//
+//          Copyright (C) 2020-2029 by Jun Mo, All rights reserved.
+//
+//----------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "IfFileWriter.h"
+
+#define IF_WRITER_IDLE_WAIT 100		// microseconds writer thread sleeps when no buffer ready
+#define IF_WRITER_STALL_WAIT 50		// microseconds producer sleeps when no buffer free
+
+static unsigned char *AllocateAligned(int Size)
+{
+#if defined(_WIN32)
+	return (unsigned char *)_aligned_malloc(Size, IF_WRITER_ALIGNMENT);
+#else
+	void *Buffer;
+	return (posix_memalign(&Buffer, IF_WRITER_ALIGNMENT, Size) == 0) ? (unsigned char *)Buffer : NULL;
+#endif
+}
+
+static void FreeAligned(unsigned char *Buffer)
+{
+#if defined(_WIN32)
+	_aligned_free(Buffer);
+#else
+	free(Buffer);
+#endif
+}
+
+CIfFileWriter::CIfFileWriter(int PoolSize) : WriteIndex(0), ReadIndex(0), StopFlag(false)
+{
+	BufferNumber = (PoolSize < 2) ? 2 : PoolSize;
+	BufferSize = 0;
+	Buffers = new unsigned char*[BufferNumber];
+	FillSize = new int[BufferNumber];
+	memset(Buffers, 0, sizeof(unsigned char *) * BufferNumber);
+	CurrentFill = 0;
+	File = NULL;
+	FileDescriptor = -1;
+	UseDirectIo = WriteError = FALSE;
+	BytesWritten = 0;
+	WriteCount = StallCount = 0;
+	WriteTime = StallTime = 0.0;
+}
+
+CIfFileWriter::~CIfFileWriter()
+{
+	Close();
+	delete[] Buffers;
+	delete[] FillSize;
+}
+
+// each buffer holds IF_WRITER_BUFFER_SIZE bytes to write plus MaxBlockSize bytes overflow area,
+// so a block is always filled contiguously and every write except the last one has the same aligned size
+BOOL CIfFileWriter::Open(const char *FileName, int MaxBlockSize, BOOL DirectIo)
+{
+	int i;
+
+	Close();
+	BufferSize = (MaxBlockSize > IF_WRITER_BUFFER_SIZE) ? (MaxBlockSize + IF_WRITER_ALIGNMENT - 1) / IF_WRITER_ALIGNMENT * IF_WRITER_ALIGNMENT : IF_WRITER_BUFFER_SIZE;
+	UseDirectIo = FALSE;
+#if defined(__linux__)
+	if (DirectIo && (FileDescriptor = open(FileName, O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644)) >= 0)
+		UseDirectIo = TRUE;
+#endif
+	if (!UseDirectIo && (File = fopen(FileName, "wb")) == NULL)
+		return FALSE;
+	for (i = 0; i < BufferNumber; i ++)
+	{
+		if ((Buffers[i] = AllocateAligned(BufferSize + MaxBlockSize)) == NULL)
+		{
+			Close();
+			return FALSE;
+		}
+	}
+
+	CurrentFill = 0;
+	WriteIndex = ReadIndex = 0;
+	StopFlag = false;
+	WriteError = FALSE;
+	BytesWritten = 0;
+	WriteCount = StallCount = 0;
+	WriteTime = StallTime = 0.0;
+	WriterThread = std::thread(&CIfFileWriter::WriterLoop, this);
+	return TRUE;
+}
+
+void CIfFileWriter::Close()
+{
+	int i;
+
+	if (WriterThread.joinable())
+	{
+		if (CurrentFill > 0)	// hand over last partial buffer
+		{
+			FillSize[WriteIndex % BufferNumber] = CurrentFill;
+			WriteIndex.fetch_add(1, std::memory_order_release);
+			CurrentFill = 0;
+		}
+		StopFlag.store(true, std::memory_order_release);
+		WriterThread.join();
+	}
+	for (i = 0; i < BufferNumber; i ++)
+	{
+		if (Buffers[i])
+			FreeAligned(Buffers[i]);
+		Buffers[i] = NULL;
+	}
+	if (File)
+		fclose(File);
+	File = NULL;
+#if defined(__linux__)
+	if (FileDescriptor >= 0)
+		close(FileDescriptor);
+#endif
+	FileDescriptor = -1;
+}
+
+// append Size bytes filled at GetBuffer(), hand buffer to writer thread when full
+// data exceeding buffer size is moved to beginning of next buffer
+void CIfFileWriter::Commit(int Size)
+{
+	unsigned char *FullBuffer;
+
+	CurrentFill += Size;
+	if (CurrentFill < BufferSize)
+		return;
+	FullBuffer = Buffers[WriteIndex % BufferNumber];
+	FillSize[WriteIndex % BufferNumber] = BufferSize;
+	WriteIndex.fetch_add(1, std::memory_order_release);
+	CurrentFill -= BufferSize;
+	WaitFreeBuffer();
+	if (CurrentFill > 0)	// writer thread only reads first BufferSize bytes of full buffer
+		memcpy(Buffers[WriteIndex % BufferNumber], FullBuffer + BufferSize, CurrentFill);
+}
+
+void CIfFileWriter::WaitFreeBuffer()
+{
+	if (WriteIndex.load(std::memory_order_relaxed) - ReadIndex.load(std::memory_order_acquire) < (unsigned int)BufferNumber)
+		return;
+	auto StartTime = std::chrono::steady_clock::now();
+	StallCount ++;
+	while (WriteIndex.load(std::memory_order_relaxed) - ReadIndex.load(std::memory_order_acquire) >= (unsigned int)BufferNumber)
+		std::this_thread::sleep_for(std::chrono::microseconds(IF_WRITER_STALL_WAIT));
+	StallTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+}
+
+void CIfFileWriter::WriterLoop()
+{
+	unsigned int Index = ReadIndex.load(std::memory_order_relaxed);
+	bool Stop;
+
+	while (true)
+	{
+		Stop = StopFlag.load(std::memory_order_acquire);	// read before checking buffer so that last buffer is not missed
+		if (Index == WriteIndex.load(std::memory_order_acquire))
+		{
+			if (Stop)
+				break;
+			std::this_thread::sleep_for(std::chrono::microseconds(IF_WRITER_IDLE_WAIT));
+			continue;
+		}
+		auto StartTime = std::chrono::steady_clock::now();
+		WriteData(Buffers[Index % BufferNumber], FillSize[Index % BufferNumber]);
+		WriteTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+		ReadIndex.store(++ Index, std::memory_order_release);
+	}
+}
+
+void CIfFileWriter::WriteData(const unsigned char *Data, int Size)
+{
+	int Written = 0;
+
+#if defined(__linux__)
+	if (FileDescriptor >= 0)
+	{
+		int Result;
+
+		if (Size % IF_WRITER_ALIGNMENT)	// last partial buffer cannot be written with O_DIRECT
+			fcntl(FileDescriptor, F_SETFL, fcntl(FileDescriptor, F_GETFL) & ~O_DIRECT);
+		while (Written < Size && (Result = (int)write(FileDescriptor, Data + Written, Size - Written)) > 0)
+			Written += Result;
+	}
+	else
+#endif
+	Written = (int)fwrite(Data, 1, Size, File);
+	if (Written < Size)
+		WriteError = TRUE;
+	BytesWritten += Written;
+	WriteCount ++;
+}
@@ -32,8 +32,8 @@ static const char *KeyDictionaryListEphAlm[] = {
 	"type", "name",
 };
 static const char *KeyDictionaryListOutput[] = {
-//     0        1        2         3          4            5               6             7          8        9       10        11          12            13
-	"type", "format", "name", "interval", "config", "systemSelect", "elevationMask", "maskOut", "system", "svid", "signal", "enable", "sampleFreq", "centerFreq",
+//     0        1        2         3          4            5               6             7          8        9       10        11          12            13            14            15            16             17                18                   19
+	"type", "format", "name", "interval", "config", "systemSelect", "elevationMask", "maskOut", "system", "svid", "signal", "enable", "sampleFreq", "centerFreq", "sampleType", "noiseSeed", "noiseBuffer", "blockLength", "blockInterpolation", "orbitInterpolation",
 };
 static const char *KeyDictionaryListPower[] = {
 //       0             1              2                 3           4       5         6        7         8           9
@@ -63,6 +63,14 @@ static const char *DictionaryListOutputFormat[] = {
 //     0      1       2      3       4       5      6      7      8	
 	"ECEF", "LLA", "NMEA", "KML", "RINEX", "IQ8", "IQ4", "IQ2", "IQ16",
 };
+static const char *DictionaryListSampleType[] = {
+//     0         1        2
+	"double", "float", "int16",
+};
+static const char *DictionaryListInterpolation[] = {
+//     0           1
+	"linear", "quadratic",
+};
 static const char *DictionaryListSignal[] = {
 //    0      1      2      3      4      5     6   7
 	"L1CA","L1C", "L2C", "L2P", "L5",  "",    "", "",
@@ -298,6 +306,7 @@ BOOL SetAlmanacFile(JsonObject *Object, CNavData &NavData)
 BOOL SetOutputParam(JsonObject *Object, OUTPUT_PARAM &OutputParam)
 {
 	JsonObject *SystemSelectObject;
+	int Index;
 
 	// set default value
 	OutputParam.filename[0] = 0;
@@ -308,6 +317,12 @@ BOOL SetOutputParam(JsonObject *Object, OUTPUT_PARAM &OutputParam)
 	// default output GPS L1 only
 	OutputParam.FreqSelect[0] = 0x1;
 	OutputParam.FreqSelect[1] = OutputParam.FreqSelect[2] = OutputParam.FreqSelect[3] = 0;
+	OutputParam.SampleType = SampleTypeDouble;
+	OutputParam.NoiseSeed = 0;
+	OutputParam.NoiseBufferSize = 0;
+	OutputParam.BlockLength = 1;
+	OutputParam.Interpolation = InterpolationLinear;
+	OutputParam.OrbitInterpWindow = 60;
 
 	while (Object)
 	{
@@ -344,6 +359,22 @@ BOOL SetOutputParam(JsonObject *Object, OUTPUT_PARAM &OutputParam)
 			OutputParam.SampleFreq = (int)(GET_DOUBLE_VALUE(Object) * 1000); break;
 		case 13:	// "centerFreq"
 			OutputParam.CenterFreq = (int)(GET_DOUBLE_VALUE(Object) * 1000); break;
+		case 14:	// "sampleType"
+			if (Object->Type == JsonObject::ValueTypeString && (Index = SearchDictionary(Object->String, PARAMETER(DictionaryListSampleType))) >= 0)
+				OutputParam.SampleType = (IfSampleType)Index;
+			break;
+		case 15:	// "noiseSeed"
+			OutputParam.NoiseSeed = (unsigned int)GET_DOUBLE_VALUE(Object); break;
+		case 16:	// "noiseBuffer"
+			OutputParam.NoiseBufferSize = (int)GET_DOUBLE_VALUE(Object); break;
+		case 17:	// "blockLength"
+			OutputParam.BlockLength = (int)GET_DOUBLE_VALUE(Object); break;
+		case 18:	// "blockInterpolation"
+			if (Object->Type == JsonObject::ValueTypeString && (Index = SearchDictionary(Object->String, PARAMETER(DictionaryListInterpolation))) >= 0)
+				OutputParam.Interpolation = (BlockInterpolation)Index;
+			break;
+		case 19:	// "orbitInterpolation"
+			OutputParam.OrbitInterpWindow = (int)GET_DOUBLE_VALUE(Object); break;
 		}
 		Object = JsonStream::GetNextObject(Object);
 	}
@@ -29,6 +29,7 @@ LNavBit::LNavBit()
 {
 	int i;
 
+	FrameBitNumber = 300;
 	memset(GpsStream123, 0xaa, sizeof(GpsStream123));
 	memset(GpsStream45, 0x55, sizeof(GpsStream45));
 	// assign page id
@@ -42,7 +43,7 @@ LNavBit::~LNavBit()
 {
 }
 
-int LNavBit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits)
+int LNavBit::GetPackedFrame(GNSS_TIME StartTime, int svid, int Param, unsigned long long *PackedBits)
 {
 	int i, TOW, subframe, page;
 	unsigned int TlmWord, HowWord, CurWord, *Stream;
@@ -62,6 +63,7 @@ int LNavBit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits
 	else
 		return 1;
 
+	memset(PackedBits, 0, sizeof(unsigned long long) * NAV_FRAME_WORDS(FrameBitNumber));
 	TlmWord = (0x8b << 22);		// set all TLM message to 0 and let ISF=0
 	TOW ++;		// TOW is the count of NEXT subframe
 	if (TOW >= 100800)
@@ -70,7 +72,7 @@ int LNavBit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits
 
 	// generate bit stream of TLM, this is WORD 1
 	CurWord = TlmWord | GpsGetParity(TlmWord);	// D29* and D30* are 00 for TLM
-	AssignBits(CurWord, 30, NavBits);
+	AssignPackedBits(CurWord, 30, PackedBits, 0);
 
 	// generate bit stream of HOW, this is WORD 2
 	CurWord <<= 30;		// put D29* and D30* into bit31 and bit30
@@ -79,7 +81,7 @@ int LNavBit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits
 		CurWord ^= 0x3fffffc0;
 	CurWord |= GpsGetParity(CurWord);	// add parity check
 	CurWord ^= ParityAdjust[CurWord & 3];	// adjust d23 and d24 to ensure last two bit of parity to be 00
-	AssignBits(CurWord, 30, NavBits + 30);
+	AssignPackedBits(CurWord, 30, PackedBits, 30);
 
 	// WORD 3 to DOWRD 10
 	for (i = 0; i < 8; i ++)
@@ -93,7 +95,7 @@ int LNavBit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits
 		CurWord |= GpsGetParity(CurWord);	// add parity check
 		if (i == 7)
 			CurWord ^= ParityAdjust[CurWord & 3];	// adjust d23 and d24 to ensure last two bit of parity to be 00
-		AssignBits(CurWord, 30, NavBits + 60 + i * 30);
+		AssignPackedBits(CurWord, 30, PackedBits, 60 + i * 30);
 	}
 
 	return 0;
@@ -104,6 +106,7 @@ int LNavBit::SetEphemeris(int svid, PGPS_EPHEMERIS Eph)
 	if (svid < 1 || svid > 32 || !Eph || !Eph->valid)
 		return 0;
 	ComposeGpsStream123(Eph, GpsStream123[svid-1]);
+	ClearFrameCache(svid);
 	return svid;
 }
 
@@ -119,6 +122,7 @@ int LNavBit::SetAlmanac(GPS_ALMANAC Alm[])
 		FillGpsAlmanacPage(Alm + i, GpsStream45[0][i-22]);
 	FillGpsHealthPage(Alm, GpsStream45[0][24], GpsStream45[1][24]);
 
+	ClearFrameCache();
 	return 0;
 }
 
@@ -158,6 +162,7 @@ int LNavBit::SetIonoUtc(PIONO_PARAM IonoParam, PUTC_PARAM UtcParam)
 	Stream[6] |= COMPOSE_BITS(UtcParam->DN, 0, 8);
 	Stream[7] = COMPOSE_BITS(UtcParam->TLSF, 16, 8);
 
+	ClearFrameCache();
 	return 0;
 }
 
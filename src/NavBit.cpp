@@ -77,11 +77,180 @@ const unsigned int NavBit::Crc24q[256] = {
 
 NavBit::NavBit()
 {
+	FrameCache = (PNAV_FRAME_CACHE)0;
+	FrameBitNumber = 0;
 }
 
 NavBit::~NavBit()
 {
+	delete[] FrameCache;
 }
+
+// get data bits of the frame starting at FrameStart millisecond (converted transmit time) which contains StartTime
+// a frame is encoded only once and shared by all signals with the same svid and Param,
+// the frame starting at NextFrame is encoded in advance so that it is ready when signals move to it
+// each svid and Param has its own slot holding current and next frame, so frames of one satellite never evict others
+// BitNumber is the number of data bits within one frame, bit i is put at bit (i&63) of PackedBits[i>>6]
+// return value is the same as GetPackedFrame(), PackedBits unchanged on failure
+int NavBit::GetFrameBits(GNSS_TIME StartTime, int FrameStart, GNSS_TIME NextFrame, int svid, int Param, int BitNumber, unsigned long long *PackedBits)
+{
+	PNAV_FRAME_CACHE Slot, Frame;
+	int i, Result;
+	unsigned long long FrameBits[NAV_FRAME_WORDS(NAV_FRAME_MAX_BITS)];
+
+	if (BitNumber > NAV_FRAME_MAX_BITS)
+		return -1;
+	if (svid < 1 || svid > NAV_FRAME_CACHE_SVID || Param < 0 || Param >= NAV_FRAME_CACHE_PARAM)	// no slot in cache, encode directly
+	{
+		if ((Result = GetPackedFrame(StartTime, svid, Param, FrameBits)) == 0)
+			for (i = 0; i < NAV_FRAME_WORDS(BitNumber); i ++)
+				PackedBits[i] = FrameBits[i];
+		return Result;
+	}
+
+	std::lock_guard<std::recursive_mutex> Lock(FrameCacheMutex);
+	if (!FrameCache)
+	{
+		FrameCache = new NAV_FRAME_CACHE[NAV_FRAME_CACHE_SIZE];
+		for (i = 0; i < NAV_FRAME_CACHE_SIZE; i ++)
+			FrameCache[i].svid = 0;
+	}
+	Slot = FrameCache + ((svid - 1) * NAV_FRAME_CACHE_PARAM + Param) * NAV_FRAME_CACHE_SLOT;
+	if ((Frame = FindFrame(Slot, StartTime.Week, FrameStart)) == NULL &&
+		(Frame = EncodeFrame(Slot, FindFrame(Slot, NextFrame.Week, NextFrame.MilliSeconds), StartTime, FrameStart, svid, Param, Result)) == NULL)
+		return Result;	// invalid frame is not cached and has no next frame to prefetch
+	for (i = 0; i < NAV_FRAME_WORDS(BitNumber); i ++)
+		PackedBits[i] = Frame->Bits[i];
+	if (!FindFrame(Slot, NextFrame.Week, NextFrame.MilliSeconds))
+		EncodeFrame(Slot, Frame, NextFrame, NextFrame.MilliSeconds, svid, Param, Result);
+
+	return 0;
+}
+
+// pack one bit in each int of NavBits (non-zero for 1) into 64bit words, bit i at bit (i&63) of PackedBits[i>>6]
+void NavBit::PackBits(const int *NavBits, int BitNumber, unsigned long long *PackedBits)
+{
+	int i;
+
+	for (i = 0; i < NAV_FRAME_WORDS(BitNumber); i ++)
+		PackedBits[i] = 0;
+	for (i = 0; i < BitNumber; i ++)
+		if (NavBits[i])
+			PackedBits[i >> 6] |= 1ULL << (i & 63);
+}
+
+// legacy interface, frame from GetPackedFrame() unpacked to FrameBitNumber ints, NavBits unchanged on failure
+int NavBit::GetFrameData(GNSS_TIME StartTime, int svid, int Param, int *NavBits)
+{
+	unsigned long long PackedBits[NAV_FRAME_WORDS(NAV_FRAME_MAX_BITS)];
+	int i, Result;
+
+	if ((Result = GetPackedFrame(StartTime, svid, Param, PackedBits)) == 0)
+		for (i = 0; i < FrameBitNumber; i ++)
+			NavBits[i] = GET_PACKED_BIT(PackedBits, i);
+	return Result;
+}
+
+// put BitNumber LSB of Data into PackedBits from bit StartBit, MSB first same as AssignBits()
+// bits are ORed into PackedBits, so destination bits should be cleared
+void NavBit::AssignPackedBits(unsigned int Data, int BitNumber, unsigned long long PackedBits[], int StartBit)
+{
+	unsigned long long Reversed;
+	int Shift = StartBit & 63;
+
+	// reverse bit order so that MSB of the field goes to lowest bit position
+	Data <<= (32 - BitNumber);
+	Data = ((Data >> 1) & 0x55555555) | ((Data & 0x55555555) << 1);
+	Data = ((Data >> 2) & 0x33333333) | ((Data & 0x33333333) << 2);
+	Data = ((Data >> 4) & 0x0f0f0f0f) | ((Data & 0x0f0f0f0f) << 4);
+	Data = ((Data >> 8) & 0x00ff00ff) | ((Data & 0x00ff00ff) << 8);
+	Reversed = (unsigned long long)((Data >> 16) | (Data << 16));
+	PackedBits[StartBit >> 6] |= Reversed << Shift;
+	if (Shift + BitNumber > 64)
+		PackedBits[(StartBit >> 6) + 1] |= Reversed >> (64 - Shift);
+}
+
+// OR BitNumber packed bits of Src (bit i at bit (i&63) of Src[i>>6]) into PackedBits from bit StartBit
+void NavBit::CopyPackedBits(const unsigned long long Src[], int BitNumber, unsigned long long PackedBits[], int StartBit)
+{
+	unsigned long long Bits;
+	int i, Shift = StartBit & 63;
+
+	PackedBits += StartBit >> 6;
+	for (i = 0; i < NAV_FRAME_WORDS(BitNumber); i ++)
+	{
+		Bits = Src[i];
+		if ((i + 1) * 64 > BitNumber)
+			Bits &= (1ULL << (BitNumber & 63)) - 1;
+		PackedBits[i] |= Bits << Shift;
+		if (Shift && (i * 64 + 64 - Shift) < BitNumber)
+			PackedBits[i + 1] |= Bits >> (64 - Shift);
+	}
+}
+
+// remove frames of svid from cache (all frames if svid is 0), called when navigation data changes
+void NavBit::ClearFrameCache(int svid)
+{
+	int i;
+
+	std::lock_guard<std::recursive_mutex> Lock(FrameCacheMutex);
+	if (!FrameCache)
+		return;
+	for (i = 0; i < NAV_FRAME_CACHE_SIZE; i ++)
+		if (svid == 0 || FrameCache[i].svid == svid)
+			FrameCache[i].svid = 0;
+}
+
+// navigation data of an instance is read by GetPackedFrame() with frame cache locked,
+// so holding the same lock while composing keeps channels from encoding half updated data
+int NavBit::UpdateEphemeris(int svid, PGPS_EPHEMERIS Eph)
+{
+	std::lock_guard<std::recursive_mutex> Lock(FrameCacheMutex);
+	return SetEphemeris(svid, Eph);
+}
+
+int NavBit::UpdateAlmanac(GPS_ALMANAC Alm[])
+{
+	std::lock_guard<std::recursive_mutex> Lock(FrameCacheMutex);
+	return SetAlmanac(Alm);
+}
+
+// find frame in slot of one svid and Param, NULL if not found
+PNAV_FRAME_CACHE NavBit::FindFrame(PNAV_FRAME_CACHE Slot, int Week, int FrameStart)
+{
+	int i;
+
+	for (i = 0; i < NAV_FRAME_CACHE_SLOT; i ++)
+		if (Slot[i].svid != 0 && Slot[i].FrameStart == FrameStart && Slot[i].Week == Week)
+			return &Slot[i];
+	return (PNAV_FRAME_CACHE)0;
+}
+
+// encode frame into an empty entry of the slot or the one other than Keep (NULL if no entry to keep)
+// return NULL with Result set to return value of GetPackedFrame() if encode fails, the entry is emptied then
+PNAV_FRAME_CACHE NavBit::EncodeFrame(PNAV_FRAME_CACHE Slot, PNAV_FRAME_CACHE Keep, GNSS_TIME StartTime, int FrameStart, int svid, int Param, int &Result)
+{
+	PNAV_FRAME_CACHE Frame = (Slot == Keep) ? Slot + 1 : Slot;
+	int i;
+
+	for (i = 0; i < NAV_FRAME_CACHE_SLOT; i ++)
+		if (Slot[i].svid == 0)
+		{
+			Frame = &Slot[i];
+			break;
+		}
+	if ((Result = GetPackedFrame(StartTime, svid, Param, Frame->Bits)) != 0)
+	{
+		Frame->svid = 0;
+		return (PNAV_FRAME_CACHE)0;
+	}
+	Frame->svid = svid;
+	Frame->Week = StartTime.Week;
+	Frame->FrameStart = FrameStart;
+
+	return Frame;
+}
+
 int NavBit::roundi(double data)
 {
 	if (data >= 0)
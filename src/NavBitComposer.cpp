@@ -0,0 +1,144 @@
+//----------------------------------------------------------------------
+// NavBitComposer.cpp:
+//   Implementation of ephemeris and almanac composition for all navigation bit instances
+//
+//          Copyright (C) 2020-2029 by Jun Mo, All rights reserved.
+//
+//----------------------------------------------------------------------
+
+#include "NavBitComposer.h"
+
+CNavBitComposer::CNavBitComposer()
+{
+	int i, j;
+
+	for (i = 0; i < COMPOSER_SYSTEM_NUMBER; i ++)
+	{
+		NavBitNumber[i] = 0;
+		PendingAlm[i] = (PGPS_ALMANAC)0;
+		for (j = 0; j < COMPOSER_MAX_SVID; j ++)
+			LastEph[i][j] = (PGPS_EPHEMERIS)0;
+	}
+	PendingNumber = 0;
+}
+
+CNavBitComposer::~CNavBitComposer()
+{
+}
+
+void CNavBitComposer::AddNavBit(GnssSystem System, NavBit *Nav)
+{
+	if (System >= COMPOSER_SYSTEM_NUMBER || !Nav || NavBitNumber[System] >= COMPOSER_MAX_NAVBIT)
+		return;
+	NavBitList[System][NavBitNumber[System] ++] = Nav;
+}
+
+// NULL ephemeris is not queued so that the last valid one stays in navigation data
+// SwitchTime is receiver time in millisecond since GPS epoch, ephemeris composed by Update() not before it
+bool CNavBitComposer::SetEphemeris(GnssSystem System, int svid, PGPS_EPHEMERIS Eph, long long SwitchTime)
+{
+	std::lock_guard<std::mutex> Lock(PendingMutex);
+
+	if (System >= COMPOSER_SYSTEM_NUMBER || svid < 1 || svid > COMPOSER_MAX_SVID || !Eph || Eph == LastEph[System][svid-1] || PendingNumber >= COMPOSER_SYSTEM_NUMBER * COMPOSER_MAX_SVID)
+		return false;
+	LastEph[System][svid-1] = Eph;
+	PendingSystem[PendingNumber] = System;
+	PendingEph[PendingNumber] = Eph;
+	PendingTime[PendingNumber] = SwitchTime;
+	PendingSvid[PendingNumber ++] = svid;
+	return true;
+}
+
+void CNavBitComposer::SetAlmanac(GnssSystem System, PGPS_ALMANAC Alm)
+{
+	if (System < COMPOSER_SYSTEM_NUMBER)
+		PendingAlm[System] = Alm;
+}
+
+// each ephemeris task writes data of its own satellite within one instance only, so tasks run in any order
+// almanac shares pages with all satellites of the instance, composed after all ephemeris tasks finished
+int CNavBitComposer::Compose()
+{
+	NavBit *TaskNav[COMPOSER_MAX_TASK], *AlmNav[COMPOSER_SYSTEM_NUMBER * COMPOSER_MAX_NAVBIT];
+	PGPS_EPHEMERIS TaskEph[COMPOSER_MAX_TASK];
+	PGPS_ALMANAC AlmData[COMPOSER_SYSTEM_NUMBER * COMPOSER_MAX_NAVBIT];
+	int TaskSvid[COMPOSER_MAX_TASK];
+	int i, j, System, TaskNumber = 0, AlmNumber = 0, SatNumber = PendingNumber;
+
+	for (i = 0; i < PendingNumber; i ++)
+	{
+		System = PendingSystem[i];
+		for (j = 0; j < NavBitNumber[System]; j ++)
+		{
+			TaskNav[TaskNumber] = NavBitList[System][j];
+			TaskSvid[TaskNumber] = PendingSvid[i];
+			TaskEph[TaskNumber ++] = PendingEph[i];
+		}
+	}
+	PendingNumber = 0;
+	for (System = 0; System < COMPOSER_SYSTEM_NUMBER; System ++)
+	{
+		if (!PendingAlm[System])
+			continue;
+		for (j = 0; j < NavBitNumber[System]; j ++)
+		{
+			AlmNav[AlmNumber] = NavBitList[System][j];
+			AlmData[AlmNumber ++] = PendingAlm[System];
+		}
+		PendingAlm[System] = (PGPS_ALMANAC)0;
+	}
+
+#ifdef _OPENMP
+	#pragma omp parallel private(i)
+#endif
+	{
+#ifdef _OPENMP
+		#pragma omp for schedule(dynamic)
+#endif
+		for (i = 0; i < TaskNumber; i ++)
+			TaskNav[i]->SetEphemeris(TaskSvid[i], TaskEph[i]);
+#ifdef _OPENMP
+		#pragma omp for schedule(dynamic)
+#endif
+		for (i = 0; i < AlmNumber; i ++)
+			AlmNav[i]->SetAlmanac(AlmData[i]);
+	}
+
+	return SatNumber;
+}
+
+// called by synthesis before each block with receiver time of the block (millisecond since GPS epoch),
+// ephemeris with switch time not later than Time are composed in queued order, others stay in queue
+// only a few satellites change at a time, each instance is locked only while one satellite is composed
+int CNavBitComposer::Update(long long Time)
+{
+	int i, j, System, SatNumber = 0, Remain = 0;
+
+	std::lock_guard<std::mutex> Lock(PendingMutex);
+	for (i = 0; i < PendingNumber; i ++)
+	{
+		if (PendingTime[i] > Time)
+		{
+			PendingSystem[Remain] = PendingSystem[i];
+			PendingSvid[Remain] = PendingSvid[i];
+			PendingEph[Remain] = PendingEph[i];
+			PendingTime[Remain ++] = PendingTime[i];
+			continue;
+		}
+		System = PendingSystem[i];
+		for (j = 0; j < NavBitNumber[System]; j ++)
+			NavBitList[System][j]->UpdateEphemeris(PendingSvid[i], PendingEph[i]);
+		SatNumber ++;
+	}
+	PendingNumber = Remain;
+	for (System = 0; System < COMPOSER_SYSTEM_NUMBER; System ++)
+	{
+		if (!PendingAlm[System])
+			continue;
+		for (j = 0; j < NavBitNumber[System]; j ++)
+			NavBitList[System][j]->UpdateAlmanac(PendingAlm[System]);
+		PendingAlm[System] = (PGPS_ALMANAC)0;
+	}
+
+	return SatNumber;
+}
@@ -23,6 +23,8 @@ CNavData::CNavData()
 	GalileoEphemerisPool = (PGPS_EPHEMERIS)malloc(sizeof(GPS_EPHEMERIS) * EPH_NUMBER_INIT);
 	GlonassEphemerisPool = (PGLONASS_EPHEMERIS)malloc(sizeof(GLONASS_EPHEMERIS) * EPH_NUMBER_INIT);
 	GpsEphemerisPoolSize = BdsEphemerisPoolSize = GalileoEphemerisPoolSize = GlonassEphemerisPoolSize = EPH_NUMBER_INIT;
+	EphIndex[0] = EphIndex[1] = EphIndex[2] = EphIndex[3] = NULL;
+	EphIndexValid[0] = EphIndexValid[1] = EphIndexValid[2] = EphIndexValid[3] = false;
 	memset(&GpsUtcParam, 0, sizeof(UTC_PARAM));
 	memset(GpsAlmanac, 0, sizeof(GpsAlmanac));
 	memset(BdsAlmanac, 0, sizeof(BdsAlmanac));
@@ -43,6 +45,10 @@ CNavData::~CNavData()
 	free(BdsEphemerisPool);
 	free(GalileoEphemerisPool);
 	free(GlonassEphemerisPool);
+	free(EphIndex[0]);
+	free(EphIndex[1]);
+	free(EphIndex[2]);
+	free(EphIndex[3]);
 }
 
 bool CNavData::AddNavData(NavDataType Type, void *NavData)
@@ -99,6 +105,7 @@ bool CNavData::AddNavData(NavDataType Type, void *NavData)
 		}
 		memcpy(&GpsEphemerisPool[GpsEphemerisNumber], NavData, sizeof(GPS_EPHEMERIS));
 		GpsEphemerisNumber ++;
+		EphIndexValid[GpsSystem] = false;
 		break;
 	case NavDataBdsD1D2:
 	case NavDataBdsCnav1:
@@ -114,6 +121,7 @@ bool CNavData::AddNavData(NavDataType Type, void *NavData)
 		}
 		memcpy(&BdsEphemerisPool[BdsEphemerisNumber], NavData, sizeof(GPS_EPHEMERIS));
 		BdsEphemerisNumber ++;
+		EphIndexValid[BdsSystem] = false;
 		break;
 	case NavDataGalileoINav:
 	case NavDataGalileoFNav:
@@ -127,6 +135,7 @@ bool CNavData::AddNavData(NavDataType Type, void *NavData)
 		}
 		memcpy(&GalileoEphemerisPool[GalileoEphemerisNumber], NavData, sizeof(GPS_EPHEMERIS));
 		GalileoEphemerisNumber ++;
+		EphIndexValid[GalileoSystem] = false;
 		break;
 	case NavDataGlonassFdma:
 		if (GlonassEphemerisNumber == GlonassEphemerisPoolSize)
@@ -139,6 +148,7 @@ bool CNavData::AddNavData(NavDataType Type, void *NavData)
 		}
 		memcpy(&GlonassEphemerisPool[GlonassEphemerisNumber], NavData, sizeof(GLONASS_EPHEMERIS));
 		GlonassEphemerisNumber ++;
+		EphIndexValid[GlonassSystem] = false;
 		break;
 	case NavDataGpsUtc:
 		UtcParam->TLS = UtcParam->TLSF = GpsUtcParam.TLS;	// set TLS/TLSF field in UtcParam with correct before memcpy()
@@ -168,63 +178,82 @@ bool CNavData::AddNavData(NavDataType Type, void *NavData)
 	return true;
 }
 
+// ephemeris of svid within +-2 hours found by binary search in index, then desired source first,
+// smaller time difference second and earlier loaded last
 PGPS_EPHEMERIS CNavData::FindEphemeris(GnssSystem system, GNSS_TIME time, int svid, int IgnoreTimeLimit, unsigned char FirstPrioritySource)
 {
-	int i, time_diff, diff;
+	int i, time_diff = 0, diff, priority, eph_priority = -1;
+	int First, Last, Key;
 	PGPS_EPHEMERIS Eph = NULL;
 	PGPS_EPHEMERIS EphemerisPool;
-	int EphemerisNumber;
-	int Week = time.Week;
-	BOOL DoAssignment = 0;
+	int *Index;
 
 	if (system == GpsSystem)
-	{
 		EphemerisPool = GpsEphemerisPool;
-		EphemerisNumber = GpsEphemerisNumber;
-	}
 	else if (system == BdsSystem)
-	{
 		EphemerisPool = BdsEphemerisPool;
-		EphemerisNumber = BdsEphemerisNumber;
-	}
 	else if (system == GalileoSystem)
-	{
 		EphemerisPool = GalileoEphemerisPool;
-		EphemerisNumber = GalileoEphemerisNumber;
-	}
 	else
 		return (PGPS_EPHEMERIS)0;
+	if (svid <= 0 || svid > EPH_INDEX_SVID)
+		return (PGPS_EPHEMERIS)0;
+	if (!EphIndexValid[system])
+		BuildEphIndex(system);
 
-
-	for (i = 0; i < EphemerisNumber; i ++)
+	Index = EphIndex[system];
+	Key = time.Week * 604800 + time.MilliSeconds / 1000;
+	First = EphIndexStart[system][svid];
+	Last = EphIndexStart[system][svid+1];
+	if (!IgnoreTimeLimit)
 	{
-		if (EphemerisPool[i].health != 0)
-			continue;
-		if ((system == GpsSystem) && (EphemerisPool[i].toe % 1200) != 0)	// filter out toe not multiple of 2^4 and 300
-			continue;
-		else if ((system == BdsSystem) && (EphemerisPool[i].toe % 600) != 0)	// filter out toe not multiple of 2^3 and 300
-			continue;
-		else if ((system == GalileoSystem) && (EphemerisPool[i].toe % 60) != 0)	// filter out toe not multiple of 60
-			continue;
-		diff = (Week - EphemerisPool[i].week) * 604800 + (time.MilliSeconds / 1000 - EphemerisPool[i].toe);
+		First = EphIndexLowerBound(system, First, Last, Key - 7200);
+		Last = EphIndexLowerBound(system, First, Last, Key + 7201);
+	}
+	for (i = First; i < Last; i ++)
+	{
+		diff = EphemerisKey(system, Index[i]) - Key;
 		if (diff < 0)
 			diff = -diff;
-		if (svid == EphemerisPool[i].svid)	// same svid
+		priority = (EphemerisPool[Index[i]].source == FirstPrioritySource) ? 1 : 0;
+		if (Eph == NULL || priority > eph_priority || (priority == eph_priority && (diff < time_diff || (diff == time_diff && &EphemerisPool[Index[i]] < Eph))))
+		{
+			Eph = &EphemerisPool[Index[i]];
+			time_diff = diff;
+			eph_priority = priority;
+		}
+	}
+
+	return Eph;
+}
+
+PGLONASS_EPHEMERIS CNavData::FindGloEphemeris(GLONASS_TIME GlonassTime, int slot)
+{
+	int i, time_diff, diff, cycle;
+	int First, Last, Key;
+	PGLONASS_EPHEMERIS Eph = NULL;
+	int *Index;
+
+	if (slot <= 0 || slot > EPH_INDEX_SVID)
+		return NULL;
+	if (!EphIndexValid[GlonassSystem])
+		BuildEphIndex(GlonassSystem);
+
+	Index = EphIndex[GlonassSystem];
+	// day number repeats every 1461 days, so also search one cycle before and after
+	for (cycle = -1; cycle <= 1; cycle ++)
+	{
+		Key = (GlonassTime.Day + cycle * 1461) * 86400 + GlonassTime.MilliSeconds / 1000;
+		First = EphIndexLowerBound(GlonassSystem, EphIndexStart[GlonassSystem][slot], EphIndexStart[GlonassSystem][slot+1], Key - 1799);
+		Last = EphIndexLowerBound(GlonassSystem, First, EphIndexStart[GlonassSystem][slot+1], Key + 1800);
+		for (i = First; i < Last; i ++)
 		{
-			if (!IgnoreTimeLimit && diff > 7200) // exceed +-2 hours time span
-				DoAssignment = 0;
-			else if (Eph == NULL)	// not assigned, assign anyway
-				DoAssignment = 1;
-			else if (Eph->source != FirstPrioritySource && EphemerisPool[i].source == FirstPrioritySource)	// new ephemeris from desired source
-				DoAssignment = 1;
-			else if (diff < time_diff)	// either both old and new ephemeris do or do not from desired source, but has smaller time difference
-				DoAssignment = 1;
-			else
-				DoAssignment = 0;
-
-			if (DoAssignment)
+			diff = EphemerisKey(GlonassSystem, Index[i]) - Key;
+			if (diff < 0)
+				diff = -diff;
+			if (Eph == NULL || diff < time_diff || (diff == time_diff && &GlonassEphemerisPool[Index[i]] < Eph))
 			{
-				Eph = &EphemerisPool[i];
+				Eph = &GlonassEphemerisPool[Index[i]];
 				time_diff = diff;
 			}
 		}
@@ -233,32 +262,135 @@ PGPS_EPHEMERIS CNavData::FindEphemeris(GnssSystem system, GNSS_TIME time, int sv
 	return Eph;
 }
 
-PGLONASS_EPHEMERIS CNavData::FindGloEphemeris(GLONASS_TIME GlonassTime, int slot)
+// milliseconds from time until FindEphemeris() with same arguments returns another ephemeris (or NULL),
+// -1 if not within EPH_SWITCH_MAX_SPAN
+// the result only changes at second an ephemeris enters or leaves +-2 hours span or at middle of reference time of two ephemeris,
+// so only these seconds are checked
+int CNavData::GetEphemerisSwitchTime(GnssSystem system, GNSS_TIME time, int svid, int IgnoreTimeLimit, unsigned char FirstPrioritySource)
 {
-	int i, time_diff, diff;
-	PGLONASS_EPHEMERIS Eph = NULL;
+	int i, j, First, Last, Key, EphKey, PrevKey, PrevPriorityKey, Switch = -1;
+	int Candidate[6], CandidateNumber;
+	PGPS_EPHEMERIS Eph, EphemerisPool;
+	GNSS_TIME CandidateTime;
+	int *Index;
+
+	Eph = FindEphemeris(system, time, svid, IgnoreTimeLimit, FirstPrioritySource);	// this also builds index
+	if (system > GalileoSystem || svid <= 0 || svid > EPH_INDEX_SVID)
+		return -1;
+	EphemerisPool = (system == GpsSystem) ? GpsEphemerisPool : (system == BdsSystem) ? BdsEphemerisPool : GalileoEphemerisPool;
+	Index = EphIndex[system];
+	Key = time.Week * 604800 + time.MilliSeconds / 1000;
+	First = EphIndexStart[system][svid];
+	Last = EphIndexStart[system][svid+1];
+	if (!IgnoreTimeLimit)
+	{
+		if (Eph == NULL)	// first ephemeris entering time span
+		{
+			i = EphIndexLowerBound(system, First, Last, Key + 7201);
+			Switch = (i < Last) ? EphemerisKey(system, Index[i]) - 7200 : -1;
+			return (Switch < 0 || Switch - Key > EPH_SWITCH_MAX_SPAN) ? -1 : (Switch - Key) * 1000 - time.MilliSeconds % 1000;
+		}
+		// current ephemeris leaves time span within 14401 seconds, ephemeris later than this do not matter
+		First = EphIndexLowerBound(system, First, Last, Key - 7200);
+		Last = EphIndexLowerBound(system, First, Last, Key + 21602);
+	}
 
-	for (i = 0; i < GlonassEphemerisNumber; i ++)
+	PrevKey = PrevPriorityKey = -1;
+	for (i = First; i < Last; i ++)
 	{
-		if (slot != (int)GlonassEphemerisPool[i].n)
+		EphKey = EphemerisKey(system, Index[i]);
+		CandidateNumber = 0;
+		if (!IgnoreTimeLimit)
+		{
+			Candidate[CandidateNumber ++] = EphKey - 7200;
+			Candidate[CandidateNumber ++] = EphKey + 7201;
+		}
+		if (PrevKey >= 0)
+		{
+			Candidate[CandidateNumber ++] = PrevKey + (EphKey - PrevKey) / 2;
+			Candidate[CandidateNumber ++] = PrevKey + (EphKey - PrevKey) / 2 + 1;
+		}
+		if (EphemerisPool[Index[i]].source == FirstPrioritySource)
+		{
+			if (PrevPriorityKey >= 0)
+			{
+				Candidate[CandidateNumber ++] = PrevPriorityKey + (EphKey - PrevPriorityKey) / 2;
+				Candidate[CandidateNumber ++] = PrevPriorityKey + (EphKey - PrevPriorityKey) / 2 + 1;
+			}
+			PrevPriorityKey = EphKey;
+		}
+		PrevKey = EphKey;
+		for (j = 0; j < CandidateNumber; j ++)
+		{
+			if (Candidate[j] <= Key || (Switch >= 0 && Candidate[j] >= Switch))
+				continue;
+			CandidateTime.Week = Candidate[j] / 604800;
+			CandidateTime.MilliSeconds = Candidate[j] % 604800 * 1000;
+			CandidateTime.SubMilliSeconds = 0.0;
+			if (FindEphemeris(system, CandidateTime, svid, IgnoreTimeLimit, FirstPrioritySource) != Eph)
+				Switch = Candidate[j];
+		}
+	}
+
+	return (Switch < 0 || Switch - Key > EPH_SWITCH_MAX_SPAN) ? -1 : (Switch - Key) * 1000 - time.MilliSeconds % 1000;
+}
+
+// milliseconds from GlonassTime until FindGloEphemeris() returns another ephemeris (or NULL), -1 if not within EPH_SWITCH_MAX_SPAN
+int CNavData::GetGloEphemerisSwitchTime(GLONASS_TIME GlonassTime, int slot)
+{
+	int i, j, cycle, First, Last, Key, EphKey, PrevKey, Switch = -1;
+	int Candidate[4], CandidateNumber;
+	PGLONASS_EPHEMERIS Eph;
+	GLONASS_TIME CandidateTime = GlonassTime;
+	int *Index;
+
+	Eph = FindGloEphemeris(GlonassTime, slot);	// this also builds index
+	if (slot <= 0 || slot > EPH_INDEX_SVID)
+		return -1;
+	Index = EphIndex[GlonassSystem];
+	// search each day number cycle with candidate seconds converted to current cycle
+	for (cycle = -1; cycle <= 1; cycle ++)
+	{
+		Key = (GlonassTime.Day + cycle * 1461) * 86400 + GlonassTime.MilliSeconds / 1000;
+		First = EphIndexStart[GlonassSystem][slot];
+		Last = EphIndexStart[GlonassSystem][slot+1];
+		if (Eph == NULL)	// first ephemeris entering time span
+		{
+			i = EphIndexLowerBound(GlonassSystem, First, Last, Key + 1800);
+			if (i < Last && (Switch < 0 || EphemerisKey(GlonassSystem, Index[i]) - 1799 - Key < Switch))
+				Switch = EphemerisKey(GlonassSystem, Index[i]) - 1799 - Key;
 			continue;
-		diff = GlonassTime.Day - GlonassEphemerisPool[i].day;
-		// day range between -730~730
-		if (diff > 730)
-			diff -= 1461;
-		else if (diff < -730)
-			diff += 1461;
-		diff = diff * 86400 + (GlonassTime.MilliSeconds / 1000 - GlonassEphemerisPool[i].tb);
-		if (diff < 0)
-			diff = -diff;
-		if ((diff < 1800) && ((Eph == NULL) || ((Eph != NULL) && (diff < time_diff))))
+		}
+		// current ephemeris leaves time span within 3599 seconds
+		First = EphIndexLowerBound(GlonassSystem, First, Last, Key - 1799);
+		Last = EphIndexLowerBound(GlonassSystem, First, Last, Key + 5399);
+		PrevKey = -1;
+		for (i = First; i < Last; i ++)
 		{
-			Eph = &GlonassEphemerisPool[i];
-			time_diff = diff;
+			EphKey = EphemerisKey(GlonassSystem, Index[i]);
+			CandidateNumber = 0;
+			Candidate[CandidateNumber ++] = EphKey - 1799;
+			Candidate[CandidateNumber ++] = EphKey + 1800;
+			if (PrevKey >= 0)
+			{
+				Candidate[CandidateNumber ++] = PrevKey + (EphKey - PrevKey) / 2;
+				Candidate[CandidateNumber ++] = PrevKey + (EphKey - PrevKey) / 2 + 1;
+			}
+			PrevKey = EphKey;
+			for (j = 0; j < CandidateNumber; j ++)
+			{
+				Candidate[j] -= Key;	// seconds after GlonassTime
+				if (Candidate[j] <= 0 || (Switch >= 0 && Candidate[j] >= Switch))
+					continue;
+				CandidateTime.Day = GlonassTime.Day + (GlonassTime.MilliSeconds / 1000 + Candidate[j]) / 86400;
+				CandidateTime.MilliSeconds = (GlonassTime.MilliSeconds / 1000 + Candidate[j]) % 86400 * 1000;
+				if (FindGloEphemeris(CandidateTime, slot) != Eph)
+					Switch = Candidate[j];
+			}
 		}
 	}
 
-	return Eph;
+	return (Switch < 0 || Switch > EPH_SWITCH_MAX_SPAN) ? -1 : Switch * 1000 - GlonassTime.MilliSeconds % 1000;
 }
 
 void CNavData::ReadNavFile(char *filename)
@@ -433,3 +565,87 @@ void CNavData::CompleteGlonassAlmanac(GLONASS_TIME time)
 			GlonassAlmanac[i].lambda * 180, GlonassAlmanac[i].w * 180, GlonassAlmanac[i].clock_error, GlonassAlmanac[i].freq);*/
 	}
 }
+
+// sort usable ephemeris of system into index, counting sort on svid keeps loading order,
+// then insertion sort on reference time within each svid, which is close to linear as RINEX records are in time order
+void CNavData::BuildEphIndex(GnssSystem system)
+{
+	int i, j, svid, Key, PoolIndex, EphemerisNumber, ToeModulo;
+	int *Start = EphIndexStart[system], *Index, Fill[EPH_INDEX_SVID+1];
+	PGPS_EPHEMERIS EphemerisPool;
+
+	switch (system)
+	{
+	case GpsSystem: EphemerisPool = GpsEphemerisPool; EphemerisNumber = GpsEphemerisNumber; ToeModulo = 1200; break;	// filter out toe not multiple of 2^4 and 300
+	case BdsSystem: EphemerisPool = BdsEphemerisPool; EphemerisNumber = BdsEphemerisNumber; ToeModulo = 600; break;	// filter out toe not multiple of 2^3 and 300
+	case GalileoSystem: EphemerisPool = GalileoEphemerisPool; EphemerisNumber = GalileoEphemerisNumber; ToeModulo = 60; break;	// filter out toe not multiple of 60
+	default: EphemerisPool = NULL; EphemerisNumber = GlonassEphemerisNumber; ToeModulo = 0; break;
+	}
+	free(EphIndex[system]);
+	Index = EphIndex[system] = (int *)malloc(sizeof(int) * (EphemerisNumber > 0 ? EphemerisNumber : 1));
+
+	// count ephemeris of each svid in Start[svid+1], 0 as svid of ephemeris not usable
+	memset(EphIndexStart[system], 0, sizeof(EphIndexStart[system]));
+	for (i = 0; i < EphemerisNumber; i ++)
+	{
+		if (EphemerisPool)
+			svid = (EphemerisPool[i].health == 0 && (EphemerisPool[i].toe % ToeModulo) == 0) ? EphemerisPool[i].svid : 0;
+		else
+			svid = GlonassEphemerisPool[i].n;
+		if (svid > 0 && svid <= EPH_INDEX_SVID)
+			Start[svid+1] ++;
+	}
+	for (svid = 1; svid <= EPH_INDEX_SVID; svid ++)
+		Start[svid+1] += Start[svid];
+	memcpy(Fill, Start, sizeof(Fill));
+	for (i = 0; i < EphemerisNumber; i ++)
+	{
+		if (EphemerisPool)
+			svid = (EphemerisPool[i].health == 0 && (EphemerisPool[i].toe % ToeModulo) == 0) ? EphemerisPool[i].svid : 0;
+		else
+			svid = GlonassEphemerisPool[i].n;
+		if (svid > 0 && svid <= EPH_INDEX_SVID)
+			Index[Fill[svid] ++] = i;
+	}
+
+	for (svid = 1; svid <= EPH_INDEX_SVID; svid ++)
+	{
+		for (i = Start[svid] + 1; i < Start[svid+1]; i ++)
+		{
+			PoolIndex = Index[i];
+			Key = EphemerisKey(system, PoolIndex);
+			for (j = i; j > Start[svid] && EphemerisKey(system, Index[j-1]) > Key; j --)
+				Index[j] = Index[j-1];
+			Index[j] = PoolIndex;
+		}
+	}
+	EphIndexValid[system] = true;
+}
+
+// reference time in seconds to sort ephemeris, GLONASS counted from start of 4-year cycle
+int CNavData::EphemerisKey(GnssSystem system, int PoolIndex)
+{
+	switch (system)
+	{
+	case GpsSystem: return GpsEphemerisPool[PoolIndex].week * 604800 + GpsEphemerisPool[PoolIndex].toe;
+	case BdsSystem: return BdsEphemerisPool[PoolIndex].week * 604800 + BdsEphemerisPool[PoolIndex].toe;
+	case GalileoSystem: return GalileoEphemerisPool[PoolIndex].week * 604800 + GalileoEphemerisPool[PoolIndex].toe;
+	default: return GlonassEphemerisPool[PoolIndex].day * 86400 + (int)GlonassEphemerisPool[PoolIndex].tb;
+	}
+}
+
+// first position within EphIndex[system][First] to EphIndex[system][Last-1] with reference time not less than Key, Last if none
+int CNavData::EphIndexLowerBound(GnssSystem system, int First, int Last, int Key)
+{
+	int Middle;
+
+	while (First < Last)
+	{
+		Middle = (First + Last) / 2;
+		if (EphemerisKey(system, EphIndex[system][Middle]) < Key)
+			First = Middle + 1;
+		else
+			Last = Middle;
+	}
+	return First;
+}
@@ -0,0 +1,348 @@
+//----------------------------------------------------------------------
+// NoiseGenerator.cpp:
+//   Implementation of Gaussian noise generation class
+//
+//          Copyright (C) 2020-2029 by Jun Mo, All rights reserved.
+//
+//----------------------------------------------------------------------
+
+#include <math.h>
+#include <string.h>
+#include <new>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "BasicTypes.h"
+#include "FastMath.h"
+#include "NoiseGenerator.h"
+
+#define LN2 0.69314718055994530942
+#define SQRT2 1.41421356237309504880
+#define DOUBLE_EXP_MAGIC 0x4330000000000000ULL	// bit pattern of 2^52, used to convert integer to double
+#define RING_BUFFER_BLOCK_INDEX 0xffffffffffffffffULL	// block index of random streams filling ring buffer
+#define RING_BUFFER_SALT 0x5851f42d4c957f2dULL	// distinguish offset/permutation hash from noise stream seed
+
+static inline unsigned long long SplitMix64(unsigned long long &x)
+{
+	unsigned long long z = (x += 0x9e3779b97f4a7c15ULL);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+static inline unsigned long long AsBits(double Value)
+{
+	unsigned long long Bits;
+	memcpy(&Bits, &Value, sizeof(Bits));
+	return Bits;
+}
+
+static inline double AsDouble(unsigned long long Bits)
+{
+	double Value;
+	memcpy(&Value, &Bits, sizeof(Value));
+	return Value;
+}
+
+// radius of Box-Muller transform sqrt(-2ln(u)) with u = (Random + 0.5) / 2^32
+// ln(m) for m in [sqrt(0.5), sqrt(2)) uses series of atanh, truncation error below 1e-9
+static inline double NoiseRadius(unsigned int Random)
+{
+	unsigned long long Bits = AsBits((double)Random + 0.5);
+	double Exp = (double)(Bits >> 52), Mantissa = AsDouble((Bits & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL);
+	double s, s2, LnMantissa;
+
+	if (Mantissa > SQRT2)
+	{
+		Mantissa *= 0.5;
+		Exp += 1.0;
+	}
+	s = (Mantissa - 1.0) / (Mantissa + 1.0);
+	s2 = s * s;
+	LnMantissa = 2.0 * s * (1.0 + s2 * (1.0 / 3 + s2 * (1.0 / 5 + s2 * (1.0 / 7 + s2 * (1.0 / 9)))));
+	return sqrt(-2.0 * ((Exp - (1023 + 32)) * LN2 + LnMantissa));
+}
+
+static inline unsigned long long Rotl(unsigned long long x, int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+// store one noise sample to double/float/int16 buffer, int16 value rounded and saturated
+static inline void StoreNoise(double *Output, double Real, double Imag)
+{
+	Output[0] = Real;
+	Output[1] = Imag;
+}
+
+static inline void StoreNoise(float *Output, double Real, double Imag)
+{
+	Output[0] = (float)Real;
+	Output[1] = (float)Imag;
+}
+
+static inline void StoreNoise(short *Output, double Real, double Imag)
+{
+	Real = rint(Real * INT16_SAMPLE_SCALE);
+	Imag = rint(Imag * INT16_SAMPLE_SCALE);
+	Output[0] = (short)((Real > 32767.) ? 32767 : (Real < -32768.) ? -32768 : Real);
+	Output[1] = (short)((Imag > 32767.) ? 32767 : (Imag < -32768.) ? -32768 : Imag);
+}
+
+#if defined(__AVX2__)
+// store 4 noise samples, Real/Imag hold lanes 0~3
+static inline void StoreNoiseVector(double *Output, __m256d Real, __m256d Imag)
+{
+	__m256d Low = _mm256_unpacklo_pd(Real, Imag), High = _mm256_unpackhi_pd(Real, Imag);
+
+	_mm256_storeu_pd(Output, _mm256_permute2f128_pd(Low, High, 0x20));
+	_mm256_storeu_pd(Output + 4, _mm256_permute2f128_pd(Low, High, 0x31));
+}
+
+static inline void StoreNoiseVector(float *Output, __m256d Real, __m256d Imag)
+{
+	__m128 RealFloat = _mm256_cvtpd_ps(Real), ImagFloat = _mm256_cvtpd_ps(Imag);
+
+	_mm_storeu_ps(Output, _mm_unpacklo_ps(RealFloat, ImagFloat));
+	_mm_storeu_ps(Output + 4, _mm_unpackhi_ps(RealFloat, ImagFloat));
+}
+
+static inline void StoreNoiseVector(short *Output, __m256d Real, __m256d Imag)
+{
+	const __m256d Scale = _mm256_set1_pd(INT16_SAMPLE_SCALE);
+	__m128i RealInt = _mm256_cvtpd_epi32(_mm256_mul_pd(Real, Scale)), ImagInt = _mm256_cvtpd_epi32(_mm256_mul_pd(Imag, Scale));
+
+	_mm_storeu_si128((__m128i *)Output, _mm_packs_epi32(_mm_unpacklo_epi32(RealInt, ImagInt), _mm_unpackhi_epi32(RealInt, ImagInt)));
+}
+#endif
+
+// copy one sample from ring buffer applying permutation, bit0/bit1 negate real/imag, bit2 swaps real and imag
+// negation of int16 sample saturates (-32768 becomes 32767)
+template <typename T> static inline T NegateSample(T Value) { return -Value; }
+template <> inline short NegateSample<short>(short Value) { return (Value == -32768) ? 32767 : -Value; }
+
+template <typename T> static void CopyPermuted(T *Output, const T *Input, int SampleNumber, int Permutation)
+{
+	int i, Swap = (Permutation >> 2) & 1;
+
+	switch (Permutation & 3)
+	{
+	case 0:
+		for (i = 0; i < SampleNumber; i ++) { Output[i*2] = Input[i*2+Swap]; Output[i*2+1] = Input[i*2+1-Swap]; }
+		break;
+	case 1:
+		for (i = 0; i < SampleNumber; i ++) { Output[i*2] = NegateSample(Input[i*2+Swap]); Output[i*2+1] = Input[i*2+1-Swap]; }
+		break;
+	case 2:
+		for (i = 0; i < SampleNumber; i ++) { Output[i*2] = Input[i*2+Swap]; Output[i*2+1] = NegateSample(Input[i*2+1-Swap]); }
+		break;
+	case 3:
+		for (i = 0; i < SampleNumber; i ++) { Output[i*2] = NegateSample(Input[i*2+Swap]); Output[i*2+1] = NegateSample(Input[i*2+1-Swap]); }
+		break;
+	}
+}
+
+CNoiseGenerator::CNoiseGenerator(unsigned int NoiseSeed) : Seed(NoiseSeed)
+{
+	RingBuffer = NULL;
+	RingBufferLength = 0;
+	RingBufferSampleSize = 0;
+	RingBufferSigma = 0.0;
+	FastMath::InitializeLUT();
+}
+
+CNoiseGenerator::~CNoiseGenerator()
+{
+	ReleaseRingBuffer();
+}
+
+// Fill SampleNumber complex noise samples of block BlockIndex
+// sub-blocks are independent and generated in parallel if OpenMP enabled
+// if ring buffer of the same sample type and sigma exists, sub-blocks are copied from ring buffer
+template <typename T> void CNoiseGenerator::Generate(T *Samples, int SampleNumber, unsigned long long BlockIndex, double Sigma)
+{
+	int SubBlockNumber = (SampleNumber + NOISE_SUB_BLOCK_SIZE - 1) / NOISE_SUB_BLOCK_SIZE;
+	int UseRingBuffer = (RingBuffer != NULL && RingBufferSampleSize == (int)sizeof(T) && RingBufferSigma == Sigma);
+	int i;
+
+	#pragma omp parallel for schedule(static) if (SubBlockNumber > 1)
+	for (i = 0; i < SubBlockNumber; i ++)
+	{
+		unsigned long long State[4][NOISE_LANE_NUMBER];
+		int Length = (i == SubBlockNumber - 1) ? SampleNumber - i * NOISE_SUB_BLOCK_SIZE : NOISE_SUB_BLOCK_SIZE;
+
+		if (UseRingBuffer)
+			CopySubBlock(Samples + i * NOISE_SUB_BLOCK_SIZE * 2, Length, BlockIndex, i);
+		else
+		{
+			InitStream(State, BlockIndex, i);
+			GenerateSubBlock(Samples + i * NOISE_SUB_BLOCK_SIZE * 2, Length, State, Sigma);
+		}
+	}
+}
+
+// Pre-generate ring buffer of BufferSize bytes with sample type T, filled by sub-block streams of a reserved block index
+// return number of complex samples in ring buffer, 0 if buffer too small or allocation fails
+template <typename T> long long CNoiseGenerator::CreateRingBuffer(long long BufferSize, double Sigma)
+{
+	long long Length = BufferSize / (sizeof(T) * 2);
+	long long SubBlockNumber = (Length + NOISE_SUB_BLOCK_SIZE - 1) / NOISE_SUB_BLOCK_SIZE, i;
+	T *Buffer;
+
+	ReleaseRingBuffer();
+	if (Length == 0)
+		return 0;
+	if ((Buffer = new (std::nothrow) T[Length * 2]) == NULL)
+		return 0;
+
+	#pragma omp parallel for schedule(static)
+	for (i = 0; i < SubBlockNumber; i ++)
+	{
+		unsigned long long State[4][NOISE_LANE_NUMBER];
+		int SubBlockLength = (int)(Length - i * NOISE_SUB_BLOCK_SIZE);
+
+		InitStream(State, RING_BUFFER_BLOCK_INDEX, (int)i);
+		GenerateSubBlock(Buffer + i * NOISE_SUB_BLOCK_SIZE * 2, (SubBlockLength < NOISE_SUB_BLOCK_SIZE) ? SubBlockLength : NOISE_SUB_BLOCK_SIZE, State, Sigma);
+	}
+	RingBuffer = Buffer;
+	RingBufferLength = Length;
+	RingBufferSampleSize = sizeof(T);
+	RingBufferSigma = Sigma;
+	return Length;
+}
+
+void CNoiseGenerator::ReleaseRingBuffer()
+{
+	switch (RingBufferSampleSize)
+	{
+	case sizeof(double): delete[] (double *)RingBuffer; break;
+	case sizeof(float): delete[] (float *)RingBuffer; break;
+	case sizeof(short): delete[] (short *)RingBuffer; break;
+	}
+	RingBuffer = NULL;
+	RingBufferLength = 0;
+	RingBufferSampleSize = 0;
+}
+
+// xoshiro256+ state of each lane is seeded by SplitMix64 from hash of seed, block index, sub-block index and lane
+void CNoiseGenerator::InitStream(unsigned long long State[4][NOISE_LANE_NUMBER], unsigned long long BlockIndex, int SubBlockIndex)
+{
+	unsigned long long Hash = Seed, Key;
+	int i, j;
+
+	Key = SplitMix64(Hash) ^ BlockIndex;
+	Key = SplitMix64(Key) ^ (unsigned long long)SubBlockIndex;
+	for (i = 0; i < NOISE_LANE_NUMBER; i ++)
+	{
+		Hash = SplitMix64(Key) + i;
+		for (j = 0; j < 4; j ++)
+			State[j][i] = SplitMix64(Hash);
+	}
+}
+
+// sample k of the sub-block uses lane k % NOISE_LANE_NUMBER, upper 32 bits of random value
+// determines radius and bit 16~31 determines angle
+template <typename T> void CNoiseGenerator::GenerateSubBlock(T *Samples, int SampleNumber, unsigned long long State[4][NOISE_LANE_NUMBER], double Sigma)
+{
+	const double *SinLut = FastMath::GetSinLut();
+	const double *CosLut = SinLut + FastMath::TRIG_LUT_SIZE / 4;
+	unsigned long long Result, Temp;
+	double Radius;
+	int i = 0, Lane;
+
+#if defined(__AVX2__) && (NOISE_LANE_NUMBER == 4)
+	{
+		const __m256i PackIndex = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+		const __m256i ExpMagic = _mm256_set1_epi64x((long long)DOUBLE_EXP_MAGIC), MantissaMask = _mm256_set1_epi64x(0x000fffffffffffffLL), One = _mm256_set1_epi64x(0x3ff0000000000000LL);
+		const __m256d Magic = _mm256_set1_pd(4503599627370496.0), Half = _mm256_set1_pd(0.5), OneDouble = _mm256_set1_pd(1.0), Two = _mm256_set1_pd(2.0);
+		const __m256d Sqrt2 = _mm256_set1_pd(SQRT2), Ln2 = _mm256_set1_pd(LN2), ExpBias = _mm256_set1_pd(1023 + 32), MinusTwo = _mm256_set1_pd(-2.0), SigmaVector = _mm256_set1_pd(Sigma);
+		const __m256d C3 = _mm256_set1_pd(1.0 / 3), C5 = _mm256_set1_pd(1.0 / 5), C7 = _mm256_set1_pd(1.0 / 7), C9 = _mm256_set1_pd(1.0 / 9);
+		__m256i s0 = _mm256_loadu_si256((__m256i *)State[0]), s1 = _mm256_loadu_si256((__m256i *)State[1]);
+		__m256i s2 = _mm256_loadu_si256((__m256i *)State[2]), s3 = _mm256_loadu_si256((__m256i *)State[3]);
+		__m256i RandomVector, t, Bits;
+		__m128i LutIndex;
+		__m256d Value, Exp, Mantissa, Mask, s, ss, LnMantissa, RadiusVector;
+
+		for (; i + NOISE_LANE_NUMBER <= SampleNumber; i += NOISE_LANE_NUMBER)
+		{
+			// xoshiro256+
+			RandomVector = _mm256_add_epi64(s0, s3);
+			t = _mm256_slli_epi64(s1, 17);
+			s2 = _mm256_xor_si256(s2, s0);
+			s3 = _mm256_xor_si256(s3, s1);
+			s1 = _mm256_xor_si256(s1, s2);
+			s0 = _mm256_xor_si256(s0, s3);
+			s2 = _mm256_xor_si256(s2, t);
+			s3 = _mm256_or_si256(_mm256_slli_epi64(s3, 45), _mm256_srli_epi64(s3, 19));
+			// radius from upper 32 bits
+			Value = _mm256_add_pd(_mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(RandomVector, 32), ExpMagic)), Magic), Half);
+			Bits = _mm256_castpd_si256(Value);
+			Exp = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(Bits, 52), ExpMagic)), Magic);
+			Mantissa = _mm256_castsi256_pd(_mm256_or_si256(_mm256_and_si256(Bits, MantissaMask), One));
+			Mask = _mm256_cmp_pd(Mantissa, Sqrt2, _CMP_GT_OQ);
+			Mantissa = _mm256_blendv_pd(Mantissa, _mm256_mul_pd(Mantissa, Half), Mask);
+			Exp = _mm256_add_pd(Exp, _mm256_and_pd(Mask, OneDouble));
+			s = _mm256_div_pd(_mm256_sub_pd(Mantissa, OneDouble), _mm256_add_pd(Mantissa, OneDouble));
+			ss = _mm256_mul_pd(s, s);
+			LnMantissa = _mm256_add_pd(C7, _mm256_mul_pd(ss, C9));
+			LnMantissa = _mm256_add_pd(C5, _mm256_mul_pd(ss, LnMantissa));
+			LnMantissa = _mm256_add_pd(C3, _mm256_mul_pd(ss, LnMantissa));
+			LnMantissa = _mm256_add_pd(OneDouble, _mm256_mul_pd(ss, LnMantissa));
+			LnMantissa = _mm256_mul_pd(_mm256_mul_pd(Two, s), LnMantissa);
+			Value = _mm256_add_pd(_mm256_mul_pd(_mm256_sub_pd(Exp, ExpBias), Ln2), LnMantissa);
+			RadiusVector = _mm256_mul_pd(_mm256_sqrt_pd(_mm256_mul_pd(MinusTwo, Value)), SigmaVector);
+			// angle from bit 16~31
+			LutIndex = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(_mm256_srli_epi32(RandomVector, 16), PackIndex));
+			StoreNoiseVector(Samples + i * 2, _mm256_mul_pd(RadiusVector, _mm256_i32gather_pd(CosLut, LutIndex, 8)), _mm256_mul_pd(RadiusVector, _mm256_i32gather_pd(SinLut, LutIndex, 8)));
+		}
+		_mm256_storeu_si256((__m256i *)State[0], s0);
+		_mm256_storeu_si256((__m256i *)State[1], s1);
+		_mm256_storeu_si256((__m256i *)State[2], s2);
+		_mm256_storeu_si256((__m256i *)State[3], s3);
+	}
+#endif
+	// scalar version for remaining samples (or all samples if SIMD not enabled)
+	for (; i < SampleNumber; i ++)
+	{
+		Lane = i % NOISE_LANE_NUMBER;
+		Result = State[0][Lane] + State[3][Lane];
+		Temp = State[1][Lane] << 17;
+		State[2][Lane] ^= State[0][Lane];
+		State[3][Lane] ^= State[1][Lane];
+		State[1][Lane] ^= State[2][Lane];
+		State[0][Lane] ^= State[3][Lane];
+		State[2][Lane] ^= Temp;
+		State[3][Lane] = Rotl(State[3][Lane], 45);
+		Radius = NoiseRadius((unsigned int)(Result >> 32)) * Sigma;
+		StoreNoise(Samples + i * 2, Radius * CosLut[(Result >> 16) & 0xffff], Radius * SinLut[(Result >> 16) & 0xffff]);
+	}
+}
+
+// offset within ring buffer and permutation of sub-block determined by hash of seed, block index and sub-block index
+// a sub-block crossing end of ring buffer wraps to the beginning
+template <typename T> void CNoiseGenerator::CopySubBlock(T *Samples, int SampleNumber, unsigned long long BlockIndex, int SubBlockIndex)
+{
+	const T *Buffer = (const T *)RingBuffer;
+	unsigned long long Hash = Seed ^ RING_BUFFER_SALT, Random;
+	long long Offset;
+	int Permutation, Length;
+
+	Hash = SplitMix64(Hash) ^ BlockIndex;
+	Hash = SplitMix64(Hash) ^ (unsigned long long)SubBlockIndex;
+	Random = SplitMix64(Hash);
+	Permutation = (int)(Random % NOISE_PERMUTATION_NUMBER);
+	Offset = (long long)((Random / NOISE_PERMUTATION_NUMBER) % (unsigned long long)RingBufferLength);
+	Length = (Offset + SampleNumber > RingBufferLength) ? (int)(RingBufferLength - Offset) : SampleNumber;
+	CopyPermuted(Samples, Buffer + Offset * 2, Length, Permutation);
+	if (Length < SampleNumber)
+		CopyPermuted(Samples + Length * 2, Buffer, SampleNumber - Length, Permutation);
+}
+
+// instantiation of supported sample types
+template void CNoiseGenerator::Generate<double>(double *Samples, int SampleNumber, unsigned long long BlockIndex, double Sigma);
+template void CNoiseGenerator::Generate<float>(float *Samples, int SampleNumber, unsigned long long BlockIndex, double Sigma);
+template void CNoiseGenerator::Generate<short>(short *Samples, int SampleNumber, unsigned long long BlockIndex, double Sigma);
+template long long CNoiseGenerator::CreateRingBuffer<double>(long long BufferSize, double Sigma);
+template long long CNoiseGenerator::CreateRingBuffer<float>(long long BufferSize, double Sigma);
+template long long CNoiseGenerator::CreateRingBuffer<short>(long long BufferSize, double Sigma);
@@ -0,0 +1,171 @@
+//----------------------------------------------------------------------
+// OrbitInterp.cpp:
+//   Implementation of Chebyshev polynomial interpolation of satellite orbit
+//
+//          Copyright (C) 2020-2029 by Jun Mo, All rights reserved.
+//
+//----------------------------------------------------------------------
+#include <math.h>
+
+#include "ConstVal.h"
+#include "BasicTypes.h"
+#include "Coordinate.h"
+#include "OrbitInterp.h"
+
+static double WeekTimeDiff(double TimeDiff);
+static BOOL SatPosClock(GnssSystem system, double TransmitTime, PGPS_EPHEMERIS Eph, PKINEMATIC_INFO PosVel, double &ClockCorrection);
+static double Clenshaw(const double Coef[], int Number, double x);
+
+void InitOrbitInterp(ORBIT_INTERP Interp[], int Number)
+{
+	int i;
+
+	for (i = 0; i < Number; i ++)
+	{
+		Interp[i].Eph = NULL;
+		Interp[i].Valid = FALSE;
+		Interp[i].AtmosCount = 0;
+	}
+}
+
+// sample position and clock correction at Chebyshev nodes of window and calculate coefficients
+// then check accuracy at window ends and midpoints between nodes where interpolation error is largest
+BOOL FitOrbitInterp(GnssSystem system, PGPS_EPHEMERIS Eph, double StartTime, double Span, PORBIT_INTERP Interp)
+{
+	double Value[4][ORBIT_INTERP_ORDER], Clock, Error;
+	KINEMATIC_INFO PosVel, PosVelFit;
+	int i, j, k;
+
+	Interp->Eph = Eph;
+	Interp->StartTime = StartTime;
+	Interp->Span = Span;
+	Interp->MaxError = 0.0;
+	Interp->Valid = FALSE;
+
+	for (k = 0; k < ORBIT_INTERP_ORDER; k ++)
+	{
+		if (!SatPosClock(system, StartTime + Span * 0.5 * (1 + cos(PI * (k + 0.5) / ORBIT_INTERP_ORDER)), Eph, &PosVel, Clock))
+			return FALSE;
+		Value[0][k] = PosVel.x; Value[1][k] = PosVel.y; Value[2][k] = PosVel.z; Value[3][k] = Clock;
+	}
+	for (i = 0; i < 4; i ++)
+		for (j = 0; j < ORBIT_INTERP_ORDER; j ++)
+		{
+			Interp->Coef[i][j] = 0.0;
+			for (k = 0; k < ORBIT_INTERP_ORDER; k ++)
+				Interp->Coef[i][j] += Value[i][k] * cos(PI * j * (k + 0.5) / ORBIT_INTERP_ORDER);
+			Interp->Coef[i][j] *= ((j == 0) ? 1.0 : 2.0) / ORBIT_INTERP_ORDER;
+		}
+	// derivative coefficients d[j-1] = d[j+1] + 2j*c[j], scaled by dx/dt
+	for (i = 0; i < 3; i ++)
+	{
+		for (j = ORBIT_INTERP_ORDER - 1; j > 0; j --)
+			Interp->DerivCoef[i][j-1] = ((j + 1 < ORBIT_INTERP_ORDER - 1) ? Interp->DerivCoef[i][j+1] : 0.0) + 2 * j * Interp->Coef[i][j];
+		Interp->DerivCoef[i][0] *= 0.5;
+		for (j = 0; j < ORBIT_INTERP_ORDER - 1; j ++)
+			Interp->DerivCoef[i][j] *= 2.0 / Span;
+	}
+
+	for (k = 0; k <= ORBIT_INTERP_ORDER; k ++)
+	{
+		if (!SatPosClock(system, StartTime + Span * 0.5 * (1 + cos(PI * k / ORBIT_INTERP_ORDER)), Eph, &PosVel, Clock))
+			return FALSE;
+		OrbitInterpPosVel(Interp, StartTime + Span * 0.5 * (1 + cos(PI * k / ORBIT_INTERP_ORDER)), &PosVelFit, Error);
+		Error = fabs(Error - Clock) * LIGHT_SPEED;
+		if (Interp->MaxError < Error)
+			Interp->MaxError = Error;
+		Error = sqrt((PosVel.x - PosVelFit.x) * (PosVel.x - PosVelFit.x) + (PosVel.y - PosVelFit.y) * (PosVel.y - PosVelFit.y) + (PosVel.z - PosVelFit.z) * (PosVel.z - PosVelFit.z));
+		if (Interp->MaxError < Error)
+			Interp->MaxError = Error;
+	}
+	Interp->Valid = (Interp->MaxError <= ORBIT_INTERP_TOLERANCE) ? TRUE : FALSE;
+
+	return Interp->Valid;
+}
+
+// whether TransmitTime is within fitting window of Eph (regardless of accuracy check result)
+BOOL OrbitInterpInWindow(PORBIT_INTERP Interp, PGPS_EPHEMERIS Eph, double TransmitTime)
+{
+	double TimeDiff;
+
+	if (Interp->Eph != Eph)
+		return FALSE;
+	TimeDiff = WeekTimeDiff(TransmitTime - Interp->StartTime);
+	return (TimeDiff >= 0 && TimeDiff <= Interp->Span) ? TRUE : FALSE;
+}
+
+void OrbitInterpPosVel(PORBIT_INTERP Interp, double TransmitTime, PKINEMATIC_INFO PosVel, double &ClockCorrection)
+{
+	double x = 2 * WeekTimeDiff(TransmitTime - Interp->StartTime) / Interp->Span - 1;
+
+	PosVel->x = Clenshaw(Interp->Coef[0], ORBIT_INTERP_ORDER, x);
+	PosVel->y = Clenshaw(Interp->Coef[1], ORBIT_INTERP_ORDER, x);
+	PosVel->z = Clenshaw(Interp->Coef[2], ORBIT_INTERP_ORDER, x);
+	PosVel->vx = Clenshaw(Interp->DerivCoef[0], ORBIT_INTERP_ORDER - 1, x);
+	PosVel->vy = Clenshaw(Interp->DerivCoef[1], ORBIT_INTERP_ORDER - 1, x);
+	PosVel->vz = Clenshaw(Interp->DerivCoef[2], ORBIT_INTERP_ORDER - 1, x);
+	ClockCorrection = Clenshaw(Interp->Coef[3], ORBIT_INTERP_ORDER, x);
+}
+
+// return ionosphere and troposphere delay at ReceiverTime, re-evaluated every ATMOS_UPDATE_INTERVAL and extrapolated in between
+// the evaluation after first one (or after a gap) is done on next call so that rate is available from the beginning
+void OrbitInterpAtmosDelay(PORBIT_INTERP Interp, double ReceiverTime, PIONO_PARAM IonoParam, double SatelliteTime, LLA_POSITION PositionLla, double Elevation, double Azimuth, double &Iono, double &Tropo)
+{
+	double TimeDiff = WeekTimeDiff(ReceiverTime - Interp->AtmosTime);
+
+	if (Interp->AtmosCount == 2 && TimeDiff >= 0 && TimeDiff < ATMOS_UPDATE_INTERVAL)
+	{
+		Iono = Interp->IonoDelay + Interp->IonoRate * TimeDiff;
+		Tropo = Interp->TropoDelay + Interp->TropoRate * TimeDiff;
+		return;
+	}
+	Iono = GpsIonoDelay(IonoParam, SatelliteTime, PositionLla.lat, PositionLla.lon, Elevation, Azimuth);
+	Tropo = TropoDelay(PositionLla.lat, PositionLla.alt, Elevation);
+	if (Interp->AtmosCount == 2 && (fabs(Interp->IonoDelay + Interp->IonoRate * TimeDiff - Iono) > ATMOS_MAX_ERROR || fabs(Interp->TropoDelay + Interp->TropoRate * TimeDiff - Tropo) > ATMOS_MAX_ERROR))
+		Interp->AtmosCount = 0;	// discontinuity of delay model (e.g. troposphere delay above 10km), do not use rate across it
+	if (Interp->AtmosCount > 0 && TimeDiff > 0 && TimeDiff < 2 * ATMOS_UPDATE_INTERVAL)
+	{
+		Interp->IonoRate = (Iono - Interp->IonoDelay) / TimeDiff;
+		Interp->TropoRate = (Tropo - Interp->TropoDelay) / TimeDiff;
+		Interp->AtmosCount = 2;
+	}
+	else
+		Interp->AtmosCount = 1;
+	Interp->AtmosTime = ReceiverTime;
+	Interp->IonoDelay = Iono;
+	Interp->TropoDelay = Tropo;
+}
+
+// protection for time ring back at week end
+double WeekTimeDiff(double TimeDiff)
+{
+	if (TimeDiff > 302400.0)
+		TimeDiff -= 604800;
+	else if (TimeDiff < -302400.0)
+		TimeDiff += 604800;
+	return TimeDiff;
+}
+
+// exact satellite position and clock correction with relativity correction at TransmitTime
+BOOL SatPosClock(GnssSystem system, double TransmitTime, PGPS_EPHEMERIS Eph, PKINEMATIC_INFO PosVel, double &ClockCorrection)
+{
+	if (!GpsSatPosSpeedEph(system, TransmitTime, Eph, PosVel, NULL))
+		return FALSE;
+	ClockCorrection = GpsClockCorrection(Eph, TransmitTime) + WGS_F_GTR * Eph->ecc * Eph->sqrtA * sin(Eph->Ek);
+	return TRUE;
+}
+
+// evaluate sum of Coef[i]*T_i(x) with Clenshaw recurrence
+double Clenshaw(const double Coef[], int Number, double x)
+{
+	double b0 = 0.0, b1 = 0.0, b2;
+	int i;
+
+	for (i = Number - 1; i > 0; i --)
+	{
+		b2 = b1;
+		b1 = b0;
+		b0 = Coef[i] + 2 * x * b1 - b2;
+	}
+	return Coef[0] + x * b0 - b1;
+}
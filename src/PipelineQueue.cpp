@@ -0,0 +1,79 @@
+//----------------------------------------------------------------------
+// PipelineQueue.cpp:
+//   Implementation of bounded queue between pipeline stages
+//
+//          Copyright (C) 2020-2029 by Jun Mo, All rights reserved.
+//
+//----------------------------------------------------------------------
+
+#include <chrono>
+#include <thread>
+
+#include "PipelineQueue.h"
+
+// yield first to keep latency low when the other side is about to finish, then sleep to free the core
+static void WaitStep(int &Count)
+{
+	if (++ Count < PIPELINE_SPIN_COUNT)
+		std::this_thread::yield();
+	else
+		std::this_thread::sleep_for(std::chrono::microseconds(PIPELINE_SLEEP_TIME));
+}
+
+CPipelineQueue::CPipelineQueue(int QueueDepth) : WriteIndex(0), ReadIndex(0), Finished(false)
+{
+	Depth = (QueueDepth < 1) ? 1 : QueueDepth;
+	ProducerStall = ConsumerStall = 0.0;
+}
+
+CPipelineQueue::~CPipelineQueue()
+{
+}
+
+int CPipelineQueue::GetWriteSlot()
+{
+	unsigned int Index = WriteIndex.load(std::memory_order_relaxed);
+	int Count = 0;
+
+	if (Index - ReadIndex.load(std::memory_order_acquire) >= (unsigned int)Depth)
+	{
+		auto StartTime = std::chrono::steady_clock::now();
+		while (Index - ReadIndex.load(std::memory_order_acquire) >= (unsigned int)Depth)
+			WaitStep(Count);
+		ProducerStall += std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+	}
+	return (int)(Index % Depth);
+}
+
+void CPipelineQueue::Push()
+{
+	WriteIndex.fetch_add(1, std::memory_order_release);
+}
+
+int CPipelineQueue::GetReadSlot()
+{
+	unsigned int Index = ReadIndex.load(std::memory_order_relaxed);
+	int Count = 0;
+	bool Stop;
+
+	if (Index == WriteIndex.load(std::memory_order_acquire))
+	{
+		auto StartTime = std::chrono::steady_clock::now();
+		while (true)
+		{
+			Stop = Finished.load(std::memory_order_acquire);	// read before checking index so that last slot is not missed
+			if (Index != WriteIndex.load(std::memory_order_acquire))
+				break;
+			if (Stop)
+				return -1;
+			WaitStep(Count);
+		}
+		ConsumerStall += std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+	}
+	return (int)(Index % Depth);
+}
+
+void CPipelineQueue::Pop()
+{
+	ReadIndex.fetch_add(1, std::memory_order_release);
+}
@@ -0,0 +1,350 @@
+//----------------------------------------------------------------------
+// Quantizer.cpp:
+//   Implementation of IF sample quantization class
+//
+//          Copyright (C) 2020-2029 by Jun Mo, All rights reserved.
+//
+//----------------------------------------------------------------------
+
+#include <math.h>
+
+#include "Quantizer.h"
+
+// Gain of each format maps unit noise sigma to:
+//   IQ2: magnitude threshold at 1.1 sigma (optimal threshold for Gauss noise is sigma, increased a little to compensate signal power), clip at 5.5 sigma
+//   IQ4: 3 (magnitude 0~7 with sign bit as MSB)
+//   IQ8: 25 (+-5 sigma within range of INT8)
+//   IQ16: 3277 (+-10 sigma within range of INT16)
+#define IQ2_THRESHOLD 1.1
+#define IQ2_CLIP_THRESHOLD 5.5
+#define IQ4_GAIN 3.0
+#define IQ8_GAIN 25.0
+#define IQ16_GAIN 3277.0
+
+//----------------------------------------------------------------------
+// vectorizable quantizers
+// each loop has no branch, saturation by min/max and clip count accumulated by comparison result
+//----------------------------------------------------------------------
+
+// PocketSDR compatible 2-bit IQ quantization, 2 complex samples in one byte
+// Bit definition within each byte is (from MSB): Sign-Q2, Mag-Q2, Sign-I2, Mag-I2, Sign-Q1, Mag-Q1, Sign-I1, Mag-I1
+// odd last sample fills lower 4 bits with upper 4 bits zero
+template <typename T> static int QuantizeIQ2(const T Samples[], int SampleNumber, unsigned char QuantSamples[], double GainScale)
+{
+	const double Threshold = IQ2_THRESHOLD / GainScale * IfSampleScale<T>();
+	const double ClipThreshold = IQ2_CLIP_THRESHOLD / GainScale * IfSampleScale<T>();
+	int ByteNumber = (SampleNumber + 1) / 2, ComponentNumber = SampleNumber * 2;
+	int i, j, ClippedCount = 0;
+	unsigned int QuantByte;
+	double Value;
+
+	for (i = 0; i < ComponentNumber; i ++)
+		ClippedCount += (fabs((double)Samples[i]) >= ClipThreshold);
+	for (i = 0; i < ComponentNumber / 4; i ++)
+	{
+		QuantByte = 0;
+		for (j = 0; j < 4; j ++)
+		{
+			Value = (double)Samples[i * 4 + j];
+			QuantByte |= ((unsigned int)(fabs(Value) >= Threshold) | ((unsigned int)(Value < 0) << 1)) << (j * 2);
+		}
+		QuantSamples[i] = (unsigned char)QuantByte;
+	}
+	if (i < ByteNumber)
+	{
+		QuantByte = 0;
+		for (j = 0; j < 2; j ++)
+		{
+			Value = (double)Samples[i * 4 + j];
+			QuantByte |= ((unsigned int)(fabs(Value) >= Threshold) | ((unsigned int)(Value < 0) << 1)) << (j * 2);
+		}
+		QuantSamples[i] = (unsigned char)QuantByte;
+	}
+
+	return ClippedCount;
+}
+
+// 4-bit sign-magnitude, I at upper 4 bits and Q at lower 4 bits
+template <typename T> static int QuantizeIQ4(const T Samples[], int SampleNumber, unsigned char QuantSamples[], double GainScale)
+{
+	const double Gain = GainScale * IQ4_GAIN / IfSampleScale<T>();
+	int i, ClippedCount = 0;
+	unsigned int QuantI, QuantQ;
+	double ValueI, ValueQ;
+
+	for (i = 0; i < SampleNumber; i ++)
+	{
+		ValueI = fabs((double)Samples[i * 2]) * Gain;
+		ValueQ = fabs((double)Samples[i * 2 + 1]) * Gain;
+		ClippedCount += (ValueI >= 8.0) + (ValueQ >= 8.0);
+		QuantI = (unsigned int)(int)fmin(ValueI, 7.0) | ((unsigned int)(Samples[i * 2] < 0) << 3);
+		QuantQ = (unsigned int)(int)fmin(ValueQ, 7.0) | ((unsigned int)(Samples[i * 2 + 1] < 0) << 3);
+		QuantSamples[i] = (unsigned char)((QuantI << 4) | QuantQ);
+	}
+
+	return ClippedCount;
+}
+
+// 8-bit two's complement, value truncated toward zero
+template <typename T> static int QuantizeIQ8(const T Samples[], int SampleNumber, unsigned char QuantSamples[], double GainScale)
+{
+	const double Gain = GainScale * IQ8_GAIN / IfSampleScale<T>();
+	int i, ClippedCount = 0, ComponentNumber = SampleNumber * 2;
+	double Value;
+
+	for (i = 0; i < ComponentNumber; i ++)
+	{
+		Value = (double)Samples[i] * Gain;
+		ClippedCount += (Value >= 128.0) + (Value <= -129.0);
+		QuantSamples[i] = (unsigned char)(int)fmax(fmin(Value, 127.0), -128.0);
+	}
+
+	return ClippedCount;
+}
+
+// 16-bit two's complement little endian, value truncated toward zero
+template <typename T> static int QuantizeIQ16(const T Samples[], int SampleNumber, unsigned char QuantSamples[], double GainScale)
+{
+	const double Gain = GainScale * IQ16_GAIN / IfSampleScale<T>();
+	int i, ClippedCount = 0, ComponentNumber = SampleNumber * 2;
+	unsigned int QuantValue;
+	double Value;
+
+	for (i = 0; i < ComponentNumber; i ++)
+	{
+		Value = (double)Samples[i] * Gain;
+		ClippedCount += (Value >= 32768.0) + (Value <= -32769.0);
+		QuantValue = (unsigned int)(int)fmax(fmin(Value, 32767.0), -32768.0);
+		QuantSamples[i * 2] = (unsigned char)(QuantValue & 0xff);
+		QuantSamples[i * 2 + 1] = (unsigned char)((QuantValue >> 8) & 0xff);
+	}
+
+	return ClippedCount;
+}
+
+//----------------------------------------------------------------------
+// scalar reference quantizers, per-component branches for sign and saturation
+//----------------------------------------------------------------------
+
+template <typename T> static int QuantizeIQ2Scalar(const T Samples[], int SampleNumber, unsigned char QuantSamples[], double GainScale)
+{
+	int ClippedCount = 0;
+	const double threshold = IQ2_THRESHOLD / GainScale * IfSampleScale<T>();
+	const double ClippedThreshold = IQ2_CLIP_THRESHOLD / GainScale * IfSampleScale<T>();
+	double Value;
+	unsigned char QuantByte;
+
+	for (int i = 0; i < SampleNumber; i += 2)
+	{
+		QuantByte = (Samples[i*2] < 0) ? 2 : 0;
+		Value = fabs((double)Samples[i*2]);
+		QuantByte |= (Value < threshold) ? 0 : 1;
+		if (Value >= ClippedThreshold) ClippedCount ++;
+		QuantByte |= (Samples[i*2+1] < 0) ? 8 : 0;
+		Value = fabs((double)Samples[i*2+1]);
+		QuantByte |= (Value < threshold) ? 0 : 4;
+		if (Value >= ClippedThreshold) ClippedCount ++;
+		if (i + 1 < SampleNumber)
+		{
+			QuantByte |= (Samples[i*2+2] < 0) ? 0x20 : 0;
+			Value = fabs((double)Samples[i*2+2]);
+			QuantByte |= (Value < threshold) ? 0 : 0x10;
+			if (Value >= ClippedThreshold) ClippedCount ++;
+			QuantByte |= (Samples[i*2+3] < 0) ? 0x80 : 0;
+			Value = fabs((double)Samples[i*2+3]);
+			QuantByte |= (Value < threshold) ? 0 : 0x40;
+			if (Value >= ClippedThreshold) ClippedCount ++;
+		}
+		QuantSamples[i / 2] = QuantByte;
+	}
+
+	return ClippedCount;
+}
+
+template <typename T> static int QuantizeIQ4Scalar(const T Samples[], int SampleNumber, unsigned char QuantSamples[], double GainScale)
+{
+	int i;
+	double Value;
+	unsigned char QuantValue, QuantSample;
+	const double Gain = GainScale * IQ4_GAIN / IfSampleScale<T>();
+	int ClippedCount = 0;
+
+	for (i = 0; i < SampleNumber; i++)
+	{
+		Value = fabs((double)Samples[i*2]) * Gain;
+		if (Value >= 8.0)
+		{
+			QuantValue = 7;
+			ClippedCount ++;
+		}
+		else
+			QuantValue = (int)Value;
+		QuantValue += ((Samples[i*2] >= 0) ? 0 : (1 << 3));	// add sign bit as MSB
+		QuantSample = QuantValue << 4;
+		Value = fabs((double)Samples[i*2+1]) * Gain;
+		if (Value >= 8.0)
+		{
+			QuantValue = 7;
+			ClippedCount ++;
+		}
+		else
+			QuantValue = (int)Value;
+		QuantValue += ((Samples[i*2+1] >= 0) ? 0 : (1 << 3));	// add sign bit as MSB
+		QuantSample |= QuantValue;
+		QuantSamples[i] = QuantSample;
+	}
+
+	return ClippedCount;
+}
+
+template <typename T> static int QuantizeIQ8Scalar(const T Samples[], int SampleNumber, unsigned char QuantSamples[], double GainScale)
+{
+	int i;
+	int QuantValue;
+	const double Gain = GainScale * IQ8_GAIN / IfSampleScale<T>();
+	int ClippedCount = 0;
+
+	for (i = 0; i < SampleNumber * 2; i++)
+	{
+		QuantValue = (int)(Samples[i] * Gain);
+		if (QuantValue > 127)	// saturate at -128~127
+		{
+			QuantValue = 127;
+			ClippedCount ++;
+		}
+		else if (QuantValue < -128)
+		{
+			QuantValue = -128;
+			ClippedCount ++;
+		}
+		QuantSamples[i] = (unsigned char)(QuantValue & 0xff);
+	}
+
+	return ClippedCount;
+}
+
+template <typename T> static int QuantizeIQ16Scalar(const T Samples[], int SampleNumber, unsigned char QuantSamples[], double GainScale)
+{
+	int i;
+	int QuantValue;
+	const double Gain = GainScale * IQ16_GAIN / IfSampleScale<T>();
+	int ClippedCount = 0;
+
+	for (i = 0; i < SampleNumber * 2; i++)
+	{
+		QuantValue = (int)(Samples[i] * Gain);
+		if (QuantValue > 32767)	// saturate at -32768~32767
+		{
+			QuantValue = 32767;
+			ClippedCount ++;
+		}
+		else if (QuantValue < -32768)
+		{
+			QuantValue = -32768;
+			ClippedCount ++;
+		}
+		QuantSamples[i * 2] = (unsigned char)(QuantValue & 0xff);
+		QuantSamples[i * 2 + 1] = (unsigned char)((QuantValue >> 8) & 0xff);
+	}
+
+	return ClippedCount;
+}
+
+//----------------------------------------------------------------------
+// CQuantizer
+//----------------------------------------------------------------------
+
+CQuantizer::CQuantizer(OutputFormat QuantFormat) : Format(QuantFormat)
+{
+	AgcGain = 1.0;
+	ClippingRate = 0.0;
+	ElapsedMs = 0;
+	WindowSamples = WindowClipped = 0;
+	TotalSamples = TotalClipped = 0;
+}
+
+CQuantizer::~CQuantizer()
+{
+}
+
+int CQuantizer::GetOutputSize(int SampleNumber)
+{
+	switch (Format)
+	{
+	case OutputFormatIQ2: return (SampleNumber + 1) / 2;
+	case OutputFormatIQ4: return SampleNumber;
+	case OutputFormatIQ16: return SampleNumber * 4;
+	default: return SampleNumber * 2;
+	}
+}
+
+// quantize one block with current AGC gain and accumulate clipping statistic
+template <typename T> int CQuantizer::Quantize(const T Samples[], int SampleNumber, unsigned char QuantSamples[])
+{
+	int ClippedCount = QuantizeBlock(Samples, SampleNumber, QuantSamples, AgcGain, Format);
+
+	WindowSamples += SampleNumber * 2;	// I and Q
+	WindowClipped += ClippedCount;
+	TotalSamples += SampleNumber * 2;
+	TotalClipped += ClippedCount;
+	return ClippedCount;
+}
+
+// every AGC_UPDATE_PERIOD ms, reduce gain by 5% if clipping rate too high
+// or increase gain by 2% (up to 1.0) if clipping rate low, statistic restarts after gain changed
+int CQuantizer::UpdateAgc(int BlockMs)
+{
+	if ((ElapsedMs += BlockMs) < AGC_UPDATE_PERIOD)
+		return 0;
+	ElapsedMs -= AGC_UPDATE_PERIOD;
+	if (WindowSamples == 0)
+		return 0;
+	ClippingRate = (double)WindowClipped / WindowSamples;
+	if (ClippingRate > AGC_CLIP_RATE_HIGH)
+	{
+		AgcGain *= AGC_GAIN_DECREASE;
+		WindowSamples = WindowClipped = 0;
+		return -1;
+	}
+	else if (ClippingRate < AGC_CLIP_RATE_LOW && AgcGain < 1.0)
+	{
+		AgcGain *= AGC_GAIN_INCREASE;
+		if (AgcGain > 1.0) AgcGain = 1.0;
+		WindowSamples = WindowClipped = 0;
+		return 1;
+	}
+	return 0;
+}
+
+template <typename T> int CQuantizer::QuantizeBlock(const T Samples[], int SampleNumber, unsigned char QuantSamples[], double GainScale, OutputFormat QuantFormat)
+{
+	switch (QuantFormat)
+	{
+	case OutputFormatIQ2: return QuantizeIQ2(Samples, SampleNumber, QuantSamples, GainScale);
+	case OutputFormatIQ4: return QuantizeIQ4(Samples, SampleNumber, QuantSamples, GainScale);
+	case OutputFormatIQ16: return QuantizeIQ16(Samples, SampleNumber, QuantSamples, GainScale);
+	default: return QuantizeIQ8(Samples, SampleNumber, QuantSamples, GainScale);
+	}
+}
+
+template <typename T> int CQuantizer::QuantizeBlockScalar(const T Samples[], int SampleNumber, unsigned char QuantSamples[], double GainScale, OutputFormat QuantFormat)
+{
+	switch (QuantFormat)
+	{
+	case OutputFormatIQ2: return QuantizeIQ2Scalar(Samples, SampleNumber, QuantSamples, GainScale);
+	case OutputFormatIQ4: return QuantizeIQ4Scalar(Samples, SampleNumber, QuantSamples, GainScale);
+	case OutputFormatIQ16: return QuantizeIQ16Scalar(Samples, SampleNumber, QuantSamples, GainScale);
+	default: return QuantizeIQ8Scalar(Samples, SampleNumber, QuantSamples, GainScale);
+	}
+}
+
+// instantiation of supported sample types
+template int CQuantizer::Quantize<double>(const double Samples[], int SampleNumber, unsigned char QuantSamples[]);
+template int CQuantizer::Quantize<float>(const float Samples[], int SampleNumber, unsigned char QuantSamples[]);
+template int CQuantizer::Quantize<short>(const short Samples[], int SampleNumber, unsigned char QuantSamples[]);
+template int CQuantizer::QuantizeBlock<double>(const double Samples[], int SampleNumber, unsigned char QuantSamples[], double GainScale, OutputFormat QuantFormat);
+template int CQuantizer::QuantizeBlock<float>(const float Samples[], int SampleNumber, unsigned char QuantSamples[], double GainScale, OutputFormat QuantFormat);
+template int CQuantizer::QuantizeBlock<short>(const short Samples[], int SampleNumber, unsigned char QuantSamples[], double GainScale, OutputFormat QuantFormat);
+template int CQuantizer::QuantizeBlockScalar<double>(const double Samples[], int SampleNumber, unsigned char QuantSamples[], double GainScale, OutputFormat QuantFormat);
+template int CQuantizer::QuantizeBlockScalar<float>(const float Samples[], int SampleNumber, unsigned char QuantSamples[], double GainScale, OutputFormat QuantFormat);
+template int CQuantizer::QuantizeBlockScalar<short>(const short Samples[], int SampleNumber, unsigned char QuantSamples[], double GainScale, OutputFormat QuantFormat);
@@ -8,15 +8,50 @@
 #include <math.h>
 #include <stdio.h>
 #include <memory.h>
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
 
 #include "SatIfSignal.h"
 #include "FastMath.h"
 
-CSatIfSignal::CSatIfSignal(int MsSampleNumber, int SatIfFreq, GnssSystem SatSystem, int SatSignalIndex, unsigned char SatId) : SampleNumber(MsSampleNumber), IfFreq(SatIfFreq), System(SatSystem), SignalIndex(SatSignalIndex), Svid((int)SatId)
+#define CODE_PHASE_SCALE 4294967296.	// code phase in unit of 2^-32 chip
+#define CARRIER_PHASE_SCALE 4294967296.	// carrier phase in unit of 2^-32 cycle
+#define SUB_CHIP_WINDOW_STEP (4ULL << 32)	// code step limit so that 8 samples span no more than 32 sub-chips
+
+CSatIfSignal::CSatIfSignal(int MsSampleNumber, int SatIfFreq, GnssSystem SatSystem, int SatSignalIndex, unsigned char SatId, int BlockMs, BlockInterpolation Interpolation) :
+	SampleNumber(MsSampleNumber * BlockMs), MsSamples(MsSampleNumber), BlockLength(BlockMs), InterpolationType(Interpolation)
 {
-	SampleArray = new complex_number[SampleNumber];
-	PrnSequence = new PrnGenerate(System, SignalIndex, Svid);
+	SampleArray = NULL;	// allocated on first call of GetIfSample(), not needed if only AccumulateIfSample() used
+	PrnSequence = NULL;
+	FastMath::InitializeLUT();	// initialize here so that lookup table is ready before parallel generation
+	SetSatellite(SatIfFreq, SatSystem, SatSignalIndex, SatId);
+}
+
+CSatIfSignal::~CSatIfSignal()
+{
+	delete[] SampleArray;
+	SampleArray = NULL;
+	PrnGenerate::ReleasePrnCode(PrnSequence);
+	PrnSequence = NULL;
+}
+
+// PRN code kept if signal and satellite not changed
+void CSatIfSignal::SetSatellite(int SatIfFreq, GnssSystem SatSystem, int SatSignalIndex, unsigned char SatId)
+{
+	if (!PrnSequence || System != SatSystem || SignalIndex != SatSignalIndex || Svid != (int)SatId)
+	{
+		PrnGenerate::ReleasePrnCode(PrnSequence);
+		System = SatSystem;
+		SignalIndex = SatSignalIndex;
+		Svid = (int)SatId;
+		PrnSequence = PrnGenerate::GetPrnCode(System, SignalIndex, Svid);	// read-only code shared by all channels using the same code
+	}
+	IfFreq = SatIfFreq;
 	SatParam = NULL;
+	SegmentNumber = 0;
+	PrevCarrierPhase = 0.0;
+	PrevPhaseValid = 0;
 
 	if (!PrnSequence->Attribute || !PrnSequence->DataPrn)
 		DataLength = PilotLength = 0;
@@ -25,15 +60,7 @@ CSatIfSignal::CSatIfSignal(int MsSampleNumber, int SatIfFreq, GnssSystem SatSyst
 		DataLength = PrnSequence->Attribute->DataPeriod * PrnSequence->Attribute->ChipRate;
 		PilotLength = PrnSequence->Attribute->PilotPeriod * PrnSequence->Attribute->ChipRate;
 	}
-	GlonassHalfCycle = ((IfFreq % 1000) != 0) ? 1 : 0;
-}
-
-CSatIfSignal::~CSatIfSignal()
-{
-	delete[] SampleArray;
-	SampleArray = NULL;
-	delete PrnSequence;
-	PrnSequence = NULL;
+	GlonassHalfCycle = (((long long)IfFreq * BlockLength % 1000) != 0) ? 1 : 0;	// IF of block not integer cycles
 }
 
 void CSatIfSignal::InitState(GNSS_TIME CurTime, PSATELLITE_PARAM pSatParam, NavBit* pNavData)
@@ -42,170 +69,520 @@ void CSatIfSignal::InitState(GNSS_TIME CurTime, PSATELLITE_PARAM pSatParam, NavB
 	if (!SatelliteSignal.SetSignalAttribute(System, SignalIndex, pNavData, Svid))
 		SatelliteSignal.NavData = (NavBit*)0;	// if system/frequency and navigation data not match, set pointer to NULL
 	StartCarrierPhase = GetCarrierPhase(SatParam, SignalIndex);
+	PrevPhaseValid = 0;
 	SignalTime = StartTransmitTime = GetTransmitTime(CurTime, GetTravelTime(SatParam, SignalIndex));
-	SatelliteSignal.GetSatelliteSignal(SignalTime, DataSignal, PilotSignal);
+	SatelliteSignal.GetSatelliteSignal(SignalTime, DataSignal[0], PilotSignal[0]);
 	HalfCycleFlag = 0;
 }
 
+// Generate IF samples of one block into SampleArray
 void CSatIfSignal::GetIfSample(GNSS_TIME CurTime)
 {
-	int i, TransmitMsDiff;
-	double CurPhase, PhaseStep, CurChip, CodeDiff, CodeStep;
-	unsigned int CurIntPhase;
-	int IntPhaseStep;
-	const PrnAttribute* CodeAttribute = PrnSequence->Attribute;
-	complex_number IfSample;
-	double Amp = pow(10, (SatParam->CN0 - 3000) / 1000.) / sqrt(SampleNumber);
+	int i;
 
-	if (!SatParam)
-		return;
-	SignalTime = StartTransmitTime;
-	SatelliteSignal.GetSatelliteSignal(SignalTime, DataSignal, PilotSignal);
-	EndCarrierPhase = GetCarrierPhase(SatParam, SignalIndex);
-	EndTransmitTime = GetTransmitTime(CurTime, GetTravelTime(SatParam, SignalIndex));
+	if (!SampleArray)
+		SampleArray = new complex_number[SampleNumber];
+	for (i = 0; i < SampleNumber; i ++)
+		SampleArray[i] = complex_number(0.0, 0.0);
+	AccumulateIfSample(CurTime, SampleArray);
+}
 
-	// calculate start/end signal phase and phase step (actual local signal phase is negative ADR)
-	PhaseStep = (StartCarrierPhase - EndCarrierPhase) / SampleNumber;
-	PhaseStep += IfFreq / 1000. / SampleNumber;
-	CurPhase = StartCarrierPhase - (int)StartCarrierPhase;
-	CurPhase = 1 - CurPhase;	// carrier is fractional part of negative of travel time, equvalent to 1 minus positive fractional part
-	CurIntPhase = (unsigned int)std::floor(CurPhase * 4294967296.);
-	IntPhaseStep = (int)std::round(PhaseStep * 4294967296.);
-	StartCarrierPhase = EndCarrierPhase;
-	if (GlonassHalfCycle)	// for GLONASS odd number FreqID, nominal IF result in half cycle toggle every 1ms
+// signal amplitude of even/odd sub-chip, L2C has CM in even sub-chip and CL in odd sub-chip
+// BOC subcarrier sign is already expanded in PRN sub-chip sequence
+void CSatIfSignal::GetChipAmplitude(int Segment, double Amp, int HasPilot, double DataReal[2], double DataImag[2], double PilotReal[2], double PilotImag[2])
+{
+	const unsigned int IsL2C = (PrnSequence->Attribute->Attribute) & PRN_ATTRIBUTE_TMD;
+	int i;
+
+	for (i = 0; i < 2; i ++)
 	{
-		CurPhase += HalfCycleFlag ? 0.5 : 0.0;
-		HalfCycleFlag = 1 - HalfCycleFlag;
+		DataReal[i] = DataSignal[Segment].real * Amp;
+		DataImag[i] = DataSignal[Segment].imag * Amp;
+		PilotReal[i] = HasPilot ? PilotSignal[Segment].real * Amp : 0.0;
+		PilotImag[i] = HasPilot ? PilotSignal[Segment].imag * Amp : 0.0;
 	}
-
-	// get PRN count for each sample
-	TransmitMsDiff = EndTransmitTime.MilliSeconds - StartTransmitTime.MilliSeconds;
-	if (TransmitMsDiff < 0)
-		TransmitMsDiff += 86400000;
-	CodeDiff = (TransmitMsDiff + EndTransmitTime.SubMilliSeconds - StartTransmitTime.SubMilliSeconds) * CodeAttribute->ChipRate;
-	CodeStep = CodeDiff / SampleNumber;	// code increase between each sample
-	CurChip = (StartTransmitTime.MilliSeconds % CodeAttribute->PilotPeriod + StartTransmitTime.SubMilliSeconds) * CodeAttribute->ChipRate;
-	StartTransmitTime = EndTransmitTime;
-
-	FastMath::InitializeLUT();
-	for (i = 0; i < SampleNumber; i ++)
+	if (IsL2C)
 	{
-//		SampleArray[i] = GetPrnValue(CurChip, CodeStep) * GetRotateValue(CurPhase, PhaseStep) * Amp;
-		SampleArray[i] = GetPrnValue(CurChip, CodeStep) * GetRotateValue(CurIntPhase, IntPhaseStep) * Amp;
+		DataReal[1] = DataImag[1] = 0.0;
+		PilotReal[0] = PilotImag[0] = 0.0;
 	}
 }
 
-complex_number CSatIfSignal::GetPrnValue(double& CurChip, double CodeStep)
+// Add SampleCount samples to Samples, all within data code period Segment of current block
+// Code phase of all samples must not cross boundary of data code period
+// Each sub-chip is read from bit-packed PRN sequence (BOC sign already expanded) and modulated with
+// data/pilot and TMD amplitude, multiplied by carrier from lookup table with integer phase,
+// AVX-512/AVX2 is used if enabled at compile time
+template <> void CSatIfSignal::GenerateSegment<double>(double *Samples, int SampleCount, unsigned long long CodePhase, unsigned long long CodeStep, unsigned int CarrierPhase, unsigned int CarrierStep, int Segment, double Amp)
 {
-	int ChipCount = (int)CurChip;
-	int DataChip, PilotChip;
-	complex_number PrnValue;
-	int IsBoc = (PrnSequence->Attribute->Attribute) & PRN_ATTRIBUTE_BOC;
-	int IsL2C = (PrnSequence->Attribute->Attribute) & PRN_ATTRIBUTE_TMD;
+	const unsigned long long *DataPrn = PrnSequence->DataPrn;
+	const unsigned long long *PilotPrn = (PrnSequence->PilotPrn && PilotLength > 0) ? PrnSequence->PilotPrn : NULL;
+	const double *SinLut = FastMath::GetSinLut();
+	const double *CosLut = SinLut + FastMath::TRIG_LUT_SIZE / 4;
+	const unsigned int ChipBase = (unsigned int)(CodePhase >> 32);
+	const int DataOffset = (int)(ChipBase % DataLength);
+	const int PilotOffset = PilotPrn ? (int)(ChipBase % PilotLength) : 0;
+	double *Output = Samples;
+	double DataReal[2], DataImag[2], PilotReal[2], PilotImag[2];	// index 0 for even chip and index 1 for odd chip
+	double DataSign, PilotSign, Real, Imag, CosValue, SinValue;
+	unsigned int Chip, Odd;
+	int i;
 
-	if (DataLength == 0)
-		return complex_number(0, 0);
-
-	DataChip = ChipCount % DataLength;
-	if (IsBoc || IsL2C)
-		DataChip >>= 1;
-	PrnValue = PrnSequence->DataPrn[DataChip] ? -DataSignal : DataSignal;
-	if (PrnSequence->PilotPrn && PilotLength > 0)
-	{
-		PilotChip = ChipCount % PilotLength;
-		if (IsBoc || IsL2C)
-			PilotChip >>= 1;
-		if (IsL2C)
+	GetChipAmplitude(Segment, Amp, PilotPrn != NULL, DataReal, DataImag, PilotReal, PilotImag);
+	if (!PilotPrn)
+		PilotPrn = DataPrn;	// pilot amplitude set to 0, use data code to keep index valid
+
+	i = 0;
+#if defined(__AVX512F__)
+	{
+		const int VectorCount = (CodeStep < SUB_CHIP_WINDOW_STEP) ? SampleCount : 0;	// code step too large for sub-chip window, use scalar code
+		const __m512i IndexLow = _mm512_setr_epi64(0, 8, 1, 9, 2, 10, 3, 11);
+		const __m512i IndexHigh = _mm512_setr_epi64(4, 12, 5, 13, 6, 14, 7, 15);
+		const __m256i Base = _mm256_set1_epi32((int)ChipBase);
+		const __m256i One = _mm256_set1_epi32(1), Two = _mm256_set1_epi32(2), Zero = _mm256_setzero_si256();
+		const __m512d DataRealEven = _mm512_set1_pd(DataReal[0]), DataRealOdd = _mm512_set1_pd(DataReal[1]);
+		const __m512d DataImagEven = _mm512_set1_pd(DataImag[0]), DataImagOdd = _mm512_set1_pd(DataImag[1]);
+		const __m512d PilotRealEven = _mm512_set1_pd(PilotReal[0]), PilotRealOdd = _mm512_set1_pd(PilotReal[1]);
+		const __m512d PilotImagEven = _mm512_set1_pd(PilotImag[0]), PilotImagOdd = _mm512_set1_pd(PilotImag[1]);
+		const __m512i CodeStep8 = _mm512_set1_epi64((long long)(CodeStep * 8));
+		const __m256i CarrierStep8 = _mm256_set1_epi32((int)(CarrierStep * 8));
+		__m512i CodeVector = _mm512_setr_epi64((long long)CodePhase, (long long)(CodePhase + CodeStep), (long long)(CodePhase + CodeStep * 2), (long long)(CodePhase + CodeStep * 3),
+			(long long)(CodePhase + CodeStep * 4), (long long)(CodePhase + CodeStep * 5), (long long)(CodePhase + CodeStep * 6), (long long)(CodePhase + CodeStep * 7));	// no 64bit multiply in AVX512F
+		__m256i CarrierVector = _mm256_add_epi32(_mm256_set1_epi32((int)CarrierPhase), _mm256_mullo_epi32(_mm256_set1_epi32((int)CarrierStep), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+		__m256i ChipVector, Relative, Delta, DataBits, PilotBits, LutIndex;
+		int First;
+		__mmask8 OddMask;
+		__m512d DataSignVector, PilotSignVector, RealVector, ImagVector, CosVector, SinVector, OutReal, OutImag;
+
+		for (; i + 8 <= VectorCount; i += 8)
 		{
-			if (ChipCount & 1)	// L2CL slot
-				PrnValue = PrnSequence->PilotPrn[PilotChip] ? -PilotSignal : PilotSignal;
+			// carrier from lookup table
+			LutIndex = _mm256_srli_epi32(CarrierVector, FastMath::TRIG_LUT_SHIFT);
+			CosVector = _mm512_i32gather_pd(LutIndex, CosLut, 8);
+			SinVector = _mm512_i32gather_pd(LutIndex, SinLut, 8);
+			// chip values of data and pilot code
+			ChipVector = _mm512_cvtepi64_epi32(_mm512_srli_epi64(CodeVector, 32));
+			Relative = _mm256_sub_epi32(ChipVector, Base);
+			// all lanes within 32 sub-chips from first lane, shift sub-chip window to bit 0 of each lane
+			First = _mm256_cvtsi256_si32(Relative);
+			Delta = _mm256_sub_epi32(Relative, _mm256_set1_epi32(First));
+			DataBits = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32((int)GetPackedWindow(DataPrn, DataOffset + First)), Delta), One);
+			PilotBits = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32((int)GetPackedWindow(PilotPrn, PilotOffset + First)), Delta), One);
+			// chip 0 -> +1, chip 1 -> -1
+			DataSignVector = _mm512_cvtepi32_pd(_mm256_sub_epi32(_mm256_and_si256(_mm256_cmpeq_epi32(DataBits, Zero), Two), One));
+			PilotSignVector = _mm512_cvtepi32_pd(_mm256_sub_epi32(_mm256_and_si256(_mm256_cmpeq_epi32(PilotBits, Zero), Two), One));
+			OddMask = (__mmask8)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_slli_epi32(ChipVector, 31)));
+			RealVector = _mm512_mul_pd(DataSignVector, _mm512_mask_blend_pd(OddMask, DataRealEven, DataRealOdd));
+			RealVector = _mm512_fmadd_pd(PilotSignVector, _mm512_mask_blend_pd(OddMask, PilotRealEven, PilotRealOdd), RealVector);
+			ImagVector = _mm512_mul_pd(DataSignVector, _mm512_mask_blend_pd(OddMask, DataImagEven, DataImagOdd));
+			ImagVector = _mm512_fmadd_pd(PilotSignVector, _mm512_mask_blend_pd(OddMask, PilotImagEven, PilotImagOdd), ImagVector);
+			// complex multiply and store interleaved real/imag
+			OutReal = _mm512_fmsub_pd(RealVector, CosVector, _mm512_mul_pd(ImagVector, SinVector));
+			OutImag = _mm512_fmadd_pd(RealVector, SinVector, _mm512_mul_pd(ImagVector, CosVector));
+			_mm512_storeu_pd(Output + i * 2, _mm512_add_pd(_mm512_loadu_pd(Output + i * 2), _mm512_permutex2var_pd(OutReal, IndexLow, OutImag)));
+			_mm512_storeu_pd(Output + i * 2 + 8, _mm512_add_pd(_mm512_loadu_pd(Output + i * 2 + 8), _mm512_permutex2var_pd(OutReal, IndexHigh, OutImag)));
+			CodeVector = _mm512_add_epi64(CodeVector, CodeStep8);
+			CarrierVector = _mm256_add_epi32(CarrierVector, CarrierStep8);
+		}
+	}
+#elif defined(__AVX2__)
+	{
+		const int VectorCount = (CodeStep < SUB_CHIP_WINDOW_STEP) ? SampleCount : 0;	// code step too large for sub-chip window, use scalar code
+		const __m256i PackIndex = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+		const __m128i Base = _mm_set1_epi32((int)ChipBase);
+		const __m128i One = _mm_set1_epi32(1), Two = _mm_set1_epi32(2), Zero = _mm_setzero_si128();
+		const __m256d DataRealEven = _mm256_set1_pd(DataReal[0]), DataRealOdd = _mm256_set1_pd(DataReal[1]);
+		const __m256d DataImagEven = _mm256_set1_pd(DataImag[0]), DataImagOdd = _mm256_set1_pd(DataImag[1]);
+		const __m256d PilotRealEven = _mm256_set1_pd(PilotReal[0]), PilotRealOdd = _mm256_set1_pd(PilotReal[1]);
+		const __m256d PilotImagEven = _mm256_set1_pd(PilotImag[0]), PilotImagOdd = _mm256_set1_pd(PilotImag[1]);
+		const __m256i CodeStep4 = _mm256_set1_epi64x((long long)(CodeStep * 4));
+		const __m128i CarrierStep4 = _mm_set1_epi32((int)(CarrierStep * 4));
+		__m256i CodeVector = _mm256_setr_epi64x((long long)CodePhase, (long long)(CodePhase + CodeStep), (long long)(CodePhase + CodeStep * 2), (long long)(CodePhase + CodeStep * 3));
+		__m128i CarrierVector = _mm_setr_epi32((int)CarrierPhase, (int)(CarrierPhase + CarrierStep), (int)(CarrierPhase + CarrierStep * 2), (int)(CarrierPhase + CarrierStep * 3));
+		__m128i ChipVector, Relative, Delta, DataBits, PilotBits, LutIndex;
+		int First;
+		__m256d OddMask, DataSignVector, PilotSignVector, RealVector, ImagVector, CosVector, SinVector, OutReal, OutImag, Low, High;
+
+		for (; i + 4 <= VectorCount; i += 4)
+		{
+			// carrier from lookup table
+			LutIndex = _mm_srli_epi32(CarrierVector, FastMath::TRIG_LUT_SHIFT);
+			CosVector = _mm256_i32gather_pd(CosLut, LutIndex, 8);
+			SinVector = _mm256_i32gather_pd(SinLut, LutIndex, 8);
+			// chip values of data and pilot code
+			ChipVector = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(_mm256_srli_epi64(CodeVector, 32), PackIndex));
+			Relative = _mm_sub_epi32(ChipVector, Base);
+			// all lanes within 32 sub-chips from first lane, shift sub-chip window to bit 0 of each lane
+			First = _mm_cvtsi128_si32(Relative);
+			Delta = _mm_sub_epi32(Relative, _mm_set1_epi32(First));
+			DataBits = _mm_and_si128(_mm_srlv_epi32(_mm_set1_epi32((int)GetPackedWindow(DataPrn, DataOffset + First)), Delta), One);
+			PilotBits = _mm_and_si128(_mm_srlv_epi32(_mm_set1_epi32((int)GetPackedWindow(PilotPrn, PilotOffset + First)), Delta), One);
+			// chip 0 -> +1, chip 1 -> -1
+			DataSignVector = _mm256_cvtepi32_pd(_mm_sub_epi32(_mm_and_si128(_mm_cmpeq_epi32(DataBits, Zero), Two), One));
+			PilotSignVector = _mm256_cvtepi32_pd(_mm_sub_epi32(_mm_and_si128(_mm_cmpeq_epi32(PilotBits, Zero), Two), One));
+			OddMask = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(_mm_srai_epi32(_mm_slli_epi32(ChipVector, 31), 31)));
+			RealVector = _mm256_mul_pd(DataSignVector, _mm256_blendv_pd(DataRealEven, DataRealOdd, OddMask));
+			RealVector = _mm256_add_pd(RealVector, _mm256_mul_pd(PilotSignVector, _mm256_blendv_pd(PilotRealEven, PilotRealOdd, OddMask)));
+			ImagVector = _mm256_mul_pd(DataSignVector, _mm256_blendv_pd(DataImagEven, DataImagOdd, OddMask));
+			ImagVector = _mm256_add_pd(ImagVector, _mm256_mul_pd(PilotSignVector, _mm256_blendv_pd(PilotImagEven, PilotImagOdd, OddMask)));
+			// complex multiply and store interleaved real/imag
+			OutReal = _mm256_sub_pd(_mm256_mul_pd(RealVector, CosVector), _mm256_mul_pd(ImagVector, SinVector));
+			OutImag = _mm256_add_pd(_mm256_mul_pd(RealVector, SinVector), _mm256_mul_pd(ImagVector, CosVector));
+			Low = _mm256_unpacklo_pd(OutReal, OutImag);
+			High = _mm256_unpackhi_pd(OutReal, OutImag);
+			_mm256_storeu_pd(Output + i * 2, _mm256_add_pd(_mm256_loadu_pd(Output + i * 2), _mm256_permute2f128_pd(Low, High, 0x20)));
+			_mm256_storeu_pd(Output + i * 2 + 4, _mm256_add_pd(_mm256_loadu_pd(Output + i * 2 + 4), _mm256_permute2f128_pd(Low, High, 0x31)));
+			CodeVector = _mm256_add_epi64(CodeVector, CodeStep4);
+			CarrierVector = _mm_add_epi32(CarrierVector, CarrierStep4);
 		}
-		else
-			PrnValue += PrnSequence->PilotPrn[PilotChip] ? -PilotSignal : PilotSignal;
 	}
-	if (IsBoc && (ChipCount & 1))	// second half of BOC code
-		PrnValue *= -1;
-	CurChip += CodeStep;
-	// check whether go beyond next code period (pilot code period multiple of data code period, so only check data period)
-	if ((((int)CurChip) % DataLength) < DataChip)
+#endif
+	// scalar version for remaining samples (or all samples if SIMD not enabled)
+	CodePhase += CodeStep * i;
+	CarrierPhase += CarrierStep * i;
+	for (; i < SampleCount; i ++)
 	{
-		SignalTime.MilliSeconds += PrnSequence->Attribute->DataPeriod;
-		SatelliteSignal.GetSatelliteSignal(SignalTime, DataSignal, PilotSignal);
+		Chip = (unsigned int)(CodePhase >> 32);
+		Odd = Chip & 1;
+		DataSign = GetPackedChip(DataPrn, DataOffset + (Chip - ChipBase)) ? -1.0 : 1.0;
+		PilotSign = GetPackedChip(PilotPrn, PilotOffset + (Chip - ChipBase)) ? -1.0 : 1.0;
+		Real = DataSign * DataReal[Odd] + PilotSign * PilotReal[Odd];
+		Imag = DataSign * DataImag[Odd] + PilotSign * PilotImag[Odd];
+		CosValue = CosLut[CarrierPhase >> FastMath::TRIG_LUT_SHIFT];
+		SinValue = SinLut[CarrierPhase >> FastMath::TRIG_LUT_SHIFT];
+		Output[i * 2] += Real * CosValue - Imag * SinValue;
+		Output[i * 2 + 1] += Real * SinValue + Imag * CosValue;
+		CodePhase += CodeStep;
+		CarrierPhase += CarrierStep;
 	}
-	return PrnValue;
 }
 
-complex_number CSatIfSignal::GetRotateValue(double& CurPhase, double PhaseStep)
+// add one sample to float or int16 (rounded with saturation) accumulator
+static inline void AddSample(float *Output, float Real, float Imag)
+{
+	Output[0] += Real;
+	Output[1] += Imag;
+}
+
+static inline short SaturateInt16(long Value)
+{
+	return (short)((Value > 32767) ? 32767 : (Value < -32768) ? -32768 : Value);
+}
+
+static inline void AddSample(short *Output, float Real, float Imag)
+{
+	Output[0] = SaturateInt16((long)Output[0] + SaturateInt16(lrintf(Real)));
+	Output[1] = SaturateInt16((long)Output[1] + SaturateInt16(lrintf(Imag)));
+}
+
+#if defined(__AVX2__)
+// add 8 samples to float or int16 accumulator, Real/Imag hold lanes 0~7
+static inline void AddSampleVector(float *Output, __m256 Real, __m256 Imag)
 {
-//	complex_number Rotate = complex_number(cos(CurPhase * PI2), sin(CurPhase * PI2));
-	complex_number Rotate = FastMath::FastRotate(CurPhase * PI2);	// TODO: further optimize with integer phase
-	CurPhase += PhaseStep;
-	return Rotate;
+	__m256 Low = _mm256_unpacklo_ps(Real, Imag), High = _mm256_unpackhi_ps(Real, Imag);	// samples 0,1,4,5 and 2,3,6,7
+
+	_mm256_storeu_ps(Output, _mm256_add_ps(_mm256_loadu_ps(Output), _mm256_permute2f128_ps(Low, High, 0x20)));
+	_mm256_storeu_ps(Output + 8, _mm256_add_ps(_mm256_loadu_ps(Output + 8), _mm256_permute2f128_ps(Low, High, 0x31)));
 }
 
-complex_number CSatIfSignal::GetRotateValue(unsigned int & CurPhase, int PhaseStep)
+static inline void AddSampleVector(short *Output, __m256 Real, __m256 Imag)
 {
-	complex_number Rotate = FastMath::FastRotate(CurPhase);
-	CurPhase += PhaseStep;
-	return Rotate;
+	// in-lane pack of samples 0,1,4,5 and 2,3,6,7 gives samples 0~7 in order
+	__m256i Packed = _mm256_packs_epi32(_mm256_cvtps_epi32(_mm256_unpacklo_ps(Real, Imag)), _mm256_cvtps_epi32(_mm256_unpackhi_ps(Real, Imag)));
+
+	_mm256_storeu_si256((__m256i *)Output, _mm256_adds_epi16(_mm256_loadu_si256((const __m256i *)Output), Packed));
 }
+#endif
 
-#if 0
-// Cannot correctly deal with data/secondary code modulation yet, just put here for future optimize
-void CSatIfSignal::GenerateSamplesVectorized(int SampleCount, double& CurChip, double CodeStep, double& CurPhase, double PhaseStep, double Amp)
+// Single precision version of GenerateSegment() for float and int16 samples
+// Amp already scaled to sample unit, AVX2 processes 8 samples per iteration
+template <typename T> void CSatIfSignal::GenerateSegment(T *Samples, int SampleCount, unsigned long long CodePhase, unsigned long long CodeStep, unsigned int CarrierPhase, unsigned int CarrierStep, int Segment, double Amp)
 {
-	// MEGA-OPTIMIZED generation for maximum speed
-	if (!PrnSequence || !PrnSequence->DataPrn)
+	const unsigned long long *DataPrn = PrnSequence->DataPrn;
+	const unsigned long long *PilotPrn = (PrnSequence->PilotPrn && PilotLength > 0) ? PrnSequence->PilotPrn : NULL;
+	const float *SinLut = FastMath::GetSinLutFloat();
+	const float *CosLut = SinLut + FastMath::TRIG_LUT_SIZE / 4;
+	const unsigned int ChipBase = (unsigned int)(CodePhase >> 32);
+	const int DataOffset = (int)(ChipBase % DataLength);
+	const int PilotOffset = PilotPrn ? (int)(ChipBase % PilotLength) : 0;
+	double DataAmp[4][2];	// data real, data imag, pilot real, pilot imag for even/odd chip
+	float DataReal[2], DataImag[2], PilotReal[2], PilotImag[2];
+	float DataSign, PilotSign, Real, Imag, CosValue, SinValue;
+	unsigned int Chip, Odd;
+	int i;
+
+	GetChipAmplitude(Segment, Amp, PilotPrn != NULL, DataAmp[0], DataAmp[1], DataAmp[2], DataAmp[3]);
+	for (i = 0; i < 2; i ++)
 	{
-		// Fast zero-padding
-		memset(SampleArray, 0, SampleCount * sizeof(complex_number));
-		CurChip += CodeStep * SampleCount;
-		CurPhase += PhaseStep * SampleCount;
+		DataReal[i] = (float)DataAmp[0][i];
+		DataImag[i] = (float)DataAmp[1][i];
+		PilotReal[i] = (float)DataAmp[2][i];
+		PilotImag[i] = (float)DataAmp[3][i];
+	}
+	if (!PilotPrn)
+		PilotPrn = DataPrn;	// pilot amplitude set to 0, use data code to keep index valid
+
+	i = 0;
+#if defined(__AVX2__)
+	{
+		const int VectorCount = (CodeStep < SUB_CHIP_WINDOW_STEP) ? SampleCount : 0;	// code step too large for sub-chip window, use scalar code
+		const __m256i PackIndex = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+		const __m256i Base = _mm256_set1_epi32((int)ChipBase);
+		const __m256i One = _mm256_set1_epi32(1), Two = _mm256_set1_epi32(2), Zero = _mm256_setzero_si256();
+		const __m256 DataRealEven = _mm256_set1_ps(DataReal[0]), DataRealOdd = _mm256_set1_ps(DataReal[1]);
+		const __m256 DataImagEven = _mm256_set1_ps(DataImag[0]), DataImagOdd = _mm256_set1_ps(DataImag[1]);
+		const __m256 PilotRealEven = _mm256_set1_ps(PilotReal[0]), PilotRealOdd = _mm256_set1_ps(PilotReal[1]);
+		const __m256 PilotImagEven = _mm256_set1_ps(PilotImag[0]), PilotImagOdd = _mm256_set1_ps(PilotImag[1]);
+		const __m256i CodeStep8 = _mm256_set1_epi64x((long long)(CodeStep * 8));
+		const __m256i CarrierStep8 = _mm256_set1_epi32((int)(CarrierStep * 8));
+		__m256i CodeLow = _mm256_setr_epi64x((long long)CodePhase, (long long)(CodePhase + CodeStep), (long long)(CodePhase + CodeStep * 2), (long long)(CodePhase + CodeStep * 3));
+		__m256i CodeHigh = _mm256_add_epi64(CodeLow, _mm256_set1_epi64x((long long)(CodeStep * 4)));
+		__m256i CarrierVector = _mm256_add_epi32(_mm256_set1_epi32((int)CarrierPhase), _mm256_mullo_epi32(_mm256_set1_epi32((int)CarrierStep), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+		__m256i ChipVector, Relative, Delta, DataBits, PilotBits, LutIndex;
+		int First;
+		__m256 OddMask, DataSignVector, PilotSignVector, RealVector, ImagVector, CosVector, SinVector;
+
+		for (; i + 8 <= VectorCount; i += 8)
+		{
+			// carrier from lookup table
+			LutIndex = _mm256_srli_epi32(CarrierVector, FastMath::TRIG_LUT_SHIFT);
+			CosVector = _mm256_i32gather_ps(CosLut, LutIndex, 4);
+			SinVector = _mm256_i32gather_ps(SinLut, LutIndex, 4);
+			// chip values of data and pilot code
+			ChipVector = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm256_castsi256_si128(_mm256_permutevar8x32_epi32(_mm256_srli_epi64(CodeLow, 32), PackIndex))),
+				_mm256_castsi256_si128(_mm256_permutevar8x32_epi32(_mm256_srli_epi64(CodeHigh, 32), PackIndex)), 1);
+			Relative = _mm256_sub_epi32(ChipVector, Base);
+			// all lanes within 32 sub-chips from first lane, shift sub-chip window to bit 0 of each lane
+			First = _mm256_cvtsi256_si32(Relative);
+			Delta = _mm256_sub_epi32(Relative, _mm256_set1_epi32(First));
+			DataBits = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32((int)GetPackedWindow(DataPrn, DataOffset + First)), Delta), One);
+			PilotBits = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32((int)GetPackedWindow(PilotPrn, PilotOffset + First)), Delta), One);
+			// chip 0 -> +1, chip 1 -> -1
+			DataSignVector = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_and_si256(_mm256_cmpeq_epi32(DataBits, Zero), Two), One));
+			PilotSignVector = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_and_si256(_mm256_cmpeq_epi32(PilotBits, Zero), Two), One));
+			OddMask = _mm256_castsi256_ps(_mm256_slli_epi32(ChipVector, 31));
+			RealVector = _mm256_mul_ps(DataSignVector, _mm256_blendv_ps(DataRealEven, DataRealOdd, OddMask));
+			RealVector = _mm256_add_ps(RealVector, _mm256_mul_ps(PilotSignVector, _mm256_blendv_ps(PilotRealEven, PilotRealOdd, OddMask)));
+			ImagVector = _mm256_mul_ps(DataSignVector, _mm256_blendv_ps(DataImagEven, DataImagOdd, OddMask));
+			ImagVector = _mm256_add_ps(ImagVector, _mm256_mul_ps(PilotSignVector, _mm256_blendv_ps(PilotImagEven, PilotImagOdd, OddMask)));
+			// complex multiply and add to output
+			AddSampleVector(Samples + i * 2, _mm256_sub_ps(_mm256_mul_ps(RealVector, CosVector), _mm256_mul_ps(ImagVector, SinVector)),
+				_mm256_add_ps(_mm256_mul_ps(RealVector, SinVector), _mm256_mul_ps(ImagVector, CosVector)));
+			CodeLow = _mm256_add_epi64(CodeLow, CodeStep8);
+			CodeHigh = _mm256_add_epi64(CodeHigh, CodeStep8);
+			CarrierVector = _mm256_add_epi32(CarrierVector, CarrierStep8);
+		}
+	}
+#endif
+	// scalar version for remaining samples (or all samples if SIMD not enabled)
+	CodePhase += CodeStep * i;
+	CarrierPhase += CarrierStep * i;
+	for (; i < SampleCount; i ++)
+	{
+		Chip = (unsigned int)(CodePhase >> 32);
+		Odd = Chip & 1;
+		DataSign = GetPackedChip(DataPrn, DataOffset + (Chip - ChipBase)) ? -1.0f : 1.0f;
+		PilotSign = GetPackedChip(PilotPrn, PilotOffset + (Chip - ChipBase)) ? -1.0f : 1.0f;
+		Real = DataSign * DataReal[Odd] + PilotSign * PilotReal[Odd];
+		Imag = DataSign * DataImag[Odd] + PilotSign * PilotImag[Odd];
+		CosValue = CosLut[CarrierPhase >> FastMath::TRIG_LUT_SHIFT];
+		SinValue = SinLut[CarrierPhase >> FastMath::TRIG_LUT_SHIFT];
+		AddSample(Samples + i * 2, Real * CosValue - Imag * SinValue, Real * SinValue + Imag * CosValue);
+		CodePhase += CodeStep;
+		CarrierPhase += CarrierStep;
+	}
+}
+
+// Generate IF samples of one block and add to Accumulator (SampleNumber samples of type T with real/imag interleaved)
+template <typename T> void CSatIfSignal::AccumulateIfSample(GNSS_TIME CurTime, T *Accumulator)
+{
+	PrepareBlock(CurTime);
+	AccumulateIfRange(Accumulator, 0, SampleNumber);
+}
+
+// Calculate NCO state of the block ending at CurTime and move start state to the end of block
+// The block is split into segments at data code period boundaries, within each segment
+// data bit, NH code and secondary code keep constant so that the sample generation of
+// each segment can be done by block kernel without checking data/pilot bit update
+// Segments are also split at every ms, where code phase is recalculated with full precision step
+// to avoid accumulation of NCO step rounding error, with quadratic interpolation each ms also has its own carrier step
+// Modulation of all segments is determined here, so after this function any range of the
+// block can be generated independently (and in parallel) by AccumulateIfRange()
+void CSatIfSignal::PrepareBlock(GNSS_TIME CurTime)
+{
+	int i, TransmitMsDiff, SegmentLength, PieceLength, PieceStart, Piece, Period, CurPeriod;
+	double CurPhase, PhaseStep, IfPhaseStep, CurChip, CodeDiff, CodeStep, Ratio;
+	double KnotPhase[MAX_BLOCK_LENGTH + 1];
+	unsigned int ChipCount, CarrierPhase, CarrierStep[MAX_BLOCK_LENGTH], CodeStepFrac;
+	unsigned long long CodePhase, PieceCodePhase, CodeStepInt, Boundary;
+	const PrnAttribute* CodeAttribute = PrnSequence->Attribute;
+
+	SegmentNumber = 0;
+	if (!SatParam)
 		return;
+	BlockAmp = pow(10, (SatParam->CN0 - 3000) / 1000.) / sqrt(MsSamples);	// CN0 to amplitude relative to unit noise sigma
+	SignalTime = StartTransmitTime;
+	SatelliteSignal.GetSatelliteSignal(SignalTime, DataSignal[0], PilotSignal[0]);
+	EndCarrierPhase = GetCarrierPhase(SatParam, SignalIndex);
+	EndTransmitTime = GetTransmitTime(CurTime, GetTravelTime(SatParam, SignalIndex));
+
+	// carrier phase (ADR) at every ms, linear or parabola through previous block start, block start and block end
+	PieceLength = MsSamples;
+	KnotPhase[0] = StartCarrierPhase;
+	KnotPhase[BlockLength] = EndCarrierPhase;
+	for (i = 1; i < BlockLength; i ++)
+	{
+		Ratio = (double)i / BlockLength;
+		if (InterpolationType == InterpolationQuadratic && PrevPhaseValid)
+			KnotPhase[i] = StartCarrierPhase + (EndCarrierPhase - PrevCarrierPhase) / 2 * Ratio + (EndCarrierPhase - 2 * StartCarrierPhase + PrevCarrierPhase) / 2 * Ratio * Ratio;
+		else
+			KnotPhase[i] = StartCarrierPhase + (EndCarrierPhase - StartCarrierPhase) * Ratio;
 	}
 
-	// Precomputed constants for speed
-	const int* __restrict DataPrn = PrnSequence->DataPrn;
-	const int* __restrict PilotPrn = PrnSequence->PilotPrn;
-	const double DataReal = DataSignal.real;
-	const double DataImag = DataSignal.imag;
-	const double PilotReal = PilotSignal.real;
-	const double PilotImag = PilotSignal.imag;
-	const double PI2_local = PI2;
+	// calculate start/end signal phase and phase step of each ms (actual local signal phase is negative ADR)
+	IfPhaseStep = IfFreq * BlockLength / 1000. / SampleNumber;
+	for (i = 0; i < BlockLength; i ++)
+	{
+		PhaseStep = (KnotPhase[i] - KnotPhase[i+1]) / PieceLength;
+		PhaseStep += IfPhaseStep;
+		CarrierStep[i] = (unsigned int)(long long)std::round(PhaseStep * CARRIER_PHASE_SCALE);
+	}
+	CurPhase = StartCarrierPhase - (int)StartCarrierPhase;
+	CurPhase = 1 - CurPhase;	// carrier is fractional part of negative of travel time, equvalent to 1 minus positive fractional part
+	CarrierPhase = (unsigned int)(long long)std::floor(CurPhase * CARRIER_PHASE_SCALE);
+	PrevCarrierPhase = StartCarrierPhase;
+	PrevPhaseValid = 1;
+	StartCarrierPhase = EndCarrierPhase;
+	if (GlonassHalfCycle)	// for GLONASS odd number FreqID, nominal IF result in half cycle toggle every odd number of ms
+	{
+		CarrierPhase += HalfCycleFlag ? 0x80000000U : 0;
+		HalfCycleFlag = 1 - HalfCycleFlag;
+	}
 
-	// SUPER-FAST generation without unnecessary checks
-//	#pragma omp simd
-	for (int i = 0; i < SampleCount; i++)
+	if (DataLength == 0)
 	{
-		// PRN index with minimal calculations
-		const int ChipCount = (int)(CurChip + i * CodeStep);
-		const int DataChip = ChipCount % DataLength;
+		StartTransmitTime = EndTransmitTime;
+		return;
+	}
+
+	// get PRN count for each sample
+	TransmitMsDiff = EndTransmitTime.MilliSeconds - StartTransmitTime.MilliSeconds;
+	if (TransmitMsDiff < 0)
+		TransmitMsDiff += 86400000;
+	CodeDiff = (TransmitMsDiff + EndTransmitTime.SubMilliSeconds - StartTransmitTime.SubMilliSeconds) * CodeAttribute->ChipRate;
+	CodeStep = CodeDiff / SampleNumber;	// code increase between each sample
+	CurChip = (StartTransmitTime.MilliSeconds % CodeAttribute->PilotPeriod + StartTransmitTime.SubMilliSeconds) * CodeAttribute->ChipRate;
+	StartTransmitTime = EndTransmitTime;
 
-		// Fast getting of PRN value
-		const double dataSign = DataPrn[DataChip] ? -1.0 : 1.0;
-		double prnReal = DataReal * dataSign;
-		double prnImag = DataImag * dataSign;
+	// code NCO uses 32.32 fixed point so that segment boundaries can be determined exactly
+	// step also kept with another 32bit fraction to calculate code phase at start of each ms
+	BlockCodePhase = (unsigned long long)(CurChip * CODE_PHASE_SCALE);
+	BlockCodeStep = (unsigned long long)(CodeStep * CODE_PHASE_SCALE + 0.5);
+	if (BlockCodeStep == 0)
+		BlockCodeStep = 1;
+	CodeStepInt = (unsigned long long)(CodeStep * CODE_PHASE_SCALE);
+	CodeStepFrac = (unsigned int)((CodeStep * CODE_PHASE_SCALE - CodeStepInt) * CODE_PHASE_SCALE);
 
-		// Pilot PRN only if present
-		if (PilotPrn && PilotLength > 0)
+	Piece = PieceStart = 0;
+	PieceCodePhase = BlockCodePhase;
+	CurPeriod = (int)((unsigned int)(BlockCodePhase >> 32) / DataLength);
+	for (i = 0; ; )
+	{
+		SegmentStart[SegmentNumber] = i;
+		SegmentCodePhase[SegmentNumber] = CodePhase = PieceCodePhase + (i - PieceStart) * BlockCodeStep;
+		SegmentCarrierPhase[SegmentNumber] = CarrierPhase + (unsigned int)(i - PieceStart) * CarrierStep[Piece];
+		SegmentCarrierStep[SegmentNumber] = CarrierStep[Piece];
+		// go beyond next code period (pilot code period multiple of data code period, so only check data period)
+		ChipCount = (unsigned int)(CodePhase >> 32);
+		if ((Period = (int)(ChipCount / DataLength)) != CurPeriod)
+		{
+			SignalTime.MilliSeconds += CodeAttribute->DataPeriod * (Period - CurPeriod);
+			SatelliteSignal.GetSatelliteSignal(SignalTime, DataSignal[SegmentNumber], PilotSignal[SegmentNumber]);
+			CurPeriod = Period;
+		}
+		else if (SegmentNumber > 0)
+		{
+			DataSignal[SegmentNumber] = DataSignal[SegmentNumber - 1];
+			PilotSignal[SegmentNumber] = PilotSignal[SegmentNumber - 1];
+		}
+		SegmentNumber ++;
+		// number of samples before code count reaches next data code period or next ms
+		Boundary = (unsigned long long)(ChipCount - ChipCount % DataLength + DataLength) << 32;
+		SegmentLength = (int)((Boundary - CodePhase + BlockCodeStep - 1) / BlockCodeStep);
+		if (SegmentLength > PieceStart + PieceLength - i)
+			SegmentLength = PieceStart + PieceLength - i;
+		if (SegmentLength > SampleNumber - i || SegmentNumber == MAX_BLOCK_SEGMENT)
+			SegmentLength = SampleNumber - i;
+		if ((i += SegmentLength) >= SampleNumber)
+			break;
+		if (i == PieceStart + PieceLength)	// move to next ms
 		{
-			const int PilotChip = ChipCount % PilotLength;
-			const double pilotSign = PilotPrn[PilotChip] ? -1.0 : 1.0;
-			prnReal += PilotReal * pilotSign;
-			prnImag += PilotImag * pilotSign;
+			CarrierPhase += (unsigned int)PieceLength * CarrierStep[Piece ++];
+			PieceStart = i;
+			PieceCodePhase = BlockCodePhase + i * CodeStepInt + (((unsigned long long)i * CodeStepFrac) >> 32);
 		}
+	}
+	SegmentStart[SegmentNumber] = SampleNumber;
+}
 
-		// Fast phase rotation
-		const double phase = (CurPhase + i * PhaseStep) * PI2_local;
-		const complex_number rotation = FastMath::FastRotate(phase);
+// Add samples StartSample ~ StartSample+Count-1 of the block prepared by PrepareBlock() to Accumulator
+// (address of the first sample of the block), NCO state of the first sample is calculated from block start
+// Channel state is not changed, so different ranges of the same block can be generated by different threads
+template <typename T> void CSatIfSignal::AccumulateIfRange(T *Accumulator, int StartSample, int Count)
+{
+	const double Amp = BlockAmp * IfSampleScale<T>();
+	int Segment, EndSample = StartSample + Count, SegmentLength;
 
-		// Final signal with inline multiplication
-		SampleArray[i].real = (prnReal * rotation.real - prnImag * rotation.imag) * Amp;
-		SampleArray[i].imag = (prnReal * rotation.imag + prnImag * rotation.real) * Amp;
+	for (Segment = 0; Segment < SegmentNumber && StartSample < EndSample; Segment ++)
+	{
+		if (SegmentStart[Segment + 1] <= StartSample)
+			continue;
+		SegmentLength = ((SegmentStart[Segment + 1] < EndSample) ? SegmentStart[Segment + 1] : EndSample) - StartSample;
+		GenerateSegment(Accumulator + StartSample * 2, SegmentLength, SegmentCodePhase[Segment] + (StartSample - SegmentStart[Segment]) * BlockCodeStep, BlockCodeStep,
+			SegmentCarrierPhase[Segment] + (unsigned int)(StartSample - SegmentStart[Segment]) * SegmentCarrierStep[Segment], SegmentCarrierStep[Segment], Segment, Amp);
+		StartSample += SegmentLength;
 	}
+}
+
+// Generate one block of samples as T and as double, return power of difference in unit of noise sigma
+// Channel state is restored so that it can be called before normal signal generation
+template <typename T> double CSatIfSignal::GetSampleTypeError(GNSS_TIME CurTime, double &SignalPower)
+{
+	const double Scale = IfSampleScale<T>();
+	double *Reference = new double[SampleNumber * 2];
+	T *Samples = new T[SampleNumber * 2];
+	double StartPhase = StartCarrierPhase, PrevPhase = PrevCarrierPhase, ErrorPower = 0.0, Diff;
+	GNSS_TIME StartTime = StartTransmitTime;
+	int StartFlag = HalfCycleFlag, PrevValid = PrevPhaseValid, i;
+	CSatelliteSignal StartSignal = SatelliteSignal;
 
-	// Update state
-	CurChip += CodeStep * SampleCount;
-	CurPhase += PhaseStep * SampleCount;
+	memset(Reference, 0, sizeof(double) * SampleNumber * 2);
+	memset(Samples, 0, sizeof(T) * SampleNumber * 2);
+	AccumulateIfSample(CurTime, Reference);
+	StartCarrierPhase = StartPhase; StartTransmitTime = StartTime; HalfCycleFlag = StartFlag; SatelliteSignal = StartSignal;
+	PrevCarrierPhase = PrevPhase; PrevPhaseValid = PrevValid;
+	AccumulateIfSample(CurTime, Samples);
+	StartCarrierPhase = StartPhase; StartTransmitTime = StartTime; HalfCycleFlag = StartFlag; SatelliteSignal = StartSignal;
+	PrevCarrierPhase = PrevPhase; PrevPhaseValid = PrevValid;
+	SignalPower = 0.0;
+	for (i = 0; i < SampleNumber * 2; i ++)
+	{
+		Diff = Samples[i] / Scale - Reference[i];
+		ErrorPower += Diff * Diff;
+		SignalPower += Reference[i] * Reference[i];
+	}
+	delete[] Reference;
+	delete[] Samples;
+	return ErrorPower;
 }
-#endif
+
+// instantiation of supported sample types
+template void CSatIfSignal::AccumulateIfSample<double>(GNSS_TIME CurTime, double *Accumulator);
+template void CSatIfSignal::AccumulateIfSample<float>(GNSS_TIME CurTime, float *Accumulator);
+template void CSatIfSignal::AccumulateIfSample<short>(GNSS_TIME CurTime, short *Accumulator);
+template void CSatIfSignal::AccumulateIfRange<double>(double *Accumulator, int StartSample, int Count);
+template void CSatIfSignal::AccumulateIfRange<float>(float *Accumulator, int StartSample, int Count);
+template void CSatIfSignal::AccumulateIfRange<short>(short *Accumulator, int StartSample, int Count);
+template double CSatIfSignal::GetSampleTypeError<double>(GNSS_TIME CurTime, double &SignalPower);
+template double CSatIfSignal::GetSampleTypeError<float>(GNSS_TIME CurTime, double &SignalPower);
+template double CSatIfSignal::GetSampleTypeError<short>(GNSS_TIME CurTime, double &SignalPower);
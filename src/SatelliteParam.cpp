@@ -13,7 +13,11 @@
 #include "GnssTime.h"
 #include "XmlInterpreter.h"
 
-static void GetSatPosVel(GnssSystem system, double SatelliteTime, PGPS_EPHEMERIS Eph, PSATELLITE_PARAM SatelliteParam, PKINEMATIC_INFO pPosVel);
+static double GetSatelliteTime(GNSS_TIME time, GnssSystem system);
+static void SetSatelliteParam(KINEMATIC_INFO PositionEcef, LLA_POSITION PositionLla, GnssSystem system, PGPS_EPHEMERIS Eph, PIONO_PARAM IonoParam, double SatelliteTime, KINEMATIC_INFO &SatPosition, PSATELLITE_PARAM SatelliteParam);
+static void SetGroupDelay(GnssSystem system, PGPS_EPHEMERIS Eph, PSATELLITE_PARAM SatelliteParam);
+static BOOL SatelliteMaskOut(OUTPUT_PARAM &OutputParam, GnssSystem system, int Index);
+static double ElevationRate(PKINEMATIC_INFO Receiver, PLLA_POSITION ReceiverLla, PKINEMATIC_INFO Satellite, double Elevation);
 
 int GetVisibleSatellite(KINEMATIC_INFO Position, GNSS_TIME time, OUTPUT_PARAM OutputParam, GnssSystem system, PGPS_EPHEMERIS Eph[], int Number, PGPS_EPHEMERIS EphVisible[])
 {
@@ -65,7 +69,7 @@ int GetGlonassVisibleSatellite(KINEMATIC_INFO Position, GLONASS_TIME time, OUTPU
 	{
 		if (Eph[i] == NULL || Eph[i]->flag == 0)
 			continue;
-		if (OutputParam.GlonassMaskOut & (1 << (i-1)))
+		if (OutputParam.GlonassMaskOut & (1 << i))
 			continue;
 		if (!GlonassSatPosSpeedEph(time.MilliSeconds / 1000., Eph[i], &SatPosition, NULL))
 			continue;
@@ -78,46 +82,93 @@ int GetGlonassVisibleSatellite(KINEMATIC_INFO Position, GLONASS_TIME time, OUTPU
 	return SatNumber;
 }
 
-#define USE_POSITION_PREDICTION 0
+// reset visibility state so that all satellites are evaluated on next UpdateVisibleSatellite()
+void InitSatVisibility(SAT_VISIBILITY Visibility[], int Number)
+{
+	int i;
+
+	for (i = 0; i < Number; i ++)
+	{
+		Visibility[i].CheckTime = 0;
+		Visibility[i].Visible = FALSE;
+	}
+}
 
-void GetSatelliteParam(KINEMATIC_INFO PositionEcef, LLA_POSITION PositionLla, GNSS_TIME time, GnssSystem system, PGPS_EPHEMERIS Eph, PIONO_PARAM IonoParam, PSATELLITE_PARAM SatelliteParam)
+// same result as GetVisibleSatellite() (GetGlonassVisibleSatellite() for GLONASS with Eph[] cast from PGLONASS_EPHEMERIS)
+// but only satellites with CheckTime reached are evaluated, Position should have velocity to predict elevation rate
+int UpdateVisibleSatellite(KINEMATIC_INFO Position, GNSS_TIME time, OUTPUT_PARAM OutputParam, GnssSystem system, PGPS_EPHEMERIS Eph[], int Number, SAT_VISIBILITY Visibility[], PGPS_EPHEMERIS EphVisible[])
 {
+	int i;
+	int SatNumber = 0;
+	long long CurrentTime = time.Week * 604800000LL + time.MilliSeconds, Interval;
+	double SatelliteTime = GetSatelliteTime(time, system), CrossTime;
+	LLA_POSITION PositionLla = EcefToLla(Position);
 	KINEMATIC_INFO SatPosition;
-	double Distance, TravelTime, SatelliteTime = (time.MilliSeconds + time.SubMilliSeconds) / 1000.0;
-	double TimeDiff;
-	double Elevation, Azimuth;
-	double LosVector[3];
-	PGLONASS_EPHEMERIS GloEph = (PGLONASS_EPHEMERIS)Eph;
-	int Seconds, LeapSecond;
+	PSAT_VISIBILITY State;
+	double Azimuth;
+	bool Valid;
 
-	SatelliteParam->system= system;
-	if (system == BdsSystem)	// subtract leap second difference
-		time.MilliSeconds -= 14000;
-	else if (system == GlonassSystem)	// subtract leap second, add 3 hours
+	for (i = 0; i < Number; i ++)
 	{
-		Seconds = (unsigned int)(time.Week * 604800 + time.MilliSeconds / 1000);
-		GetLeapSecond(Seconds, LeapSecond);
-		time.MilliSeconds = (time.MilliSeconds + 10800000 - LeapSecond * 1000) % 86400000;
+		State = &Visibility[i];
+		if (State->CheckTime <= CurrentTime)
+		{
+			if (system == GlonassSystem)
+				Valid = Eph[i] && ((PGLONASS_EPHEMERIS)Eph[i])->flag && GlonassSatPosSpeedEph(SatelliteTime, (PGLONASS_EPHEMERIS)Eph[i], &SatPosition, NULL);
+			else
+				Valid = Eph[i] && Eph[i]->valid && Eph[i]->health == 0 && GpsSatPosSpeedEph(system, SatelliteTime, Eph[i], &SatPosition, NULL);
+			if (!Valid || SatelliteMaskOut(OutputParam, system, i))
+			{
+				State->Visible = FALSE;
+				State->CheckTime = VISIBILITY_NEVER;
+				continue;
+			}
+			SatElAz(&Position, &SatPosition, &State->Elevation, &Azimuth);
+			State->ElevationRate = ElevationRate(&Position, &PositionLla, &SatPosition, State->Elevation);
+			State->Visible = (State->Elevation >= OutputParam.ElevationMask) ? TRUE : FALSE;
+			// time to cross elevation mask with current rate, next check at half of it
+			CrossTime = (State->ElevationRate != 0.0) ? (OutputParam.ElevationMask - State->Elevation) / State->ElevationRate : -1.0;
+			if (CrossTime > 0 && CrossTime < VISIBILITY_MAX_INTERVAL / 1000.)
+			{
+				Interval = (long long)(CrossTime * 500);
+				if (Interval < VISIBILITY_MIN_INTERVAL)
+					Interval = VISIBILITY_MIN_INTERVAL;
+			}
+			else
+				Interval = VISIBILITY_MAX_INTERVAL;
+			State->CheckTime = CurrentTime + Interval;
+		}
+		if (State->Visible)
+			EphVisible[SatNumber ++] = Eph[i];
 	}
-	SatelliteTime = (time.MilliSeconds + time.SubMilliSeconds) / 1000.0;
+
+	return SatNumber;
+}
+
+// GLONASS satellite position evaluated from integrator states in GloOrbit if not NULL
+void GetSatelliteParam(KINEMATIC_INFO PositionEcef, LLA_POSITION PositionLla, GNSS_TIME time, GnssSystem system, PGPS_EPHEMERIS Eph, PIONO_PARAM IonoParam, PSATELLITE_PARAM SatelliteParam, PGLONASS_ORBIT GloOrbit)
+{
+	KINEMATIC_INFO SatPosition;
+	double TravelTime, SatelliteTime = GetSatelliteTime(time, system);
+	PGLONASS_EPHEMERIS GloEph = (PGLONASS_EPHEMERIS)Eph;
+
+	SatelliteParam->system= system;
 
 	// first estimate the travel time, ignore tgd, ionosphere and troposphere delay
 	if (system == GlonassSystem)
 	{
 		SatelliteParam->svid = GloEph->n;
 		SatelliteParam->FreqID = GloEph->freq;
-		GlonassSatPosSpeedEph(SatelliteTime, GloEph, &SatPosition, NULL);
+		if (GloOrbit)
+			GlonassSatPosSpeedOrbit(SatelliteTime, GloEph, GloOrbit, &SatPosition, NULL);
+		else
+			GlonassSatPosSpeedEph(SatelliteTime, GloEph, &SatPosition, NULL);
 	}
 	else
 	{
 		SatelliteParam->svid = Eph->svid;
 		SatelliteParam->FreqID = 0;
-#if USE_POSITION_PREDICTION
-		GetSatPosVel(system, SatelliteTime, Eph, SatelliteParam, &SatPosition);
-#else
 		GpsSatPosSpeedEph(system, SatelliteTime, Eph, &SatPosition, NULL);
-	//	SatelliteParam->PosVel = SatPosition;
-#endif
 	}
 	TravelTime = GeometryDistance(&PositionEcef, &SatPosition, SatelliteParam->LosVector) / LIGHT_SPEED;
 	SatPosition.x -= TravelTime * SatPosition.vx; SatPosition.y -= TravelTime * SatPosition.vy; SatPosition.z -= TravelTime * SatPosition.vz;
@@ -126,23 +177,122 @@ void GetSatelliteParam(KINEMATIC_INFO PositionEcef, LLA_POSITION PositionLla, GN
 
 	// calculate accurate transmit time
 	// travel_time = (d + dtrop)/c + tgd - dts - trel + diono
-	if (system == GlonassSystem)
+	if (system == GlonassSystem && GloOrbit)
+		GlonassSatPosSpeedOrbit(SatelliteTime, GloEph, GloOrbit, &SatPosition, NULL);
+	else if (system == GlonassSystem)
 		GlonassSatPosSpeedEph(SatelliteTime, GloEph, &SatPosition, NULL);
 	else
-	{
-#if USE_POSITION_PREDICTION
-		TimeDiff = SatelliteTime - SatelliteParam->PosTimeTag;
-		SatPosition.x = SatelliteParam->PosVel.x + (SatelliteParam->PosVel.vx + SatelliteParam->Acc[0] * TimeDiff * 0.5) * TimeDiff;
-		SatPosition.y = SatelliteParam->PosVel.y + (SatelliteParam->PosVel.vy + SatelliteParam->Acc[1] * TimeDiff * 0.5) * TimeDiff;
-		SatPosition.z = SatelliteParam->PosVel.z + (SatelliteParam->PosVel.vz + SatelliteParam->Acc[2] * TimeDiff * 0.5) * TimeDiff;
-		SatPosition.vx = SatelliteParam->PosVel.vx + SatelliteParam->Acc[0] * TimeDiff;
-		SatPosition.vy = SatelliteParam->PosVel.vy + SatelliteParam->Acc[1] * TimeDiff;
-		SatPosition.vz = SatelliteParam->PosVel.vz + SatelliteParam->Acc[2] * TimeDiff;
-#else
-		TimeDiff = 0;
 		GpsSatPosSpeedEph(system, SatelliteTime, Eph, &SatPosition, NULL);
-#endif
+	SetSatelliteParam(PositionEcef, PositionLla, system, Eph, IonoParam, SatelliteTime, SatPosition, SatelliteParam);
+}
+
+// GetSatelliteParam() for Number GPS/BDS/Galileo satellites in Eph[] with satellite positions calculated in batch
+// result of satellite with svid placed in SatelliteParam[svid-1]
+void GetSatelliteParamBatch(KINEMATIC_INFO PositionEcef, LLA_POSITION PositionLla, GNSS_TIME time, GnssSystem system, PGPS_EPHEMERIS Eph[], int Number, PIONO_PARAM IonoParam, SATELLITE_PARAM SatelliteParam[])
+{
+	int i, Start;
+	EPHEMERIS_BATCH Batch;
+	KINEMATIC_INFO SatPosition[EPH_BATCH_SIZE];
+	double SatelliteTime[EPH_BATCH_SIZE], TravelTime, CurrentTime = GetSatelliteTime(time, system);
+	PSATELLITE_PARAM Param;
+
+	for (Start = 0; Start < Number; Start += EPH_BATCH_SIZE)
+	{
+		SetEphemerisBatch(system, Eph + Start, Number - Start, &Batch);
+		// first estimate the travel time, ignore tgd, ionosphere and troposphere delay
+		for (i = 0; i < Batch.Number; i ++)
+			SatelliteTime[i] = CurrentTime;
+		GpsSatPosSpeedBatch(&Batch, SatelliteTime, SatPosition);
+		for (i = 0; i < Batch.Number; i ++)
+		{
+			Param = &SatelliteParam[Batch.Eph[i]->svid - 1];
+			Param->system = system;
+			Param->svid = Batch.Eph[i]->svid;
+			Param->FreqID = 0;
+			TravelTime = GeometryDistance(&PositionEcef, &SatPosition[i], Param->LosVector) / LIGHT_SPEED;
+			SatPosition[i].x -= TravelTime * SatPosition[i].vx; SatPosition[i].y -= TravelTime * SatPosition[i].vy; SatPosition[i].z -= TravelTime * SatPosition[i].vz;
+			TravelTime = GeometryDistance(&PositionEcef, &SatPosition[i], Param->LosVector) / LIGHT_SPEED;
+			SatelliteTime[i] -= TravelTime;
+		}
+		// calculate accurate transmit time
+		GpsSatPosSpeedBatch(&Batch, SatelliteTime, SatPosition);
+		for (i = 0; i < Batch.Number; i ++)
+			SetSatelliteParam(PositionEcef, PositionLla, system, Batch.Eph[i], IonoParam, SatelliteTime[i], SatPosition[i], &SatelliteParam[Batch.Eph[i]->svid - 1]);
+	}
+}
+
+// GetSatelliteParam() for Number GPS/BDS/Galileo satellites in Eph[] with satellite position and clock from polynomials
+// fitted over Window seconds, result and interpolation state of satellite with svid placed in SatelliteParam[svid-1] and Interp[svid-1]
+// satellite fails accuracy check of fitting falls back to exact evaluation until end of window
+void GetSatelliteParamInterp(KINEMATIC_INFO PositionEcef, LLA_POSITION PositionLla, GNSS_TIME time, GnssSystem system, PGPS_EPHEMERIS Eph[], int Number, PIONO_PARAM IonoParam, int Window, ORBIT_INTERP Interp[], SATELLITE_PARAM SatelliteParam[])
+{
+	int i;
+	KINEMATIC_INFO SatPosition;
+	double CurrentTime = GetSatelliteTime(time, system), SatelliteTime;
+	double TravelTime, ClockCorrection, Distance, Elevation, Azimuth, TropoDelay;
+	double LosVector[3];
+	PORBIT_INTERP OrbitInterp;
+	PSATELLITE_PARAM Param;
+
+	for (i = 0; i < Number; i ++)
+	{
+		OrbitInterp = &Interp[Eph[i]->svid - 1];
+		Param = &SatelliteParam[Eph[i]->svid - 1];
+		if (!OrbitInterpInWindow(OrbitInterp, Eph[i], CurrentTime) || !OrbitInterpInWindow(OrbitInterp, Eph[i], CurrentTime - ORBIT_INTERP_MARGIN / 2))
+			FitOrbitInterp(system, Eph[i], CurrentTime - ORBIT_INTERP_MARGIN, Window, OrbitInterp);
+		if (!OrbitInterp->Valid)
+		{
+			GetSatelliteParam(PositionEcef, PositionLla, time, system, Eph[i], IonoParam, Param);
+			continue;
+		}
+		Param->system = system;
+		Param->svid = Eph[i]->svid;
+		Param->FreqID = 0;
+
+		// first estimate the travel time, ignore tgd, ionosphere and troposphere delay
+		OrbitInterpPosVel(OrbitInterp, CurrentTime, &SatPosition, ClockCorrection);
+		TravelTime = GeometryDistance(&PositionEcef, &SatPosition, Param->LosVector) / LIGHT_SPEED;
+		SatPosition.x -= TravelTime * SatPosition.vx; SatPosition.y -= TravelTime * SatPosition.vy; SatPosition.z -= TravelTime * SatPosition.vz;
+		TravelTime = GeometryDistance(&PositionEcef, &SatPosition, Param->LosVector) / LIGHT_SPEED;
+		SatelliteTime = CurrentTime - TravelTime;
+
+		// calculate accurate transmit time
+		OrbitInterpPosVel(OrbitInterp, SatelliteTime, &SatPosition, ClockCorrection);
+		Distance = GeometryDistance(&PositionEcef, &SatPosition, LosVector);
+		SatElAz(&PositionLla, LosVector, &Elevation, &Azimuth);
+		OrbitInterpAtmosDelay(OrbitInterp, CurrentTime, IonoParam, SatelliteTime, PositionLla, Elevation, Azimuth, Param->IonoDelay, TropoDelay);
+		Param->TravelTime = (Distance + TropoDelay) / LIGHT_SPEED - ClockCorrection;
+		SetGroupDelay(system, Eph[i], Param);
+		Param->Elevation = Elevation;
+		Param->Azimuth = Azimuth;
+		Param->RelativeSpeed = SatRelativeSpeed(&PositionEcef, &SatPosition) - LIGHT_SPEED * Eph[i]->af1;
 	}
+}
+
+// satellite time in second of week (of day for GLONASS) in system time
+double GetSatelliteTime(GNSS_TIME time, GnssSystem system)
+{
+	int Seconds, LeapSecond;
+
+	if (system == BdsSystem)	// subtract leap second difference
+		time.MilliSeconds -= 14000;
+	else if (system == GlonassSystem)	// subtract leap second, add 3 hours
+	{
+		Seconds = (unsigned int)(time.Week * 604800 + time.MilliSeconds / 1000);
+		GetLeapSecond(Seconds, LeapSecond);
+		time.MilliSeconds = (time.MilliSeconds + 10800000 - LeapSecond * 1000) % 86400000;
+	}
+	return (time.MilliSeconds + time.SubMilliSeconds) / 1000.0;
+}
+
+// calculate travel time, delays and angles with satellite position at transmit time SatelliteTime
+void SetSatelliteParam(KINEMATIC_INFO PositionEcef, LLA_POSITION PositionLla, GnssSystem system, PGPS_EPHEMERIS Eph, PIONO_PARAM IonoParam, double SatelliteTime, KINEMATIC_INFO &SatPosition, PSATELLITE_PARAM SatelliteParam)
+{
+	double Distance, TravelTime;
+	double Elevation, Azimuth;
+	double LosVector[3];
+	PGLONASS_EPHEMERIS GloEph = (PGLONASS_EPHEMERIS)Eph;
+
 	Distance = GeometryDistance(&PositionEcef, &SatPosition, LosVector);
 	SatElAz(&PositionLla, LosVector, &Elevation, &Azimuth);
 	SatelliteParam->IonoDelay = GpsIonoDelay(IonoParam, SatelliteTime, PositionLla.lat, PositionLla.lon, Elevation, Azimuth);
@@ -152,38 +302,43 @@ void GetSatelliteParam(KINEMATIC_INFO PositionEcef, LLA_POSITION PositionLla, GN
 	else
 	{
 		TravelTime = Distance / LIGHT_SPEED - GpsClockCorrection(Eph, SatelliteTime);
-		TravelTime -= WGS_F_GTR * Eph->ecc * Eph->sqrtA * sin(Eph->Ek + TimeDiff * Eph->Ek_dot);		// relativity correction
-		// assign GroupDelay[]
-		switch (system)
-		{
-		case GpsSystem:
-			SatelliteParam->GroupDelay[SIGNAL_INDEX_L1CA] = Eph->tgd;	// L1C/A
-			SatelliteParam->GroupDelay[SIGNAL_INDEX_L1C] = Eph->tgd_ext[1];	// L1C
-			SatelliteParam->GroupDelay[SIGNAL_INDEX_L2C] = Eph->tgd2;	// L2C
-			SatelliteParam->GroupDelay[SIGNAL_INDEX_L5] = Eph->tgd_ext[3];	// L5
-			break;
-		case BdsSystem:
-			SatelliteParam->GroupDelay[SIGNAL_INDEX_B1C] = Eph->tgd_ext[1];	// B1C
-			SatelliteParam->GroupDelay[SIGNAL_INDEX_B1I] = Eph->tgd;	// B1I
-			SatelliteParam->GroupDelay[SIGNAL_INDEX_B2I] = Eph->tgd2;	// B2I
-			SatelliteParam->GroupDelay[SIGNAL_INDEX_B3I] = 0;	// B3I
-			SatelliteParam->GroupDelay[SIGNAL_INDEX_B2a] = Eph->tgd_ext[3];	// B2a
-			SatelliteParam->GroupDelay[SIGNAL_INDEX_B2b] = Eph->tgd_ext[4];	// B2b
-			SatelliteParam->GroupDelay[SIGNAL_INDEX_B2ab] = (Eph->tgd_ext[3] + Eph->tgd_ext[4]) / 2;	// B2a+B2b
-			break;
-		case GalileoSystem:
-			SatelliteParam->GroupDelay[SIGNAL_INDEX_E1] = Eph->tgd;	// E1
-			SatelliteParam->GroupDelay[SIGNAL_INDEX_E5a] = Eph->tgd_ext[2];	// E5a
-			SatelliteParam->GroupDelay[SIGNAL_INDEX_E5b] = Eph->tgd_ext[4];	// E5b
-			SatelliteParam->GroupDelay[SIGNAL_INDEX_E5] = (Eph->tgd_ext[2] + Eph->tgd_ext[4]) / 2;	// E5
-			SatelliteParam->GroupDelay[SIGNAL_INDEX_E6] = Eph->tgd_ext[4];	// E6
-			break;
-		}
+		TravelTime -= WGS_F_GTR * Eph->ecc * Eph->sqrtA * sin(Eph->Ek);		// relativity correction
+		SetGroupDelay(system, Eph, SatelliteParam);
 	}
 	SatelliteParam->TravelTime = TravelTime;
 	SatelliteParam->Elevation = Elevation;
 	SatelliteParam->Azimuth = Azimuth;
-	SatelliteParam->RelativeSpeed = SatRelativeSpeed(&PositionEcef, &SatPosition) - LIGHT_SPEED * Eph->af1;
+	SatelliteParam->RelativeSpeed = SatRelativeSpeed(&PositionEcef, &SatPosition) - LIGHT_SPEED * ((system == GlonassSystem) ? GloEph->gamma : Eph->af1);
+}
+
+// assign GroupDelay[] of GPS/BDS/Galileo satellite
+void SetGroupDelay(GnssSystem system, PGPS_EPHEMERIS Eph, PSATELLITE_PARAM SatelliteParam)
+{
+	switch (system)
+	{
+	case GpsSystem:
+		SatelliteParam->GroupDelay[SIGNAL_INDEX_L1CA] = Eph->tgd;	// L1C/A
+		SatelliteParam->GroupDelay[SIGNAL_INDEX_L1C] = Eph->tgd_ext[1];	// L1C
+		SatelliteParam->GroupDelay[SIGNAL_INDEX_L2C] = Eph->tgd2;	// L2C
+		SatelliteParam->GroupDelay[SIGNAL_INDEX_L5] = Eph->tgd_ext[3];	// L5
+		break;
+	case BdsSystem:
+		SatelliteParam->GroupDelay[SIGNAL_INDEX_B1C] = Eph->tgd_ext[1];	// B1C
+		SatelliteParam->GroupDelay[SIGNAL_INDEX_B1I] = Eph->tgd;	// B1I
+		SatelliteParam->GroupDelay[SIGNAL_INDEX_B2I] = Eph->tgd2;	// B2I
+		SatelliteParam->GroupDelay[SIGNAL_INDEX_B3I] = 0;	// B3I
+		SatelliteParam->GroupDelay[SIGNAL_INDEX_B2a] = Eph->tgd_ext[3];	// B2a
+		SatelliteParam->GroupDelay[SIGNAL_INDEX_B2b] = Eph->tgd_ext[4];	// B2b
+		SatelliteParam->GroupDelay[SIGNAL_INDEX_B2ab] = (Eph->tgd_ext[3] + Eph->tgd_ext[4]) / 2;	// B2a+B2b
+		break;
+	case GalileoSystem:
+		SatelliteParam->GroupDelay[SIGNAL_INDEX_E1] = Eph->tgd;	// E1
+		SatelliteParam->GroupDelay[SIGNAL_INDEX_E5a] = Eph->tgd_ext[2];	// E5a
+		SatelliteParam->GroupDelay[SIGNAL_INDEX_E5b] = Eph->tgd_ext[4];	// E5b
+		SatelliteParam->GroupDelay[SIGNAL_INDEX_E5] = (Eph->tgd_ext[2] + Eph->tgd_ext[4]) / 2;	// E5
+		SatelliteParam->GroupDelay[SIGNAL_INDEX_E6] = Eph->tgd_ext[4];	// E6
+		break;
+	}
 }
 
 void GetSatelliteCN0(int PowerListCount, SIGNAL_POWER PowerList[], double DefaultCN0, enum ElevationAdjust Adjust, PSATELLITE_PARAM SatelliteParam)
@@ -335,42 +490,31 @@ GNSS_TIME GetTransmitTime(GNSS_TIME ReceiverTime, double TravelTime)
 	return TransmitTime;
 }
 
-void GetSatPosVel(GnssSystem system, double SatelliteTime, PGPS_EPHEMERIS Eph, PSATELLITE_PARAM SatelliteParam, PKINEMATIC_INFO pPosVel)
+// whether satellite with Eph[Index] is excluded in configuration
+BOOL SatelliteMaskOut(OUTPUT_PARAM &OutputParam, GnssSystem system, int Index)
 {
-	double TimeDiff = SatelliteTime - SatelliteParam->PosTimeTag;
-	int TimeTag;
-
-	// compensate week round
-	if (TimeDiff > 600000)
-		TimeDiff -= 604800;
-	else if (TimeDiff < -600000)
-		TimeDiff += 604800;
-
-	if (SatelliteParam->PosTimeTag >= 0 && fabs(TimeDiff) <= 0.5)	// do prediction
+	switch (system)
 	{
-		pPosVel->x = SatelliteParam->PosVel.x + (SatelliteParam->PosVel.vx + SatelliteParam->Acc[0] * TimeDiff * 0.5) * TimeDiff;
-		pPosVel->y = SatelliteParam->PosVel.y + (SatelliteParam->PosVel.vy + SatelliteParam->Acc[1] * TimeDiff * 0.5) * TimeDiff;
-		pPosVel->z = SatelliteParam->PosVel.z + (SatelliteParam->PosVel.vz + SatelliteParam->Acc[2] * TimeDiff * 0.5) * TimeDiff;
-		pPosVel->vx = SatelliteParam->PosVel.vx + SatelliteParam->Acc[0] * TimeDiff;
-		pPosVel->vy = SatelliteParam->PosVel.vy + SatelliteParam->Acc[1] * TimeDiff;
-		pPosVel->vz = SatelliteParam->PosVel.vz + SatelliteParam->Acc[2] * TimeDiff;
-	}
-	else	// new calculation
-	{
-		TimeTag = (int)(SatelliteTime + 0.5);
-		GpsSatPosSpeedEph(system, (double)TimeTag, Eph, &(SatelliteParam->PosVel), (SatelliteParam->Acc));
-		SatelliteParam->PosTimeTag = TimeTag;
-		TimeDiff = SatelliteTime - TimeTag;
-		if (TimeDiff != 0.0)
-		{
-			pPosVel->x = SatelliteParam->PosVel.x + (SatelliteParam->PosVel.vx + SatelliteParam->Acc[0] * TimeDiff * 0.5) * TimeDiff;
-			pPosVel->y = SatelliteParam->PosVel.y + (SatelliteParam->PosVel.vy + SatelliteParam->Acc[1] * TimeDiff * 0.5) * TimeDiff;
-			pPosVel->z = SatelliteParam->PosVel.z + (SatelliteParam->PosVel.vz + SatelliteParam->Acc[2] * TimeDiff * 0.5) * TimeDiff;
-			pPosVel->vx = SatelliteParam->PosVel.vx + SatelliteParam->Acc[0] * TimeDiff;
-			pPosVel->vy = SatelliteParam->PosVel.vy + SatelliteParam->Acc[1] * TimeDiff;
-			pPosVel->vz = SatelliteParam->PosVel.vz + SatelliteParam->Acc[2] * TimeDiff;
-		}
-		else
-			*pPosVel = SatelliteParam->PosVel;
+	case GpsSystem: return (OutputParam.GpsMaskOut & (1 << Index)) ? TRUE : FALSE;
+	case BdsSystem: return (OutputParam.BdsMaskOut & (1LL << Index)) ? TRUE : FALSE;
+	case GalileoSystem: return (OutputParam.GalileoMaskOut & (1LL << Index)) ? TRUE : FALSE;
+	case GlonassSystem: return (OutputParam.GlonassMaskOut & (1 << Index)) ? TRUE : FALSE;
+	default: return TRUE;
 	}
 }
+
+// elevation rate in rad/s from relative velocity projected to local up direction, change of up direction ignored
+double ElevationRate(PKINEMATIC_INFO Receiver, PLLA_POSITION ReceiverLla, PKINEMATIC_INFO Satellite, double Elevation)
+{
+	CONVERT_MATRIX ConvertMatrix = CalcConvMatrix(*ReceiverLla);
+	double LosVector[3], Velocity[3], Distance, LosSpeed, UpSpeed;
+
+	Distance = GeometryDistance(Receiver, Satellite, LosVector);
+	Velocity[0] = Satellite->vx - Receiver->vx;
+	Velocity[1] = Satellite->vy - Receiver->vy;
+	Velocity[2] = Satellite->vz - Receiver->vz;
+	LosSpeed = Velocity[0] * LosVector[0] + Velocity[1] * LosVector[1] + Velocity[2] * LosVector[2];
+	// derivative of sin(Elevation) is up component of (Velocity - LosVector * LosSpeed) / Distance
+	UpSpeed = (Velocity[0] - LosVector[0] * LosSpeed) * ConvertMatrix.x2u + (Velocity[1] - LosVector[1] * LosSpeed) * ConvertMatrix.y2u + (Velocity[2] - LosVector[2] * LosSpeed) * ConvertMatrix.z2u;
+	return UpSpeed / Distance / cos(Elevation);
+}
@@ -44,6 +44,7 @@ const SignalAttribute CSatelliteSignal::SignalAttributes[32] = {
 CSatelliteSignal::CSatelliteSignal()
 {
 	CurrentFrame = Svid = -1;
+	FrameWeek = -1;
 	NavData = (NavBit *)0;
 }
 
@@ -59,7 +60,9 @@ BOOL CSatelliteSignal::SetSignalAttribute(GnssSystem System, int SignalIndex, Na
 	NavData = pNavData;
 	Svid = svid;
 	CurrentFrame = -1;	// reset current frame to force fill DataBits[] on next call to GetSatelliteSignal()
+	FrameWeek = -1;
 	memset(DataBits, 0, sizeof(DataBits));
+	SetSymbolConstants();
 
 	// signal and navigation bit match
 	switch (SatSystem)
@@ -137,78 +140,45 @@ BOOL CSatelliteSignal::SetSignalAttribute(GnssSystem System, int SignalIndex, Na
 #define AMPLITUDE_3_4 0.8660254037844386468
 #define AMPLITUDE_5_11 0.6741998624632421
 
-BOOL CSatelliteSignal::GetSatelliteSignal(GNSS_TIME TransmitTime, complex_number &DataSignal, complex_number &PilotSignal)
+// data/pilot value of positive and negative symbol, zero amplitude gives zero for both
+static void SetSymbolValue(complex_number Value[2], double Amplitude, BOOL Quadrature)
 {
-	int Milliseconds;
-	int BitLength = (Attribute->CodeLength * Attribute->NHLength);
-	int FrameNumber, BitNumber, BitPos, SecondaryPosition;
-	int DataBit, PilotBit = 0;
-	int SecondaryLength;
-	const unsigned int *SecondaryCode = GetPilotBits(SatSystem, SatSignal, Svid, SecondaryLength);
-	int Seconds, LeapSecond;
-	int GalileoE1Signal = (SatSystem == GalileoSystem && SatSignal == SIGNAL_INDEX_E1) ? 1 : 0;
-	int Param = ((SatSystem == GpsSystem && SatSignal == SIGNAL_INDEX_L5) ? 1 : 0) || GalileoE1Signal;	// set to 1 for E1 or L5
-
-	if (Svid < 0)	// attribute not yet set
-		return FALSE;
-	if (SatSystem == BdsSystem)	// subtract leap second difference
-		TransmitTime.MilliSeconds -= 14000;
-	else if (SatSystem == GlonassSystem)	// subtract leap second, add 3 hours
-	{
-		Seconds = (unsigned int)(TransmitTime.Week * 604800 + TransmitTime.MilliSeconds / 1000);
-		GetLeapSecond(Seconds, LeapSecond);
-		TransmitTime.MilliSeconds = (TransmitTime.MilliSeconds + 10800000 - LeapSecond * 1000) % 86400000;
-	}
-	if (TransmitTime.MilliSeconds < 0)	// protection on negative millisecond
-		TransmitTime.MilliSeconds += 604800000;
-
-	Milliseconds = TransmitTime.MilliSeconds + (GalileoE1Signal ? 1000 : 0);	// E1 page has 1000ms bias to week boundary
-	FrameNumber = Milliseconds / Attribute->FrameLength;	// subframe/page number
-	Milliseconds %= Attribute->FrameLength;
-	BitNumber = Milliseconds / BitLength;	// current bit position within current subframe/page
-	Milliseconds %= BitLength;
-	BitPos = Milliseconds / Attribute->CodeLength;	// coded round in data bit
+	Value[0] = Quadrature ? complex_number(0, Amplitude) : complex_number(Amplitude, 0);
+	Value[1] = (Amplitude == 0.0) ? Value[0] : Quadrature ? complex_number(0, -Amplitude) : complex_number(-Amplitude, 0);
+}
 
-	if (FrameNumber != CurrentFrame)
-	{
-		if (NavData)
-			NavData->GetFrameData(TransmitTime, Svid, Param, DataBits);
-		CurrentFrame = FrameNumber;
-	}
+// resolve secondary code and the relative amplitude and phase of data and pilot channel
+// if the signal has only data channel, assume the data channel has 0 phase
+// if the signal has both data channel and pilot channel, the pilot channel has 0 phase
+// the overall data+pilot power is 1 (except for the case that need to deduct BOC(6,1) element)
+void CSatelliteSignal::SetSymbolConstants()
+{
+	double DataAmplitude = 0.0, PilotAmplitude = 0.0;
+	BOOL DataQuadrature = FALSE;
 
-	DataBit = (DataBits[BitNumber] ? -1 : 1) * ((Attribute->NHCode & (1 << BitPos)) ? -1 : 1);
-	if (SecondaryCode)
-	{
-		SecondaryPosition = (TransmitTime.MilliSeconds / Attribute->CodeLength) % SecondaryLength;	// position in secondary code
-		PilotBit = (SecondaryCode[SecondaryPosition / 32] & (1 << (SecondaryPosition & 0x1f))) ? -1 : 1;
-	}
+	SecondaryCode = GetPilotBits(SatSystem, SatSignal, Svid, SecondaryLength);
+	FrameBias = (SatSystem == GalileoSystem && SatSignal == SIGNAL_INDEX_E1) ? 1000 : 0;	// E1 page has 1000ms bias to week boundary
+	NavParam = ((SatSystem == GpsSystem && SatSignal == SIGNAL_INDEX_L5) || FrameBias) ? 1 : 0;	// set to 1 for E1 or L5
 
-	// generate DataSignal and PilotSignal
-	// the signal of data and pilot complex value will reflect their relative amplitude and phase
-	// if the signal has only data channel, assume the data channel has 0 phase
-	// if the signal has both data channel and pilot channel, the pilot channel has 0 phase
-	// the overall data+pilot power is 1 (except for the case that need to deduct BOC(6,1) element)
-	// signal and navigation bit match
 	switch (SatSystem)
 	{
 	case GpsSystem:
 		switch (SatSignal)
 		{
 		case SIGNAL_INDEX_L1CA:
-			DataSignal = complex_number((double)DataBit, 0);
-			PilotSignal = complex_number(0, 0);
+			DataAmplitude = 1.0;
 			break;
 		case SIGNAL_INDEX_L1C:
-			DataSignal = complex_number(DataBit * AMPLITUDE_1_4, 0);
-			PilotSignal = complex_number(PilotBit * AMPLITUDE_29_44, 0);
+			DataAmplitude = AMPLITUDE_1_4;
+			PilotAmplitude = AMPLITUDE_29_44;
 			break;
-		case SIGNAL_INDEX_L2C:
-			DataSignal = complex_number(DataBit * AMPLITUDE_1_2, 0);
-			PilotSignal = complex_number(AMPLITUDE_1_2, 0);
+		case SIGNAL_INDEX_L2C:	// CL has no secondary code so pilot symbol is always positive
+			DataAmplitude = AMPLITUDE_1_2;
+			PilotAmplitude = AMPLITUDE_1_2;
 			break;
 		case SIGNAL_INDEX_L5:
-			DataSignal = complex_number(0, DataBit * AMPLITUDE_1_2);
-			PilotSignal = complex_number(PilotBit * AMPLITUDE_1_2, 0);
+			DataAmplitude = AMPLITUDE_1_2; DataQuadrature = TRUE;
+			PilotAmplitude = AMPLITUDE_1_2;
 			break;
 		}
 		break;
@@ -216,22 +186,20 @@ BOOL CSatelliteSignal::GetSatelliteSignal(GNSS_TIME TransmitTime, complex_number
 		switch (SatSignal)
 		{
 		case SIGNAL_INDEX_B1C: 
-			DataSignal = complex_number(0, -DataBit * AMPLITUDE_1_4);
-			PilotSignal = complex_number(PilotBit * AMPLITUDE_29_44, 0);
+			DataAmplitude = -AMPLITUDE_1_4; DataQuadrature = TRUE;
+			PilotAmplitude = AMPLITUDE_29_44;
 			break;
 		case SIGNAL_INDEX_B1I:
 		case SIGNAL_INDEX_B2I:
 		case SIGNAL_INDEX_B3I:
-			DataSignal = complex_number((double)DataBit, 0);
-			PilotSignal = complex_number(0, 0);
+			DataAmplitude = 1.0;
 			break;
 		case SIGNAL_INDEX_B2a:
-			DataSignal = complex_number(0, -DataBit * AMPLITUDE_1_2);
-			PilotSignal = complex_number(PilotBit * AMPLITUDE_1_2, 0);
+			DataAmplitude = -AMPLITUDE_1_2; DataQuadrature = TRUE;
+			PilotAmplitude = AMPLITUDE_1_2;
 			break;
-		case SIGNAL_INDEX_B2b:
-			DataSignal = complex_number(0, -DataBit * AMPLITUDE_1_2);	// B2b nominal power is 3dB lower than B2a, phase align with B2a data
-			PilotSignal = complex_number(0, 0);
+		case SIGNAL_INDEX_B2b:	// B2b nominal power is 3dB lower than B2a, phase align with B2a data
+			DataAmplitude = -AMPLITUDE_1_2; DataQuadrature = TRUE;
 			break;
 		}
 		break;
@@ -239,31 +207,104 @@ BOOL CSatelliteSignal::GetSatelliteSignal(GNSS_TIME TransmitTime, complex_number
 		switch (SatSignal)
 		{
 		case SIGNAL_INDEX_E1 :
-			DataSignal = complex_number(-DataBit * AMPLITUDE_1_2, 0);
-			PilotSignal = complex_number(PilotBit * AMPLITUDE_1_2, 0);
+			DataAmplitude = -AMPLITUDE_1_2;
+			PilotAmplitude = AMPLITUDE_1_2;
 			break;
 		case SIGNAL_INDEX_E5a:
 		case SIGNAL_INDEX_E5b:
-			DataSignal = complex_number(0, -DataBit * AMPLITUDE_1_2);
-			PilotSignal = complex_number(PilotBit * AMPLITUDE_1_2, 0);
+			DataAmplitude = -AMPLITUDE_1_2; DataQuadrature = TRUE;
+			PilotAmplitude = AMPLITUDE_1_2;
 			break;
 		case SIGNAL_INDEX_E6 :
-			DataSignal = complex_number(0, 0);
-			PilotSignal = complex_number(PilotBit * AMPLITUDE_1_2, 0);
+			PilotAmplitude = AMPLITUDE_1_2;
 			break;
 		}
 		break;
 	case GlonassSystem:
-		switch (SatSignal)
+		DataAmplitude = 1.0;
+		break;
+	}
+	SetSymbolValue(DataValue, DataAmplitude, DataQuadrature);
+	SetSymbolValue(PilotValue, PilotAmplitude, FALSE);
+}
+
+// fill symbol of each code period within the frame starting at FrameStart millisecond (converted transmit time)
+void CSatelliteSignal::FillSymbolStream(GNSS_TIME TransmitTime, int FrameStart)
+{
+	int i, PeriodNumber = Attribute->FrameLength / Attribute->CodeLength;
+	int PeriodTime, SecondaryPosition, BitIndex;
+	GNSS_TIME NextFrame;
+
+	if (NavData)
+	{
+		// start of next frame to be encoded in advance, GLONASS time wraps at day boundary
+		NextFrame.Week = TransmitTime.Week;
+		NextFrame.MilliSeconds = FrameStart + Attribute->FrameLength;
+		NextFrame.SubMilliSeconds = 0.0;
+		if (SatSystem == GlonassSystem && NextFrame.MilliSeconds >= 86400000)
+			NextFrame.MilliSeconds -= 86400000;
+		else if (NextFrame.MilliSeconds >= 604800000)
 		{
-		case SIGNAL_INDEX_G1 :
-		case SIGNAL_INDEX_G2 :
-			DataSignal = complex_number((double)DataBit, 0);
-			PilotSignal = complex_number(0, 0);
-			break;
+			NextFrame.Week ++;
+			NextFrame.MilliSeconds -= 604800000;
 		}
-		break;
+		NavData->GetFrameBits(TransmitTime, FrameStart, NextFrame, Svid, NavParam, PeriodNumber / Attribute->NHLength, DataBits);
+	}
+	for (i = 0; i < PeriodNumber; i ++)
+	{
+		BitIndex = i / Attribute->NHLength;
+		SymbolStream[i] = ((DataBits[BitIndex >> 6] >> (BitIndex & 63)) & 1) ^ ((Attribute->NHCode >> (i % Attribute->NHLength)) & 1);
+		if (SecondaryCode)
+		{
+			PeriodTime = FrameStart + i * Attribute->CodeLength;
+			if (PeriodTime < 0)	// E1 page before week boundary, secondary code period is divisor of week
+				PeriodTime += 604800000;
+			SecondaryPosition = (PeriodTime / Attribute->CodeLength) % SecondaryLength;	// position in secondary code
+			SymbolStream[i] |= ((SecondaryCode[SecondaryPosition / 32] >> (SecondaryPosition & 0x1f)) & 1) << 1;
+		}
+	}
+}
+
+// symbol of current frame is looked up directly while TransmitTime stays within the frame,
+// conversion to system time and frame filling only happens on frame change
+BOOL CSatelliteSignal::GetSatelliteSignal(GNSS_TIME TransmitTime, complex_number &DataSignal, complex_number &PilotSignal)
+{
+	int Milliseconds, FrameNumber;
+	int Seconds, LeapSecond;
+	int Symbol, Week = TransmitTime.Week, RawMilliseconds = TransmitTime.MilliSeconds;
+
+	if (Svid < 0)	// attribute not yet set
+		return FALSE;
+
+	Milliseconds = RawMilliseconds - FrameStartTime;
+	if (Week != FrameWeek || Milliseconds < 0 || Milliseconds >= Attribute->FrameLength)
+	{
+		if (SatSystem == BdsSystem)	// subtract leap second difference
+			TransmitTime.MilliSeconds -= 14000;
+		else if (SatSystem == GlonassSystem)	// subtract leap second, add 3 hours
+		{
+			Seconds = (unsigned int)(TransmitTime.Week * 604800 + TransmitTime.MilliSeconds / 1000);
+			GetLeapSecond(Seconds, LeapSecond);
+			TransmitTime.MilliSeconds = (TransmitTime.MilliSeconds + 10800000 - LeapSecond * 1000) % 86400000;
+		}
+		if (TransmitTime.MilliSeconds < 0)	// protection on negative millisecond
+			TransmitTime.MilliSeconds += 604800000;
+
+		Milliseconds = TransmitTime.MilliSeconds + FrameBias;
+		FrameNumber = Milliseconds / Attribute->FrameLength;	// subframe/page number
+		Milliseconds %= Attribute->FrameLength;
+		if (FrameNumber != CurrentFrame)
+		{
+			FillSymbolStream(TransmitTime, TransmitTime.MilliSeconds - Milliseconds);
+			CurrentFrame = FrameNumber;
+		}
+		FrameWeek = Week;
+		FrameStartTime = RawMilliseconds - Milliseconds;
 	}
 
+	Symbol = SymbolStream[Milliseconds / Attribute->CodeLength];
+	DataSignal = DataValue[Symbol & 1];
+	PilotSignal = PilotValue[Symbol >> 1];
+
 	return TRUE;
 }
@@ -268,6 +268,12 @@ BOOL SetOutputParam(CXmlElement *Element, OUTPUT_PARAM &OutputParam)
 	// default output GPS L1 only
 	OutputParam.FreqSelect[0] = 0x1;
 	OutputParam.FreqSelect[1] = OutputParam.FreqSelect[2] = OutputParam.FreqSelect[3] = 0;
+	OutputParam.SampleType = SampleTypeDouble;
+	OutputParam.NoiseSeed = 0;
+	OutputParam.NoiseBufferSize = 0;
+	OutputParam.BlockLength = 1;
+	OutputParam.Interpolation = InterpolationLinear;
+	OutputParam.OrbitInterpWindow = 60;
 
 	for (i = 0; i < Attributes->DictItemNumber; i ++)
 	{